@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    include "i2c_master.h"
 #endif
 #include "oled_driver.h"
+#include "oled_rotate.h"
 #include OLED_FONT_H
 #include "timer.h"
 #include "print.h"
@@ -163,6 +164,23 @@ uint32_t oled_scroll_timeout;
 uint16_t oled_update_timeout;
 #endif
 
+#if OLED_SHADOW_BUFFER
+// Copy of what the controller's memory holds, laid out the same way as oled_buffer without rotation
+static uint8_t oled_shadow[OLED_MATRIX_SIZE];
+
+// Blocks whose part of the controller's memory is unknown, so the shadow can't be compared against
+static OLED_BLOCK_TYPE oled_shadow_stale = OLED_ALL_BLOCKS_MASK;
+
+// Changed bytes are gathered into alternating buffers, so one can be prepared while the other is still sending
+static uint8_t oled_send_buffer[2][OLED_BLOCK_SIZE];
+static uint8_t oled_send_buffer_index = 0;
+#endif
+
+#if defined(OLED_TRANSPORT_SPI)
+// Set when oled_send_data_async() left the display selected, so oled_render() can release it once the transfer is done
+static bool oled_spi_stop_pending = false;
+#endif
+
 #if defined(OLED_TRANSPORT_SPI)
 #    ifndef OLED_DC_PIN
 #        error "The OLED driver in SPI needs a D/C pin defined"
@@ -255,6 +273,26 @@ __attribute__((weak)) bool oled_send_data(const uint8_t *data, uint16_t size) {
 #endif
 }
 
+__attribute__((weak)) bool oled_send_data_async(const uint8_t *data, uint16_t size) {
+#if defined(OLED_TRANSPORT_SPI)
+    if (!spi_start(OLED_CS_PIN, false, OLED_SPI_MODE, OLED_SPI_DIVISOR)) {
+        return false;
+    }
+    // Data Mode
+    writePinHigh(OLED_DC_PIN);
+    // Let the transfer finish in the background; the next spi_start() or oled_render() waits for it
+    if (spi_transmit_async(data, size) != SPI_STATUS_SUCCESS) {
+        spi_stop();
+        return false;
+    }
+    spi_stop_async();
+    oled_spi_stop_pending = true;
+    return true;
+#else
+    return oled_send_data(data, size);
+#endif
+}
+
 __attribute__((weak)) void oled_driver_init(void) {
 #if defined(OLED_TRANSPORT_SPI)
     spi_init();
@@ -364,6 +402,9 @@ bool oled_init(oled_rotation_t rotation) {
     oled_scroll_timeout = timer_read32() + OLED_SCROLL_TIMEOUT;
 #endif
 
+#if OLED_SHADOW_BUFFER
+    oled_shadow_stale = OLED_ALL_BLOCKS_MASK;
+#endif
     oled_clear();
     oled_initialized = true;
     oled_active      = true;
@@ -384,26 +425,24 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
-    // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
-#if !OLED_IC_HAS_HORIZONTAL_MODE
-    // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
-    // Column value must be split into high and low nybble and sent as two commands.
-    cmd_array[0] = PAM_PAGE_ADDR | start_page;
-    cmd_array[1] = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
-    cmd_array[2] = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
-#else
-    // Commands for use in Horizontal Addressing mode.
-    cmd_array[1] = start_column + OLED_COLUMN_OFFSET;
-    cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1 + cmd_array[4];
-#endif
+// Area of the controller's memory covered by a block
+typedef struct {
+    uint8_t page;
+    uint8_t column;
+    uint8_t num_pages;
+    uint8_t num_columns;
+} oled_window_t;
+
+static oled_window_t calc_bounds(uint8_t update_start) {
+    oled_window_t window;
+    window.page        = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
+    window.column      = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    window.num_columns = (OLED_BLOCK_SIZE < OLED_DISPLAY_WIDTH) ? OLED_BLOCK_SIZE : OLED_DISPLAY_WIDTH;
+    window.num_pages   = OLED_BLOCK_SIZE / window.num_columns;
+    return window;
 }
 
-static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
+static oled_window_t calc_bounds_90(uint8_t update_start) {
     // Block numbering starts from the bottom left corner, going up and then to
     // the right.  The controller needs the page and column numbers for the top
     // left and bottom right corners of that block.
@@ -418,116 +457,173 @@ static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
     // Top page number for a block which is at the bottom edge of the screen.
     const uint8_t bottom_block_top_page = (height_in_pages - page_inc_per_block) % height_in_pages;
 
+    oled_window_t window;
+    window.page        = bottom_block_top_page - (OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT / 8);
+    window.column      = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
+    window.num_columns = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8;
+    window.num_pages   = OLED_BLOCK_SIZE / window.num_columns;
+    return window;
+}
+
+static bool oled_send_window(uint8_t page, uint8_t column, uint8_t num_pages, uint8_t num_columns) {
 #if !OLED_IC_HAS_HORIZONTAL_MODE
-    // Only the Page Addressing Mode is supported
-    uint8_t start_page   = bottom_block_top_page - (OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT / 8);
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
-    cmd_array[0]         = PAM_PAGE_ADDR | start_page;
-    cmd_array[1]         = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
-    cmd_array[2]         = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
+    // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
+    // Column value must be split into high and low nybble and sent as two commands.
+    uint8_t display_start[] = {I2C_CMD, PAM_PAGE_ADDR | page, PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + column) & 0x0f), PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + column) >> 4 & 0x0f)};
 #else
-    cmd_array[1] = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8 + OLED_COLUMN_OFFSET;
-    cmd_array[4] = bottom_block_top_page - (OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT / 8);
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8 + cmd_array[4];
+    // Commands for use in Horizontal Addressing mode.
+    uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, OLED_COLUMN_OFFSET + column, OLED_COLUMN_OFFSET + column + num_columns - 1, PAGE_ADDR, page, page + num_pages - 1};
 #endif
+    return oled_send_cmd(display_start, ARRAY_SIZE(display_start));
 }
 
-uint8_t crot(uint8_t a, int8_t n) {
-    const uint8_t mask = 0x7;
-    n &= mask;
-    return a << n | a >> (-n & mask);
+// Sends a window's worth of data, laid out as num_pages runs of num_columns bytes
+static bool oled_send_block(const oled_window_t *window, const uint8_t *data, bool async) {
+#if OLED_IC_HAS_HORIZONTAL_MODE
+    const uint8_t  num_sends = 1;
+    const uint16_t send_size = window->num_pages * window->num_columns;
+#else
+    // For SH1106 or SH1107 the data must be split into separate pieces for each page
+    const uint8_t  num_sends = window->num_pages;
+    const uint16_t send_size = window->num_columns;
+#endif
+    for (uint8_t i = 0; i < num_sends; ++i) {
+        // Send column & page position
+        if (!oled_send_window(window->page + i, window->column, window->num_pages - i, window->num_columns)) {
+            print("oled_render offset command failed\n");
+            return false;
+        }
+        // Send render data chunk
+        if (!(async ? oled_send_data_async(&data[send_size * i], send_size) : oled_send_data(&data[send_size * i], send_size))) {
+            print("oled_render data failed\n");
+            return false;
+        }
+    }
+    return true;
 }
 
-static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
+#if OLED_SHADOW_BUFFER
+// Shrinks the window to the pages and columns holding bytes which differ from the shadow, then gathers those
+// bytes for sending and records them in the shadow. Returns false if the controller already holds the block.
+static bool oled_shadow_diff(oled_window_t *window, const uint8_t **data, uint8_t update_start) {
+    const bool stale        = oled_shadow_stale & ((OLED_BLOCK_TYPE)1 << update_start);
+    uint8_t    first_page   = window->num_pages;
+    uint8_t    last_page    = 0;
+    uint8_t    first_column = window->num_columns;
+    uint8_t    end_column   = 0;
+
+    for (uint8_t page = 0; page < window->num_pages; ++page) {
+        const uint8_t *source = &(*data)[window->num_columns * page];
+        const uint8_t *shadow = &oled_shadow[OLED_DISPLAY_WIDTH * (window->page + page) + window->column];
+        uint8_t        first  = 0;
+        uint8_t        end    = window->num_columns;
+        if (!stale) {
+            while (first < end && source[first] == shadow[first]) {
+                ++first;
+            }
+            while (end > first && source[end - 1] == shadow[end - 1]) {
+                --end;
+            }
+            if (first == end) {
+                continue;
+            }
+        }
+        if (first_page == window->num_pages) {
+            first_page = page;
         }
+        last_page    = page;
+        first_column = (first < first_column) ? first : first_column;
+        end_column   = (end > end_column) ? end : end_column;
+    }
+
+    if (first_page == window->num_pages) {
+        return false;
+    }
+
+    uint8_t *     target      = oled_send_buffer[oled_send_buffer_index];
+    const uint8_t num_columns = end_column - first_column;
+    for (uint8_t page = first_page; page <= last_page; ++page) {
+        const uint8_t *source = &(*data)[window->num_columns * page + first_column];
+        memcpy(&target[num_columns * (page - first_page)], source, num_columns);
+        memcpy(&oled_shadow[OLED_DISPLAY_WIDTH * (window->page + page) + window->column + first_column], source, num_columns);
     }
+    oled_send_buffer_index ^= 1;
+    oled_shadow_stale &= ~((OLED_BLOCK_TYPE)1 << update_start);
+
+    window->page += first_page;
+    window->column += first_column;
+    window->num_pages   = last_page - first_page + 1;
+    window->num_columns = num_columns;
+    *data               = target;
+    return true;
 }
+#endif // OLED_SHADOW_BUFFER
 
 void oled_render(void) {
+#if defined(OLED_TRANSPORT_SPI)
+    // The last asynchronous send has had a whole loop to finish, end its transaction even if there's nothing to draw
+    if (oled_spi_stop_pending) {
+        oled_spi_stop_pending = false;
+        spi_stop();
+    }
+#endif
+
     // Do we have work to do?
     oled_dirty &= OLED_ALL_BLOCKS_MASK;
     if (!oled_dirty || !oled_initialized || oled_scrolling) {
         return;
     }
 
-    // Turn on display if it is off
-    oled_on();
-
     uint8_t update_start  = 0;
     uint8_t num_processed = 0;
-    while (oled_dirty && num_processed++ < OLED_UPDATE_PROCESS_LIMIT) { // render all dirty blocks (up to the configured limit)
+    while (oled_dirty && num_processed < OLED_UPDATE_PROCESS_LIMIT) { // render all dirty blocks (up to the configured limit)
         // Find next dirty block
         while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
             ++update_start;
         }
 
-        // Set column & page position
-#if OLED_IC_HAS_HORIZONTAL_MODE
-        static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
-#else
-        static uint8_t display_start[] = {I2C_CMD, PAM_PAGE_ADDR, PAM_SETCOLUMN_LSB, PAM_SETCOLUMN_MSB};
-#endif
-        if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-            calc_bounds(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
-        } else {
-            calc_bounds_90(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
-        }
-
-        // Send column & page position
-        if (!oled_send_cmd(display_start, ARRAY_SIZE(display_start))) {
-            print("oled_render offset command failed\n");
-            return;
-        }
-
+        oled_window_t  window;
+        const uint8_t *data;
         if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
             // Send render data chunk as is
-            if (!oled_send_data(&oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE)) {
-                print("oled_render data failed\n");
-                return;
-            }
+            window = calc_bounds(update_start);
+            data   = &oled_buffer[OLED_BLOCK_SIZE * update_start];
         } else {
             // Rotate the render chunks
             const static uint8_t source_map[] = OLED_SOURCE_MAP;
             const static uint8_t target_map[] = OLED_TARGET_MAP;
 
+            // Every 8x8 tile of the block is written, so the buffer needs no clearing first
             static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-            memset(temp_buffer, 0, sizeof(temp_buffer));
             for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-                rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+                oled_rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
             }
+            window = calc_bounds_90(update_start);
+            data   = temp_buffer;
+        }
 
-#if OLED_IC_HAS_HORIZONTAL_MODE
-            // Send render data chunk after rotating
-            if (!oled_send_data(&temp_buffer[0], OLED_BLOCK_SIZE)) {
-                print("oled_render90 data failed\n");
+#if OLED_SHADOW_BUFFER
+        // Rewrites of identical data cost nothing, and partial changes only send the bytes that changed
+        if (oled_shadow_diff(&window, &data, update_start)) {
+            // Turn on display if it is off
+            oled_on();
+
+            // The gathered data is left alone until the next send, so it can transfer in the background
+            if (!oled_send_block(&window, data, true)) {
+                oled_shadow_stale |= ((OLED_BLOCK_TYPE)1 << update_start);
                 return;
             }
+            ++num_processed;
+        }
 #else
-            // For SH1106 or SH1107 the data chunk must be split into separate pieces for each page
-            const uint8_t columns_in_block = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8;
-            const uint8_t num_pages        = OLED_BLOCK_SIZE / columns_in_block;
-            for (uint8_t i = 0; i < num_pages; ++i) {
-                // Send column & page position for all pages except the first one
-                if (i > 0) {
-                    display_start[1]++;
-                    if (!oled_send_cmd(display_start, ARRAY_SIZE(display_start))) {
-                        print("oled_render offset command failed\n");
-                        return;
-                    }
-                }
-                // Send data for the page
-                if (!oled_send_data(&temp_buffer[columns_in_block * i], columns_in_block)) {
-                    print("oled_render90 data failed\n");
-                    return;
-                }
-            }
-#endif
+        // Turn on display if it is off
+        oled_on();
+
+        if (!oled_send_block(&window, data, false)) {
+            return;
         }
+        ++num_processed;
+#endif
 
         // Clear dirty flag of just rendered block
         oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
@@ -880,6 +976,10 @@ bool oled_scroll_off(void) {
         }
         oled_scrolling = false;
         oled_dirty     = OLED_ALL_BLOCKS_MASK;
+#if OLED_SHADOW_BUFFER
+        // The controller's memory needs rewriting once scrolling stops
+        oled_shadow_stale = OLED_ALL_BLOCKS_MASK;
+#endif
     }
     return !oled_scrolling;
 }
@@ -321,6 +321,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_UPDATE_PROCESS_LIMIT 1
 #endif
 
+// Keep a copy of the panel's memory, so only the bytes that differ from it are sent
+#if !defined(OLED_SHADOW_BUFFER)
+#    if defined(__AVR__)
+#        define OLED_SHADOW_BUFFER 0
+#    else
+#        define OLED_SHADOW_BUFFER 1
+#    endif
+#endif
+
 typedef struct __attribute__((__packed__)) {
     uint8_t *current_element;
     uint16_t remaining_element_count;
@@ -342,6 +351,9 @@ bool oled_init(oled_rotation_t rotation);
 bool oled_send_cmd(const uint8_t *data, uint16_t size);
 bool oled_send_cmd_P(const uint8_t *data, uint16_t size);
 bool oled_send_data(const uint8_t *data, uint16_t size);
+// data must remain unmodified until the next oled_send_*() call
+// Over SPI this sends data itself rather than calling oled_send_data(), so override both or neither
+bool oled_send_data_async(const uint8_t *data, uint16_t size);
 void oled_driver_init(void);
 
 // Called at the start of oled_init, weak function overridable by the user
@@ -0,0 +1,44 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Rotates an 8x8 pixel tile by 90 degrees, as an 8x8 bit-matrix transpose with the rows reversed:
+ * bit i of src[j] becomes bit (7 - j) of dest[i]. The tile is held in two 32-bit words so the
+ * transpose takes three rounds of masked swaps, instead of visiting each of the 64 bits in turn.
+ */
+static inline void oled_rotate_90(const uint8_t *src, uint8_t *dest) {
+    uint32_t x = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+    uint32_t y = ((uint32_t)src[4] << 24) | ((uint32_t)src[5] << 16) | ((uint32_t)src[6] << 8) | src[7];
+    uint32_t t;
+
+    // Swap single bits within each 2x2 block
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    // Swap 2x2 blocks within each 4x4 block
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    // Swap the off-diagonal 4x4 blocks, which sit in different words
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    // Transposed rows come out in reverse, which is what the rotation needs
+    dest[7] = x >> 24;
+    dest[6] = x >> 16;
+    dest[5] = x >> 8;
+    dest[4] = x;
+    dest[3] = y >> 24;
+    dest[2] = y >> 16;
+    dest[1] = y >> 8;
+    dest[0] = y;
+}
@@ -5,6 +5,7 @@
 
 #    include "spi_master.h"
 #    include "qp_comms_spi.h"
+#    include "qp_draw.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Base SPI support
@@ -35,9 +36,16 @@ uint32_t qp_comms_spi_send_data(painter_device_t device, const void *data, uint3
     const uint8_t *p               = (const uint8_t *)data;
     const uint32_t max_msg_length  = 1024;
 
+    // Pixel data can carry on transmitting while the next block is prepared
+    bool async = qp_internal_pixdata_buffer_send_async(data);
+
     while (bytes_remaining > 0) {
         uint32_t bytes_this_loop = QP_MIN(bytes_remaining, max_msg_length);
-        spi_transmit(p, bytes_this_loop);
+        if (async) {
+            spi_transmit_async(p, bytes_this_loop);
+        } else {
+            spi_transmit(p, bytes_this_loop);
+        }
         p += bytes_this_loop;
         bytes_remaining -= bytes_this_loop;
     }
@@ -100,6 +108,7 @@ uint32_t qp_comms_spi_dc_reset_send_data(painter_device_t device, const void *da
 void qp_comms_spi_dc_reset_send_command(painter_device_t device, uint8_t cmd) {
     painter_driver_t *              driver       = (painter_driver_t *)device;
     qp_comms_spi_dc_reset_config_t *comms_config = (qp_comms_spi_dc_reset_config_t *)driver->comms_config;
+    spi_async_wait(); // pixel data may still be transmitting, don't switch it to a command
     writePinLow(comms_config->dc_pin);
     spi_write(cmd);
 }
@@ -9,16 +9,19 @@
 /**
  * @def This controls the maximum number of surface devices that Quantum Painter can use at any one time.
  *      Increasing this number allows for multiple framebuffers to be used. Each requires its own RAM allocation.
+ *      Superseded by SURFACE_NUM_DEVICES, which is shared between surfaces of all formats.
  */
 #    define RGB565_SURFACE_NUM_DEVICES 1
 #endif
 
+#include "qp_surface.h"
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward declarations
 
 #ifdef QUANTUM_PAINTER_RGB565_SURFACE_ENABLE
 /**
- * Factory method for an RGB565 surface (aka framebuffer).
+ * Factory method for an RGB565 surface (aka framebuffer). Equivalent to `qp_make_surface(..., 16, buffer)`.
  *
  * @param panel_width[in] the width of the display panel
  * @param panel_height[in] the height of the display panel
@@ -28,7 +31,7 @@
 painter_device_t qp_rgb565_make_surface(uint16_t panel_width, uint16_t panel_height, void *buffer);
 
 /**
- * Helper method to draw the dirty contents of the framebuffer to the target device.
+ * Helper method to draw the dirty contents of the framebuffer to the target device. Equivalent to `qp_surface_draw`.
  *
  * After successful completion, the dirty area is reset.
  *
@@ -0,0 +1,625 @@
+// Copyright 2022 Nick Brassel (@tzarc)
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "color.h"
+#include "qp_surface.h"
+#include "qp_comms.h"
+#include "qp_draw.h"
+#include "qp_internal_fill.h"
+
+#ifdef QUANTUM_PAINTER_RGB565_SURFACE_ENABLE
+#    include "qp_rgb565_surface.h"
+#endif // QUANTUM_PAINTER_RGB565_SURFACE_ENABLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Common
+
+// A region of the surface, inclusive on all sides
+typedef struct surface_dirty_region_t {
+    uint16_t l;
+    uint16_t t;
+    uint16_t r;
+    uint16_t b;
+} surface_dirty_region_t;
+
+// Device definition
+typedef struct surface_painter_device_t {
+    painter_driver_t base; // must be first, so it can be cast to/from the painter_device_t* type
+
+    // The target buffer
+    union {
+        void *    buffer;
+        uint8_t * u8buffer;
+        uint16_t *u16buffer;
+    };
+
+    // Manually manage the viewport for streaming pixel data to the display
+    uint16_t viewport_l;
+    uint16_t viewport_t;
+    uint16_t viewport_r;
+    uint16_t viewport_b;
+
+    // Current write location to the display when streaming pixel data
+    uint16_t pixdata_x;
+    uint16_t pixdata_y;
+
+    // Bounding box of the pixels changed within the current viewport, added to the dirty regions when the viewport changes
+    bool                   is_pending;
+    surface_dirty_region_t pending;
+
+    // Maintain a list of dirty regions so we can stream only what we need
+    uint8_t                num_dirty;
+    surface_dirty_region_t dirty[SURFACE_NUM_DIRTY_REGIONS];
+
+    // Vertical scrolling band, applied when the surface is drawn to a display
+    uint16_t scroll_top;
+    uint16_t scroll_bottom;
+    uint16_t scroll_offset;
+} surface_painter_device_t;
+
+// Driver storage
+surface_painter_device_t surface_drivers[SURFACE_NUM_DEVICES] = {0};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers: packed pixel access
+
+static inline uint16_t read_packed_pixel(const void *data, uint8_t bpp, uint32_t index) {
+    switch (bpp) {
+        case 16:
+            return ((const uint16_t *)data)[index];
+        case 8:
+            return ((const uint8_t *)data)[index];
+        default: {
+            // Sub-byte pixels are packed least significant bits first, matching QGF
+            uint8_t pixels_per_byte = 8 / bpp;
+            uint8_t shift           = (index % pixels_per_byte) * bpp;
+            return (((const uint8_t *)data)[index / pixels_per_byte] >> shift) & ((1 << bpp) - 1);
+        }
+    }
+}
+
+static inline void write_packed_pixel(void *data, uint8_t bpp, uint32_t index, uint16_t value) {
+    switch (bpp) {
+        case 16:
+            ((uint16_t *)data)[index] = value;
+            break;
+        case 8:
+            ((uint8_t *)data)[index] = (uint8_t)value;
+            break;
+        default: {
+            uint8_t  pixels_per_byte = 8 / bpp;
+            uint8_t  shift           = (index % pixels_per_byte) * bpp;
+            uint8_t  mask            = ((1 << bpp) - 1) << shift;
+            uint8_t *byte            = &((uint8_t *)data)[index / pixels_per_byte];
+            *byte                    = (*byte & ~mask) | ((value << shift) & mask);
+            break;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers: dirty region tracking
+
+static inline uint32_t region_area(const surface_dirty_region_t *region) {
+    return ((uint32_t)(region->r - region->l + 1)) * (region->b - region->t + 1);
+}
+
+static inline surface_dirty_region_t region_union(const surface_dirty_region_t *a, const surface_dirty_region_t *b) {
+    return (surface_dirty_region_t){.l = QP_MIN(a->l, b->l), .t = QP_MIN(a->t, b->t), .r = QP_MAX(a->r, b->r), .b = QP_MAX(a->b, b->b)};
+}
+
+// Number of pixels the union of two regions would cover which neither region covers
+static uint32_t region_merge_waste(const surface_dirty_region_t *a, const surface_dirty_region_t *b) {
+    surface_dirty_region_t merged  = region_union(a, b);
+    uint32_t               covered = region_area(a) + region_area(b);
+
+    // Don't count the overlap twice
+    uint16_t il = QP_MAX(a->l, b->l);
+    uint16_t it = QP_MAX(a->t, b->t);
+    uint16_t ir = QP_MIN(a->r, b->r);
+    uint16_t ib = QP_MIN(a->b, b->b);
+    if (il <= ir && it <= ib) {
+        covered -= ((uint32_t)(ir - il + 1)) * (ib - it + 1);
+    }
+
+    return region_area(&merged) - covered;
+}
+
+static void surface_remove_dirty_region(surface_painter_device_t *surface, uint8_t index) {
+    surface->dirty[index] = surface->dirty[--surface->num_dirty];
+}
+
+static void surface_add_dirty_region(surface_painter_device_t *surface, surface_dirty_region_t region) {
+    // Fold in any existing regions that are cheap to combine; each merge can make further merges worthwhile
+    bool merged;
+    do {
+        merged = false;
+        for (uint8_t i = 0; i < surface->num_dirty; ++i) {
+            if (region_merge_waste(&region, &surface->dirty[i]) <= (SURFACE_DIRTY_MERGE_PIXELS)) {
+                region = region_union(&region, &surface->dirty[i]);
+                surface_remove_dirty_region(surface, i);
+                merged = true;
+                break;
+            }
+        }
+    } while (merged);
+
+    if (surface->num_dirty < (SURFACE_NUM_DIRTY_REGIONS)) {
+        surface->dirty[surface->num_dirty++] = region;
+        return;
+    }
+
+    // Out of regions, merge with whichever one grows the least
+    uint8_t  best       = 0;
+    uint32_t best_waste = UINT32_MAX;
+    for (uint8_t i = 0; i < surface->num_dirty; ++i) {
+        uint32_t waste = region_merge_waste(&region, &surface->dirty[i]);
+        if (waste < best_waste) {
+            best       = i;
+            best_waste = waste;
+        }
+    }
+    region = region_union(&region, &surface->dirty[best]);
+    surface_remove_dirty_region(surface, best);
+    surface_add_dirty_region(surface, region);
+}
+
+static void surface_commit_pending(surface_painter_device_t *surface) {
+    if (surface->is_pending) {
+        surface_add_dirty_region(surface, surface->pending);
+        surface->is_pending = false;
+    }
+}
+
+static void surface_mark_all_dirty(surface_painter_device_t *surface) {
+    surface->is_pending = false;
+    surface->num_dirty  = 1;
+    surface->dirty[0]   = (surface_dirty_region_t){.l = 0, .t = 0, .r = surface->base.panel_width - 1, .b = surface->base.panel_height - 1};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers: scrolling
+
+// Row on the display that a row of the surface is shown at, taking the scrolling band into account
+static inline uint16_t surface_display_row(surface_painter_device_t *surface, uint16_t py) {
+    if (surface->scroll_offset == 0 || py < surface->scroll_top || py > surface->scroll_bottom) {
+        return py;
+    }
+    uint16_t height = surface->scroll_bottom - surface->scroll_top + 1;
+    return surface->scroll_top + (py - surface->scroll_top + height - surface->scroll_offset) % height;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers: pixel streaming
+
+static inline void increment_pixdata_location(surface_painter_device_t *surface) {
+    // Increment the X-position
+    surface->pixdata_x++;
+
+    // If the x-coord has gone past the right-side edge, loop it back around and increment the y-coord
+    if (surface->pixdata_x > surface->viewport_r) {
+        surface->pixdata_x = surface->viewport_l;
+        surface->pixdata_y++;
+    }
+
+    // If the y-coord has gone past the bottom, loop it back to the top
+    if (surface->pixdata_y > surface->viewport_b) {
+        surface->pixdata_y = surface->viewport_t;
+    }
+}
+
+static inline void setpixel(surface_painter_device_t *surface, uint16_t x, uint16_t y, uint16_t value) {
+    uint8_t  bpp   = surface->base.native_bits_per_pixel;
+    uint32_t index = ((uint32_t)y) * surface->base.panel_width + x;
+
+    // Skip messing with the dirty info if the original value already matches
+    if (read_packed_pixel(surface->buffer, bpp, index) != value) {
+        // Maintain the pending dirty region
+        if (!surface->is_pending) {
+            surface->is_pending = true;
+            surface->pending    = (surface_dirty_region_t){.l = x, .t = y, .r = x, .b = y};
+        } else {
+            if (surface->pending.l > x) {
+                surface->pending.l = x;
+            }
+            if (surface->pending.r < x) {
+                surface->pending.r = x;
+            }
+            if (surface->pending.t > y) {
+                surface->pending.t = y;
+            }
+            if (surface->pending.b < y) {
+                surface->pending.b = y;
+            }
+        }
+
+        // Update the pixel data in the buffer
+        write_packed_pixel(surface->buffer, bpp, index, value);
+    }
+}
+
+static inline void stream_pixdata(surface_painter_device_t *surface, const void *data, uint32_t native_pixel_count) {
+    uint8_t bpp = surface->base.native_bits_per_pixel;
+    for (uint32_t pixel_counter = 0; pixel_counter < native_pixel_count; ++pixel_counter) {
+        setpixel(surface, surface->pixdata_x, surface->pixdata_y, read_packed_pixel(data, bpp, pixel_counter));
+        increment_pixdata_location(surface);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Driver vtable
+
+static bool qp_surface_init(painter_device_t device, painter_rotation_t rotation) {
+    painter_driver_t *        driver  = (painter_driver_t *)device;
+    surface_painter_device_t *surface = (surface_painter_device_t *)driver;
+    memset(surface->buffer, 0, SURFACE_REQUIRED_BUFFER_BYTE_SIZE(driver->panel_width, driver->panel_height, driver->native_bits_per_pixel));
+    surface->scroll_top    = 0;
+    surface->scroll_bottom = 0;
+    surface->scroll_offset = 0;
+
+    // Whatever the display showed before no longer matches the buffer
+    surface_mark_all_dirty(surface);
+    return true;
+}
+
+static bool qp_surface_power(painter_device_t device, bool power_on) {
+    // No-op.
+    return true;
+}
+
+static bool qp_surface_clear(painter_device_t device) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    driver->driver_vtable->init(device, driver->rotation); // Re-init the surface
+    return true;
+}
+
+static bool qp_surface_flush(painter_device_t device) {
+    painter_driver_t *        driver  = (painter_driver_t *)device;
+    surface_painter_device_t *surface = (surface_painter_device_t *)driver;
+    surface->is_pending               = false;
+    surface->num_dirty                = 0;
+    return true;
+}
+
+static bool qp_surface_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    painter_driver_t *        driver  = (painter_driver_t *)device;
+    surface_painter_device_t *surface = (surface_painter_device_t *)driver;
+
+    // Anything drawn in the previous viewport becomes its own dirty region
+    surface_commit_pending(surface);
+
+    // Set the viewport locations
+    surface->viewport_l = left;
+    surface->viewport_t = top;
+    surface->viewport_r = right;
+    surface->viewport_b = bottom;
+
+    // Reset the write location to the top left
+    surface->pixdata_x = left;
+    surface->pixdata_y = top;
+    return true;
+}
+
+// Stream pixel data to the current write position in GRAM
+static bool qp_surface_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    painter_driver_t *        driver  = (painter_driver_t *)device;
+    surface_painter_device_t *surface = (surface_painter_device_t *)driver;
+    stream_pixdata(surface, pixel_data, native_pixel_count);
+    return true;
+}
+
+// Pixel colour conversion
+static bool qp_surface_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    uint8_t           bpp    = driver->native_bits_per_pixel;
+    for (int16_t i = 0; i < palette_size; ++i) {
+        if (bpp == 16) {
+            RGB      rgb      = hsv_to_rgb_nocie((HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v});
+            uint16_t rgb565   = (((uint16_t)rgb.r) >> 3) << 11 | (((uint16_t)rgb.g) >> 2) << 5 | (((uint16_t)rgb.b) >> 3);
+            palette[i].rgb565 = __builtin_bswap16(rgb565);
+        } else {
+            // Grayscale surfaces keep the brightness, quantised to the available levels
+            palette[i].mono = palette[i].hsv888.v >> (8 - bpp);
+        }
+    }
+    return true;
+}
+
+// Append pixels to the target location, keyed by the pixel index
+static bool qp_surface_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    uint8_t           bpp    = driver->native_bits_per_pixel;
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        write_packed_pixel(target_buffer, bpp, pixel_offset + i, bpp == 16 ? palette[palette_indices[i]].rgb565 : palette[palette_indices[i]].mono);
+    }
+    return true;
+}
+
+// Append data to the target location
+static bool qp_surface_append_pixdata(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte) {
+    target_buffer[pixdata_offset] = pixdata_byte;
+    return true;
+}
+
+// Fill the target location with a single color
+static bool qp_surface_fill_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    if (driver->native_bits_per_pixel == 16) {
+        qp_internal_fill_16bpp(target_buffer, pixel_offset, pixel_count, color.rgb565);
+    } else {
+        qp_internal_fill_packed(target_buffer, driver->native_bits_per_pixel, pixel_offset, pixel_count, color.mono);
+    }
+    return true;
+}
+
+// Scroll a band of the surface, applied when it's next drawn to a display
+static bool qp_surface_scroll(painter_device_t device, uint16_t top, uint16_t bottom, uint16_t offset) {
+    painter_driver_t *        driver  = (painter_driver_t *)device;
+    surface_painter_device_t *surface = (surface_painter_device_t *)driver;
+
+    // Every row in both the old and new bands moves on the display, so all of them need to be redrawn
+    surface_commit_pending(surface);
+    if (surface->scroll_offset != 0) {
+        surface_add_dirty_region(surface, (surface_dirty_region_t){.l = 0, .t = surface->scroll_top, .r = driver->panel_width - 1, .b = surface->scroll_bottom});
+    }
+    if (offset != 0) {
+        surface_add_dirty_region(surface, (surface_dirty_region_t){.l = 0, .t = top, .r = driver->panel_width - 1, .b = bottom});
+    }
+
+    surface->scroll_top    = top;
+    surface->scroll_bottom = bottom;
+    surface->scroll_offset = offset;
+    return true;
+}
+
+// Copy a rectangle within the surface, in whichever order leaves overlapping source pixels intact until they're read
+static bool qp_surface_blit(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom, uint16_t x, uint16_t y) {
+    painter_driver_t *        driver  = (painter_driver_t *)device;
+    surface_painter_device_t *surface = (surface_painter_device_t *)driver;
+    uint8_t                   bpp     = driver->native_bits_per_pixel;
+    uint16_t                  width   = right - left + 1;
+    uint16_t                  height  = bottom - top + 1;
+
+    for (uint16_t n = 0; n < height; ++n) {
+        uint16_t row     = (y > top) ? (height - 1 - n) : n;
+        uint32_t src_row = ((uint32_t)(top + row)) * driver->panel_width;
+        uint32_t dst_row = ((uint32_t)(y + row)) * driver->panel_width;
+        if (bpp >= 8) {
+            uint8_t bytes_per_pixel = bpp / 8;
+            memmove(&surface->u8buffer[(dst_row + x) * bytes_per_pixel], &surface->u8buffer[(src_row + left) * bytes_per_pixel], width * bytes_per_pixel);
+        } else {
+            for (uint16_t m = 0; m < width; ++m) {
+                uint16_t col = (x > left) ? (width - 1 - m) : m;
+                write_packed_pixel(surface->buffer, bpp, dst_row + x + col, read_packed_pixel(surface->buffer, bpp, src_row + left + col));
+            }
+        }
+    }
+
+    surface_commit_pending(surface);
+    surface_add_dirty_region(surface, (surface_dirty_region_t){.l = x, .t = y, .r = x + width - 1, .b = y + height - 1});
+    return true;
+}
+
+const painter_driver_vtable_t surface_driver_vtable = {
+    .init            = qp_surface_init,
+    .power           = qp_surface_power,
+    .clear           = qp_surface_clear,
+    .flush           = qp_surface_flush,
+    .pixdata         = qp_surface_pixdata,
+    .viewport        = qp_surface_viewport,
+    .palette_convert = qp_surface_palette_convert,
+    .append_pixels   = qp_surface_append_pixels,
+    .append_pixdata  = qp_surface_append_pixdata,
+    .fill_pixels     = qp_surface_fill_pixels,
+    .scroll          = qp_surface_scroll,
+    .blit            = qp_surface_blit,
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Comms vtable
+
+static bool qp_surface_comms_init(painter_device_t device) {
+    // No-op.
+    return true;
+}
+static bool qp_surface_comms_start(painter_device_t device) {
+    // No-op.
+    return true;
+}
+static void qp_surface_comms_stop(painter_device_t device) {
+    // No-op.
+}
+uint32_t qp_surface_comms_send(painter_device_t device, const void *data, uint32_t byte_count) {
+    // No-op.
+    return byte_count;
+}
+
+painter_comms_vtable_t surface_driver_comms_vtable = {
+    // These are all effective no-op's because they're not actually needed.
+    .comms_init  = qp_surface_comms_init,
+    .comms_start = qp_surface_comms_start,
+    .comms_stop  = qp_surface_comms_stop,
+    .comms_send  = qp_surface_comms_send};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Factory function for creating a handle to a surface
+
+painter_device_t qp_make_surface(uint16_t panel_width, uint16_t panel_height, uint8_t bpp, void *buffer) {
+    if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8 && bpp != 16) {
+        qp_dprintf("qp_make_surface: fail (unsupported bpp %d)\n", (int)bpp);
+        return NULL;
+    }
+
+#if !(QUANTUM_PAINTER_SUPPORTS_256_PALETTE)
+    // Drawing a grayscale surface fills one palette entry per level, and the lookup table only has 16 of them
+    if (bpp == 8) {
+        qp_dprintf("qp_make_surface: fail (8bpp requires QUANTUM_PAINTER_SUPPORTS_256_PALETTE)\n");
+        return NULL;
+    }
+#endif
+
+    for (uint32_t i = 0; i < SURFACE_NUM_DEVICES; ++i) {
+        surface_painter_device_t *driver = &surface_drivers[i];
+        if (!driver->base.driver_vtable) {
+            driver->base.driver_vtable         = &surface_driver_vtable;
+            driver->base.comms_vtable          = &surface_driver_comms_vtable;
+            driver->base.native_bits_per_pixel = bpp;
+            driver->base.panel_width           = panel_width;
+            driver->base.panel_height          = panel_height;
+            driver->base.rotation              = QP_ROTATION_0;
+            driver->base.offset_x              = 0;
+            driver->base.offset_y              = 0;
+            driver->buffer                     = buffer;
+            return (painter_device_t)driver;
+        }
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Drawing routine to copy out the dirty regions and send them to another device
+
+// Stream rows `top` to `bottom` of a dirty region to the display, starting at display row `display_y`
+static bool qp_surface_draw_run(surface_painter_device_t *surface_handle, painter_device_t display, const surface_dirty_region_t *region, uint16_t top, uint16_t bottom, uint16_t x, uint16_t display_y, uint32_t max_pixel_count) {
+    painter_driver_t *display_driver = (painter_driver_t *)display;
+    uint8_t           bpp            = surface_handle->base.native_bits_per_pixel;
+
+    // Set the target drawing area
+    if (!display_driver->driver_vtable->viewport(display, x + region->l, display_y, x + region->r, display_y + (bottom - top))) {
+        return false;
+    }
+
+    // Fill the global pixdata area so that we can start transferring to the panel
+    uint32_t pixel_counter = 0;
+    for (uint16_t py = top; py <= bottom; ++py) {
+        uint32_t row = ((uint32_t)py) * surface_handle->base.panel_width;
+        for (uint16_t px = region->l; px <= region->r; ++px) {
+            if (pixel_counter == 0) {
+                qp_internal_pixdata_buffer_prepare();
+            }
+            if (bpp == 16) {
+                ((uint16_t *)qp_internal_global_pixdata_buffer)[pixel_counter++] = surface_handle->u16buffer[row + px];
+            } else {
+                // Grayscale levels index into the palette converted for the display
+                uint8_t level = read_packed_pixel(surface_handle->buffer, bpp, row + px);
+                display_driver->driver_vtable->append_pixels(display, qp_internal_global_pixdata_buffer, qp_internal_global_pixel_lookup_table, pixel_counter++, 1, &level);
+            }
+
+            // If we've accumulated enough data, send it
+            if (pixel_counter == max_pixel_count) {
+                if (!display_driver->driver_vtable->pixdata(display, qp_internal_global_pixdata_buffer, pixel_counter)) {
+                    return false;
+                }
+                // Reset the counter
+                pixel_counter = 0;
+            }
+        }
+    }
+
+    // If there's any leftover data, send it
+    if (pixel_counter > 0) {
+        if (!display_driver->driver_vtable->pixdata(display, qp_internal_global_pixdata_buffer, pixel_counter)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool qp_surface_draw_regions(surface_painter_device_t *surface_handle, painter_device_t display, uint16_t x, uint16_t y) {
+    uint32_t max_pixel_count = qp_internal_num_pixels_in_buffer(display);
+
+    for (uint8_t i = 0; i < surface_handle->num_dirty; ++i) {
+        const surface_dirty_region_t *region = &surface_handle->dirty[i];
+
+        // Scrolling can split the region, so send each run of rows that stays contiguous on the display separately
+        uint16_t run_t = region->t;
+        while (run_t <= region->b) {
+            uint16_t display_t = surface_display_row(surface_handle, run_t);
+            uint16_t run_b     = run_t;
+            while (run_b < region->b && surface_display_row(surface_handle, run_b + 1) == display_t + (run_b + 1 - run_t)) {
+                ++run_b;
+            }
+
+            if (!qp_surface_draw_run(surface_handle, display, region, run_t, run_b, x, y + display_t, max_pixel_count)) {
+                return false;
+            }
+            run_t = run_b + 1;
+        }
+    }
+
+    return true;
+}
+
+static bool qp_surface_draw_impl(painter_device_t surface, painter_device_t display, uint16_t x, uint16_t y, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888) {
+    painter_driver_t *        surface_driver = (painter_driver_t *)surface;
+    surface_painter_device_t *surface_handle = (surface_painter_device_t *)surface_driver;
+    painter_driver_t *        display_driver = (painter_driver_t *)display;
+
+    if (!display_driver || !display_driver->validate_ok) {
+        qp_dprintf("qp_surface_draw: fail (validation_ok == false)\n");
+        return false;
+    }
+
+    // Anything drawn since the last viewport change needs to go out too
+    surface_commit_pending(surface_handle);
+
+    // If we're not dirty... we're done.
+    if (surface_handle->num_dirty == 0) {
+        return true;
+    }
+
+    uint8_t bpp = surface_driver->native_bits_per_pixel;
+    if (bpp == 16 && display_driver->native_bits_per_pixel != 16) {
+        qp_dprintf("qp_surface_draw: fail (RGB565 surfaces can only be drawn to 16bpp displays)\n");
+        return false;
+    }
+
+    if (!qp_comms_start(display)) {
+        qp_dprintf("qp_surface_draw: fail (could not start comms)\n");
+        return false;
+    }
+
+    if (bpp < 16) {
+        // Map the grayscale levels onto the display's native colors
+        if (!qp_internal_recolor_palette(display, fg_hsv888, bg_hsv888, 1 << bpp)) {
+            qp_dprintf("qp_surface_draw: fail (could not convert pixels to native)\n");
+            qp_comms_stop(display);
+            return false;
+        }
+    }
+
+    bool ok = qp_surface_draw_regions(surface_handle, display, x, y);
+    qp_comms_stop(display);
+
+    if (!ok) {
+        return false;
+    }
+
+    // Clear the dirty info for the surface
+    return qp_flush(surface);
+}
+
+bool qp_surface_draw(painter_device_t surface, painter_device_t display, uint16_t x, uint16_t y) {
+    static const qp_pixel_t white = {.hsv888 = {.h = 0, .s = 0, .v = 255}};
+    static const qp_pixel_t black = {.hsv888 = {.h = 0, .s = 0, .v = 0}};
+    return qp_surface_draw_impl(surface, display, x, y, white, black);
+}
+
+bool qp_surface_draw_recolor(painter_device_t surface, painter_device_t display, uint16_t x, uint16_t y, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg) {
+    qp_pixel_t fg_hsv888 = {.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
+    qp_pixel_t bg_hsv888 = {.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
+    return qp_surface_draw_impl(surface, display, x, y, fg_hsv888, bg_hsv888);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Legacy RGB565 surface API
+
+#ifdef QUANTUM_PAINTER_RGB565_SURFACE_ENABLE
+painter_device_t qp_rgb565_make_surface(uint16_t panel_width, uint16_t panel_height, void *buffer) {
+    return qp_make_surface(panel_width, panel_height, 16, buffer);
+}
+
+bool qp_rgb565_surface_draw(painter_device_t surface, painter_device_t display, uint16_t x, uint16_t y) {
+    return qp_surface_draw(surface, display, x, y);
+}
+#endif // QUANTUM_PAINTER_RGB565_SURFACE_ENABLE
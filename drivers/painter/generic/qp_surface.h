@@ -0,0 +1,92 @@
+// Copyright 2022 Nick Brassel (@tzarc)
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "qp_internal.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter surface configurables (add to your keyboard's config.h)
+
+#ifndef SURFACE_NUM_DEVICES
+/**
+ * @def This controls the maximum number of surface devices that Quantum Painter can use at any one time.
+ *      Increasing this number allows for multiple framebuffers to be used. Each requires its own RAM allocation.
+ */
+#    if defined(RGB565_SURFACE_NUM_DEVICES) && (RGB565_SURFACE_NUM_DEVICES) > 1
+#        define SURFACE_NUM_DEVICES RGB565_SURFACE_NUM_DEVICES
+#    else
+#        define SURFACE_NUM_DEVICES 1
+#    endif
+#endif
+
+#ifndef SURFACE_NUM_DIRTY_REGIONS
+/**
+ * @def This controls the number of separate dirty rectangles each surface tracks. Once all are in use, further
+ *      drawing is merged into whichever region grows the least. Each region costs 8 bytes of RAM per surface.
+ */
+#    define SURFACE_NUM_DIRTY_REGIONS 4
+#endif
+
+#ifndef SURFACE_DIRTY_MERGE_PIXELS
+/**
+ * @def This controls how eagerly dirty rectangles are merged. Two regions are combined if their bounding box covers
+ *      at most this many pixels that neither region needed, as sending a few extra pixels is cheaper than setting up
+ *      another viewport on the display.
+ */
+#    define SURFACE_DIRTY_MERGE_PIXELS 64
+#endif
+
+// The number of bytes required for a surface buffer of the given size and bits per pixel
+#define SURFACE_REQUIRED_BUFFER_BYTE_SIZE(w, h, bpp) ((((uint32_t)(w)) * (h) * (bpp) + 7) / 8)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward declarations
+
+#ifdef QUANTUM_PAINTER_SURFACE_ENABLE
+/**
+ * Factory method for a surface (aka framebuffer).
+ *
+ * 16bpp surfaces hold RGB565 pixels. 1, 2, 4 and 8bpp surfaces hold grayscale levels, packed least significant bits
+ * first in the same way as QGF images, which are turned into colors when the surface is drawn to a display.
+ *
+ * @param panel_width[in] the width of the display panel
+ * @param panel_height[in] the height of the display panel
+ * @param bpp[in] the number of bits per pixel -- 1, 2, 4, 8 or 16
+ * @param buffer[in] pointer to a preallocated buffer of size `SURFACE_REQUIRED_BUFFER_BYTE_SIZE(panel_width, panel_height, bpp)`
+ * @return the device handle used with all drawing routines in Quantum Painter
+ */
+painter_device_t qp_make_surface(uint16_t panel_width, uint16_t panel_height, uint8_t bpp, void *buffer);
+
+/**
+ * Helper method to draw the dirty regions of the framebuffer to the target device.
+ *
+ * Grayscale surfaces are drawn white on black. After successful completion, the dirty regions are reset.
+ *
+ * @param surface[in] the surface to copy from
+ * @param display[in] the display to copy into
+ * @param x[in] the x-location of the original position of the framebuffer
+ * @param y[in] the y-location of the original position of the framebuffer
+ * @return whether the draw operation completed successfully
+ */
+bool qp_surface_draw(painter_device_t surface, painter_device_t display, uint16_t x, uint16_t y);
+
+/**
+ * Helper method to draw the dirty regions of a grayscale framebuffer to the target device, interpolating between the
+ * supplied background and foreground colors.
+ *
+ * After successful completion, the dirty regions are reset.
+ *
+ * @param surface[in] the surface to copy from
+ * @param display[in] the display to copy into
+ * @param x[in] the x-location of the original position of the framebuffer
+ * @param y[in] the y-location of the original position of the framebuffer
+ * @param hue_fg[in] the hue of the foreground color, used for the highest grayscale level
+ * @param sat_fg[in] the saturation of the foreground color
+ * @param val_fg[in] the value of the foreground color
+ * @param hue_bg[in] the hue of the background color, used for grayscale level zero
+ * @param sat_bg[in] the saturation of the background color
+ * @param val_bg[in] the value of the background color
+ * @return whether the draw operation completed successfully
+ */
+bool qp_surface_draw_recolor(painter_device_t surface, painter_device_t display, uint16_t x, uint16_t y, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg);
+#endif // QUANTUM_PAINTER_SURFACE_ENABLE
@@ -77,9 +77,12 @@ const tft_panel_dc_reset_painter_driver_vtable_t ili9341_driver_vtable = {
             .palette_convert = qp_tft_panel_palette_convert_rgb565_swapped,
             .append_pixels   = qp_tft_panel_append_pixels_rgb565,
             .append_pixdata  = qp_tft_panel_append_pixdata,
+            .fill_pixels     = qp_tft_panel_fill_pixels_rgb565,
+            .scroll          = qp_tft_panel_scroll,
         },
     .num_window_bytes   = 2,
     .swap_window_coords = false,
+    .num_scroll_lines   = 320,
     .opcodes =
         {
             .display_on         = ILI9XXX_CMD_DISPLAY_ON,
@@ -87,6 +90,8 @@ const tft_panel_dc_reset_painter_driver_vtable_t ili9341_driver_vtable = {
             .set_column_address = ILI9XXX_SET_COL_ADDR,
             .set_row_address    = ILI9XXX_SET_PAGE_ADDR,
             .enable_writes      = ILI9XXX_SET_MEM,
+            .set_scroll_area    = ILI9XXX_SET_VSCROLL,
+            .set_scroll_start   = ILI9XXX_SET_VSCROLL_ADDR,
         },
 };
 
@@ -5,6 +5,7 @@
 #include "qp_internal.h"
 #include "qp_comms.h"
 #include "qp_draw.h"
+#include "qp_internal_fill.h"
 #include "qp_tft_panel.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +79,36 @@ bool qp_tft_panel_viewport(painter_device_t device, uint16_t left, uint16_t top,
     return true;
 }
 
+// Hardware vertical scrolling
+bool qp_tft_panel_scroll(painter_device_t device, uint16_t top, uint16_t bottom, uint16_t offset) {
+    painter_driver_t *                          driver = (painter_driver_t *)device;
+    tft_panel_dc_reset_painter_driver_vtable_t *vtable = (tft_panel_dc_reset_painter_driver_vtable_t *)driver->driver_vtable;
+
+    // The scrolling registers work on GRAM lines, which only match up with the drawing rows when unrotated
+    if (vtable->num_scroll_lines == 0 || driver->rotation != QP_ROTATION_0) {
+        qp_dprintf("qp_tft_panel_scroll: fail (vertical scrolling unsupported in this configuration)\n");
+        return false;
+    }
+
+    // Work out the top fixed area, scroll area, and bottom fixed area -- together they need to cover all of GRAM
+    uint16_t top_fixed = top + driver->offset_y;
+    uint16_t scroll    = bottom - top + 1;
+    if (top_fixed + scroll > vtable->num_scroll_lines) {
+        qp_dprintf("qp_tft_panel_scroll: fail (scroll area exceeds GRAM)\n");
+        return false;
+    }
+    uint16_t bottom_fixed = vtable->num_scroll_lines - top_fixed - scroll;
+
+    uint8_t area[6] = {top_fixed >> 8, top_fixed & 0xFF, scroll >> 8, scroll & 0xFF, bottom_fixed >> 8, bottom_fixed & 0xFF};
+    qp_comms_command_databuf(device, vtable->opcodes.set_scroll_area, area, sizeof(area));
+
+    // The line shown at the top of the scroll area
+    uint16_t first_line = top_fixed + offset;
+    uint8_t  start[2]   = {first_line >> 8, first_line & 0xFF};
+    qp_comms_command_databuf(device, vtable->opcodes.set_scroll_start, start, sizeof(start));
+    return true;
+}
+
 // Stream pixel data to the current write position in GRAM
 bool qp_tft_panel_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
     painter_driver_t *driver = (painter_driver_t *)device;
@@ -131,3 +162,16 @@ bool qp_tft_panel_append_pixdata(painter_device_t device, uint8_t *target_buffer
     target_buffer[pixdata_offset] = pixdata_byte;
     return true;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fill the target location with a single color
+
+bool qp_tft_panel_fill_pixels_rgb565(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count) {
+    qp_internal_fill_16bpp(target_buffer, pixel_offset, pixel_count, color.rgb565);
+    return true;
+}
+
+bool qp_tft_panel_fill_pixels_rgb888(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count) {
+    qp_internal_fill_24bpp(target_buffer, pixel_offset, pixel_count, color.rgb888.r, color.rgb888.g, color.rgb888.b);
+    return true;
+}
@@ -21,6 +21,9 @@ typedef struct tft_panel_dc_reset_painter_driver_vtable_t {
     // Whether or not the x/y coords should be swapped on 90/270 rotation
     bool swap_window_coords;
 
+    // Number of GRAM lines covered by the vertical scrolling definition, or zero if vertical scrolling isn't supported
+    uint16_t num_scroll_lines;
+
     // Opcodes for normal display operation
     struct {
         uint8_t display_on;
@@ -28,6 +31,8 @@ typedef struct tft_panel_dc_reset_painter_driver_vtable_t {
         uint8_t set_column_address;
         uint8_t set_row_address;
         uint8_t enable_writes;
+        uint8_t set_scroll_area;
+        uint8_t set_scroll_start;
     } opcodes;
 } tft_panel_dc_reset_painter_driver_vtable_t;
 
@@ -53,6 +58,7 @@ bool qp_tft_panel_clear(painter_device_t device);
 bool qp_tft_panel_flush(painter_device_t device);
 bool qp_tft_panel_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom);
 bool qp_tft_panel_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count);
+bool qp_tft_panel_scroll(painter_device_t device, uint16_t top, uint16_t bottom, uint16_t offset);
 
 bool qp_tft_panel_palette_convert_rgb565_swapped(painter_device_t device, int16_t palette_size, qp_pixel_t *palette);
 bool qp_tft_panel_palette_convert_rgb888(painter_device_t device, int16_t palette_size, qp_pixel_t *palette);
@@ -60,4 +66,7 @@ bool qp_tft_panel_palette_convert_rgb888(painter_device_t device, int16_t palett
 bool qp_tft_panel_append_pixels_rgb565(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices);
 bool qp_tft_panel_append_pixels_rgb888(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices);
 
+bool qp_tft_panel_fill_pixels_rgb565(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count);
+bool qp_tft_panel_fill_pixels_rgb888(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count);
+
 bool qp_tft_panel_append_pixdata(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte);
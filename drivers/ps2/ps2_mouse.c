@@ -25,6 +25,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "report.h"
 #include "debug.h"
 #include "ps2.h"
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    include "pointing_device.h"
+#endif
 
 /* ============================= MACROS ============================ */
 
@@ -117,6 +120,11 @@ void ps2_mouse_task(void) {
         if (mouse_report.x || mouse_report.y || mouse_report.v) {
             ps2_mouse_moved_user(&mouse_report);
         }
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+        // PS/2 wheels step in whole notches, which the host may count in finer steps
+        mouse_report.v = pointing_device_scale_notches(mouse_report.v);
+        mouse_report.h = pointing_device_scale_notches(mouse_report.h);
+#endif
 #ifdef PS2_MOUSE_DEBUG_HID
         // Used to debug the bytes sent to the host
         ps2_mouse_print_report(&mouse_report);
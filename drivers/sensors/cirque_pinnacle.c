@@ -25,6 +25,12 @@ void cirque_pinnacle_enable_feed(bool feedEnable);
 void RAP_ReadBytes(uint8_t address, uint8_t* data, uint8_t count);
 void RAP_Write(uint8_t address, uint8_t data);
 
+_Static_assert((CIRQUE_PINNACLE_SAMPLE_BUFFER & (CIRQUE_PINNACLE_SAMPLE_BUFFER - 1)) == 0, "CIRQUE_PINNACLE_SAMPLE_BUFFER must be a power of two");
+
+// Samples read since the last report, head and tail are free running
+static pinnacle_data_t samples[CIRQUE_PINNACLE_SAMPLE_BUFFER];
+static uint8_t         samples_head, samples_tail;
+
 #if CIRQUE_PINNACLE_POSITION_MODE
 /*  Logical Scaling Functions */
 // Clips raw coordinates to "reachable" window of sensor
@@ -225,6 +231,7 @@ void cirque_pinnacle_init(void) {
 #endif
 
     touchpad_init = true;
+    samples_tail  = samples_head;
 
     // send a RESET command now, in case QMK had a soft-reset without a power cycle
     RAP_Write(HOSTREG__SYSCONFIG1, HOSTREG__SYSCONFIG1__RESET);
@@ -323,3 +330,40 @@ pinnacle_data_t cirque_pinnacle_read_data(void) {
     result.valid = true;
     return result;
 }
+
+// Reads a sample from the trackpad, if one is ready, and buffers it for the next report
+void cirque_pinnacle_sample(void) {
+    pinnacle_data_t data = cirque_pinnacle_read_data();
+
+    if (!data.valid) {
+        return;
+    }
+    if ((uint8_t)(samples_head - samples_tail) >= CIRQUE_PINNACLE_SAMPLE_BUFFER) {
+#if CIRQUE_PINNACLE_POSITION_MODE
+        // Positions don't depend on earlier samples, so the oldest one is dropped
+        samples_tail++;
+#else
+        // Deltas do, so the new one is added to the newest sample instead
+        pinnacle_data_t* newest = &samples[(uint8_t)(samples_head - 1) & (CIRQUE_PINNACLE_SAMPLE_BUFFER - 1)];
+        int16_t          wheel  = newest->wheelCount + data.wheelCount;
+        newest->xDelta += data.xDelta;
+        newest->yDelta += data.yDelta;
+        // Saturated rather than wrapped, so a fast spin can't turn into scrolling the other way
+        newest->wheelCount = wheel > INT8_MAX ? INT8_MAX : (wheel < INT8_MIN ? INT8_MIN : wheel);
+        newest->buttons    = data.buttons;
+        return;
+#endif
+    }
+    samples[samples_head & (CIRQUE_PINNACLE_SAMPLE_BUFFER - 1)] = data;
+    samples_head++;
+}
+
+// Takes the oldest buffered sample, returns false if there are none
+bool cirque_pinnacle_next_sample(pinnacle_data_t* data) {
+    if (samples_head == samples_tail) {
+        return false;
+    }
+    *data = samples[samples_tail & (CIRQUE_PINNACLE_SAMPLE_BUFFER - 1)];
+    samples_tail++;
+    return true;
+}
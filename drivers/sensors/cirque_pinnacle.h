@@ -52,6 +52,9 @@
 #        define CIRQUE_PINNACLE_SIDE_SCROLL_ENABLE
 #    endif
 #endif
+#ifndef CIRQUE_PINNACLE_SAMPLE_BUFFER
+#    define CIRQUE_PINNACLE_SAMPLE_BUFFER 4 // Samples held until the next report, must be a power of two
+#endif
 #if !defined(POINTING_DEVICE_TASK_THROTTLE_MS)
 #    define POINTING_DEVICE_TASK_THROTTLE_MS 10 // Cirque Pinnacle in normal operation produces data every 10ms. Advanced configuration for pen/stylus usage might require lower values.
 #endif
@@ -113,6 +116,8 @@ void            cirque_pinnacle_init(void);
 void            cirque_pinnacle_calibrate(void);
 void            cirque_pinnacle_cursor_smoothing(bool enable);
 pinnacle_data_t cirque_pinnacle_read_data(void);
+void            cirque_pinnacle_sample(void);
+bool            cirque_pinnacle_next_sample(pinnacle_data_t* data);
 void            cirque_pinnacle_scale_data(pinnacle_data_t* coordinates, uint16_t xResolution, uint16_t yResolution);
 uint16_t        cirque_pinnacle_get_scale(void);
 void            cirque_pinnacle_set_scale(uint16_t scale);
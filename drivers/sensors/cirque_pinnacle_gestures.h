@@ -19,6 +19,10 @@
 #include "cirque_pinnacle.h"
 #include "report.h"
 
+#ifndef CIRQUE_PINNACLE_GESTURE_BUDGET
+#    define CIRQUE_PINNACLE_GESTURE_BUDGET 2 // Buffered samples run through the gestures for each report
+#endif
+
 typedef struct {
     bool tap_enable;
     bool circular_scroll_enable;
@@ -106,5 +110,8 @@ void cirque_pinnacle_enable_cursor_glide(bool enable);
 void cirque_pinnacle_configure_cursor_glide(float trigger_px);
 #endif
 
-/* Process available gestures */
+/*
+ * Run a sample through the available gestures, adding any scroll to the report.
+ * Returns true if the sample's movement belongs to a gesture and shouldn't move the cursor.
+ */
 bool cirque_pinnacle_gestures(report_mouse_t* mouse_report, pinnacle_data_t touchData);
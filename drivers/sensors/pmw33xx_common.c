@@ -12,6 +12,7 @@
 #include "pmw33xx_common.h"
 #include "string.h"
 #include "wait.h"
+#include "timer.h"
 #include "spi_master.h"
 #include "progmem.h"
 
@@ -21,8 +22,8 @@ extern const uint8_t pmw33xx_firmware_signature[3] PROGMEM;
 static const pin_t cs_pins_left[]  = PMW33XX_CS_PINS;
 static const pin_t cs_pins_right[] = PMW33XX_CS_PINS_RIGHT;
 
-static bool in_burst_left[ARRAY_SIZE(cs_pins_left)]   = {0};
-static bool in_burst_right[ARRAY_SIZE(cs_pins_right)] = {0};
+static pmw33xx_state_t state_left[ARRAY_SIZE(cs_pins_left)]   = {0};
+static pmw33xx_state_t state_right[ARRAY_SIZE(cs_pins_right)] = {0};
 
 bool __attribute__((cold)) pmw33xx_upload_firmware(uint8_t sensor);
 bool __attribute__((cold)) pmw33xx_check_signature(uint8_t sensor);
@@ -33,7 +34,22 @@ void pmw33xx_set_cpi_all_sensors(uint16_t cpi) {
     }
 }
 
+// Waits out what is left of the time the sensor needs between two transactions
+static void pmw33xx_wait_ready(uint8_t sensor) {
+    while (timer_elapsed_us(pmw33xx_state[sensor].stop_time) < pmw33xx_state[sensor].holdoff_us) {
+    }
+    pmw33xx_state[sensor].holdoff_us = 0;
+}
+
+// Ends a transaction, the next one is held off until the given time has passed
+static void pmw33xx_spi_stop(uint8_t sensor, uint16_t holdoff_us) {
+    spi_stop();
+    pmw33xx_state[sensor].stop_time  = timer_read_us();
+    pmw33xx_state[sensor].holdoff_us = holdoff_us + PMW33XX_TIMER_MARGIN_US;
+}
+
 bool pmw33xx_spi_start(uint8_t sensor) {
+    pmw33xx_wait_ready(sensor);
     if (!spi_start(cs_pins[sensor], false, 3, PMW33XX_SPI_DIVISOR)) {
         spi_stop();
         return false;
@@ -49,7 +65,7 @@ bool pmw33xx_write(uint8_t sensor, uint8_t reg_addr, uint8_t data) {
     }
 
     if (reg_addr != REG_Motion_Burst) {
-        in_burst[sensor] = false;
+        pmw33xx_state[sensor].in_burst = false;
     }
 
     // send address of the register, with MSBit = 1 to indicate it's a write
@@ -60,11 +76,10 @@ bool pmw33xx_write(uint8_t sensor, uint8_t reg_addr, uint8_t data) {
 
     // tSCLK-NCS for write operation is 35us
     wait_us(35);
-    spi_stop();
 
     // tSWW/tSWR (=18us) minus tSCLK-NCS. Could be shortened, but it looks like
     // a safe lower bound
-    wait_us(145);
+    pmw33xx_spi_stop(sensor, 145);
     return true;
 }
 
@@ -73,6 +88,9 @@ uint8_t pmw33xx_read(uint8_t sensor, uint8_t reg_addr) {
         return 0;
     }
 
+    // accessing any other register may end burst mode, so enter it again before the next burst read
+    pmw33xx_state[sensor].in_burst = false;
+
     // send adress of the register, with MSBit = 0 to indicate it's a read
     spi_write(reg_addr & 0x7f);
     // tSRAD (=160us)
@@ -81,10 +99,9 @@ uint8_t pmw33xx_read(uint8_t sensor, uint8_t reg_addr) {
 
     // tSCLK-NCS, 120ns
     wait_us(1);
-    spi_stop();
 
     //  tSRW/tSRR (=20us) mins tSCLK-NCS
-    wait_us(19);
+    pmw33xx_spi_stop(sensor, 19);
     return data;
 }
 
@@ -119,7 +136,8 @@ bool pmw33xx_upload_firmware(uint8_t sensor) {
         spi_write(pgm_read_byte(pmw33xx_firmware_data + i));
         wait_us(15);
     }
-    wait_us(200);
+    // the sensor needs 200us to start the firmware before the SROM ID can be read
+    pmw33xx_spi_stop(sensor, 200);
 
     pmw33xx_read(sensor, REG_SROM_ID);
     pmw33xx_write(sensor, REG_Config2, 0x00);
@@ -139,8 +157,7 @@ bool pmw33xx_init(uint8_t sensor) {
         return false;
     }
     wait_us(40);
-    spi_stop();
-    wait_us(40);
+    pmw33xx_spi_stop(sensor, 40);
 
     if (!pmw33xx_write(sensor, REG_Power_Up_Reset, 0x5a)) {
         return false;
@@ -185,12 +202,12 @@ pmw33xx_report_t pmw33xx_read_burst(uint8_t sensor) {
         return report;
     }
 
-    if (!in_burst[sensor]) {
+    if (!pmw33xx_state[sensor].in_burst) {
         pd_dprintf("PMW33XX (%d): burst\n", sensor);
         if (!pmw33xx_write(sensor, REG_Motion_Burst, 0x00)) {
             return report;
         }
-        in_burst[sensor] = true;
+        pmw33xx_state[sensor].in_burst = true;
     }
 
     if (!pmw33xx_spi_start(sensor)) {
@@ -204,10 +221,11 @@ pmw33xx_report_t pmw33xx_read_burst(uint8_t sensor) {
 
     // panic recovery, sometimes burst mode works weird.
     if (report.motion.w & 0b111) {
-        in_burst[sensor] = false;
+        pmw33xx_state[sensor].in_burst = false;
     }
 
-    spi_stop();
+    // tBEXIT (=500ns) is covered by the margin
+    pmw33xx_spi_stop(sensor, 0);
 
     pd_dprintf("PMW33XX (%d): motion: 0x%x dx: %i dy: %i\n", sensor, report.motion.w, report.delta_x, report.delta_y);
 
@@ -41,6 +41,12 @@ typedef struct __attribute__((packed)) {
 _Static_assert(sizeof(pmw33xx_report_t) == 6, "pmw33xx_report_t must be 6 bytes in size");
 _Static_assert(sizeof((pmw33xx_report_t){0}.motion) == 1, "pmw33xx_report_t.motion must be 1 byte in size");
 
+typedef struct {
+    bool     in_burst;   // motion burst mode is entered
+    uint16_t holdoff_us; // time the sensor needs after the last transaction, before the next one
+    uint32_t stop_time;  // end of the last transaction, from timer_read_us()
+} pmw33xx_state_t;
+
 #if !defined(PMW33XX_CLOCK_SPEED)
 #    define PMW33XX_CLOCK_SPEED 2000000
 #endif
@@ -53,6 +59,16 @@ _Static_assert(sizeof((pmw33xx_report_t){0}.motion) == 1, "pmw33xx_report_t.moti
 #    endif
 #endif
 
+// Added to the gaps between transactions, covering the resolution of timer_read_us()
+#if !defined(PMW33XX_TIMER_MARGIN_US)
+#    if defined(CH_CFG_ST_FREQUENCY)
+// ChibiOS counts whole systicks
+#        define PMW33XX_TIMER_MARGIN_US ((1000000 + CH_CFG_ST_FREQUENCY - 1) / CH_CFG_ST_FREQUENCY)
+#    else
+#        define PMW33XX_TIMER_MARGIN_US 10
+#    endif
+#endif
+
 #if !defined(PMW33XX_LIFTOFF_DISTANCE)
 #    define PMW33XX_LIFTOFF_DISTANCE 0x02
 #endif
@@ -92,7 +108,7 @@ _Static_assert(sizeof((pmw33xx_report_t){0}.motion) == 1, "pmw33xx_report_t.moti
 
 // Defines so the old variable names are swapped by the appropiate value on each half
 #define cs_pins (is_keyboard_left() ? cs_pins_left : cs_pins_right)
-#define in_burst (is_keyboard_left() ? in_burst_left : in_burst_right)
+#define pmw33xx_state (is_keyboard_left() ? state_left : state_right)
 #define pmw33xx_number_of_sensors (is_keyboard_left() ? ARRAY_SIZE((pin_t[])PMW33XX_CS_PINS) : ARRAY_SIZE((pin_t[])PMW33XX_CS_PINS_RIGHT))
 
 #if PMW33XX_CPI > PMW33XX_CPI_MAX || PMW33XX_CPI < PMW33XX_CPI_MIN || (PMW33XX_CPI % PMW33XX_CPI_STEP) != 0U
@@ -79,6 +79,7 @@ subcommands = [
     'qmk.cli.new.keymap',
     'qmk.cli.painter',
     'qmk.cli.pytest',
+    'qmk.cli.rgb_stream',
     'qmk.cli.via2json',
 ]
 
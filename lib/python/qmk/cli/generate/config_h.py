@@ -11,6 +11,7 @@ from qmk.json_schema import json_load
 from qmk.keyboard import keyboard_completer, keyboard_folder
 from qmk.commands import dump_lines, parse_configurator_json
 from qmk.path import normpath, FileType
+from qmk.rgb_matrix import has_output_lut
 from qmk.constants import GPL2_HEADER_C_LIKE, GENERATED_HEADER_C_LIKE
 
 
@@ -206,6 +207,9 @@ def generate_config_h(cli):
     if 'rgb_matrix' in kb_info_json:
         generate_led_animations_config(kb_info_json['rgb_matrix'], config_h_lines, 'ENABLE_RGB_MATRIX_')
 
+        if has_output_lut(kb_info_json):
+            config_h_lines.append(generate_define('RGB_MATRIX_OUTPUT_LUT'))
+
     if 'rgblight' in kb_info_json:
         generate_led_animations_config(kb_info_json['rgblight'], config_h_lines, 'RGBLIGHT_EFFECT_')
 
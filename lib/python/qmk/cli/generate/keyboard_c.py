@@ -6,6 +6,7 @@ from qmk.info import info_json
 from qmk.commands import dump_lines
 from qmk.keyboard import keyboard_completer, keyboard_folder
 from qmk.path import normpath
+from qmk.rgb_matrix import generate_output_lut
 from qmk.constants import GPL2_HEADER_C_LIKE, GENERATED_HEADER_C_LIKE
 
 
@@ -70,6 +71,7 @@ def generate_keyboard_c(cli):
     keyboard_h_lines = [GPL2_HEADER_C_LIKE, GENERATED_HEADER_C_LIKE, '#include QMK_KEYBOARD_H', '']
 
     keyboard_h_lines.extend(_gen_led_config(kb_info_json))
+    keyboard_h_lines.extend(generate_output_lut(kb_info_json))
 
     # Show the results
     dump_lines(cli.args.output, keyboard_h_lines, cli.args.quiet)
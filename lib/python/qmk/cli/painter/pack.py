@@ -0,0 +1,77 @@
+"""This script packs Quantum Painter images and fonts into a bundle for external SPI flash.
+"""
+import datetime
+from string import Template
+from qmk.path import normpath
+from qmk.painter import render_license
+from qmk.painter_qpa import save_bundle, asset_sane_name, QPA_ASSET_IMAGE
+from milc import cli
+
+bundle_header_template = """\
+${license}
+#pragma once
+
+// Total size of the bundle, to be written to external flash at QUANTUM_PAINTER_FLASH_ASSETS_ADDRESS
+#define QPA_${sane_name}_SIZE ${byte_count}
+
+// Asset indices, for use with qp_load_image_flash() and qp_load_font_flash()
+${asset_lines}
+"""
+
+
+@cli.argument('-o', '--output', default='', help='Specify output directory. Defaults to the current directory.')
+@cli.argument('-n', '--name', default='assets', help='Name of the bundle, used for the output filenames and generated defines. Defaults to "assets".')
+@cli.argument('-a', '--align', default=1, type=int, help='Pads each asset out to a multiple of this many bytes, such as the flash page size. Defaults to 1.')
+@cli.argument('inputs', nargs='+', arg_only=True, type=normpath, help='The raw .qgf and .qff files to pack, as written by the --raw option of the conversion commands.')
+@cli.subcommand('Packs Quantum Painter images and fonts into a bundle for external flash')
+def painter_pack(cli):
+    """Packs raw QGF images and QFF fonts into a single QPA bundle, ready to be written to external SPI flash.
+
+    The bundle is written to `NAME.qpa`, alongside `NAME.qpa.h` which lists the index of each asset for use with `qp_load_image_flash()` and `qp_load_font_flash()`.
+    """
+    if cli.args.align < 1:
+        cli.log.error('Alignment must be at least 1 byte!')
+        return False
+
+    # Read in all the assets
+    assets = []
+    for input_file in cli.args.inputs:
+        if not input_file.exists():
+            cli.log.error(f'Input file {input_file} does not exist!')
+            return False
+        assets.append((input_file.stem, input_file.read_bytes()))
+
+    output_dir = normpath(cli.args.output or '.')
+    bundle_file = output_dir / (cli.args.name + '.qpa')
+    header_file = output_dir / (cli.args.name + '.qpa.h')
+    sane_name = asset_sane_name(cli.args.name)
+
+    # Write out the bundle
+    try:
+        with open(bundle_file, 'wb') as bundle:
+            print(f"Writing {bundle_file}...")
+            entries = save_bundle(assets, bundle, cli.args.align)
+            byte_count = bundle.tell()
+    except ValueError as e:
+        cli.log.error(f'Could not pack assets: {e}')
+        return False
+
+    # Work out the text substitutions for rendering the header
+    asset_lines = []
+    for index, entry in enumerate(entries):
+        kind = 'image' if entry['type'] == QPA_ASSET_IMAGE else 'font'
+        asset_lines.append(f"#define QPA_{sane_name}_{asset_sane_name(entry['name'])} {index} // {kind}, {entry['length']} bytes")
+
+    subs = {
+        'generated_type': 'asset',
+        'generator_command': f'qmk painter-pack -n {cli.args.name} ' + ' '.join(f.name for f in cli.args.inputs),
+        'year': datetime.date.today().strftime("%Y"),
+        'sane_name': sane_name,
+        'byte_count': byte_count,
+        'asset_lines': '\n'.join(asset_lines),
+    }
+    subs.update({'license': render_license(subs)})
+
+    with open(header_file, 'w') as header:
+        print(f"Writing {header_file}...")
+        header.write(Template(bundle_header_template).substitute(subs))
@@ -0,0 +1,78 @@
+"""Stream a test pattern to the RGB_MATRIX_HOST_STREAM effect and measure the frame rate.
+"""
+import colorsys
+import time
+
+from milc import cli
+
+from qmk.host_stream import COMMAND_ID, COMMIT_REPLACED, COMMIT_STALE, HostStream, find_devices
+
+
+def _pattern(led_count, frame, sweep):
+    """A rainbow moving one LED per frame, or a single lit LED sweeping across an otherwise static frame.
+    """
+    if sweep:
+        colors = [(0, 0, 32)] * led_count
+        colors[frame % led_count] = (255, 255, 255)
+        return colors
+
+    colors = []
+    for index in range(led_count):
+        r, g, b = colorsys.hsv_to_rgb(((index + frame) % led_count) / led_count, 1, 1)
+        colors.append((int(r * 255), int(g * 255), int(b * 255)))
+    return colors
+
+
+@cli.argument('-d', '--device', help='USB vid:pid of the keyboard, in hex. Defaults to the first raw HID interface found.')
+@cli.argument('-n', '--frames', arg_only=True, type=int, default=600, help='Number of frames to send. Default 600.')
+@cli.argument('-r', '--rate', arg_only=True, type=int, default=0, help='Target frame rate, 0 sends as fast as the keyboard accepts. Default 0.')
+@cli.argument('-f', '--full', arg_only=True, action='store_true', help='Send every frame in full instead of only the LEDs that changed.')
+@cli.argument('-s', '--sweep', arg_only=True, action='store_true', help='Sweep a single LED instead of a moving rainbow, to measure sparse delta frames.')
+@cli.argument('-q', '--queue', arg_only=True, type=int, default=2, help='Maximum frames sent ahead of the last one rendered. Default 2.')
+@cli.argument('-c', '--command-id', arg_only=True, type=lambda x: int(x, 0), default=COMMAND_ID, help='RGB_MATRIX_HOST_STREAM_COMMAND_ID of the keyboard. Default 0x80.')
+@cli.subcommand('Measures the frame rate of the RGB Matrix host stream effect.', hidden=False if cli.config.user.developer else True)
+def rgb_stream(cli):
+    """Streams frames to a keyboard running RGB_MATRIX_HOST_STREAM and reports frames per second, reports per frame and dropped frames.
+    """
+    vid = pid = None
+    if cli.config.rgb_stream.device:
+        vid, pid = (int(x, 16) for x in cli.config.rgb_stream.device.split(':'))
+
+    devices = find_devices(vid, pid)
+    if not devices:
+        cli.log.error('No raw HID device found.')
+        return False
+
+    cli.log.info('Using %s %s', devices[0]['manufacturer_string'], devices[0]['product_string'])
+    stream = HostStream(devices[0]['path'], cli.args.command_id)
+
+    try:
+        status = stream.status()
+        if not status['active']:
+            cli.log.error('RGB_MATRIX_HOST_STREAM is not the active effect.')
+            return False
+
+        led_count = status['led_count']
+        dropped = status['dropped']
+        replaced = stale = 0
+        interval = 1 / cli.args.rate if cli.args.rate else 0
+
+        start = next_frame = time.monotonic()
+        for frame in range(cli.args.frames):
+            result = stream.send(_pattern(led_count, frame, cli.args.sweep), delta=not cli.args.full, max_in_flight=cli.args.queue)
+            replaced += result == COMMIT_REPLACED
+            stale += result == COMMIT_STALE
+
+            if interval:
+                next_frame += interval
+                time.sleep(max(0, next_frame - time.monotonic()))
+
+        elapsed = time.monotonic() - start
+        status = stream.status()
+    finally:
+        stream.close()
+
+    cli.log.info('%d frames of %d LEDs in %.2fs: {fg_cyan}%.1f FPS{fg_reset}', cli.args.frames, led_count, elapsed, cli.args.frames / elapsed)
+    cli.log.info('%.1f reports per frame', stream.frame_reports / cli.args.frames)
+    cli.log.info('%d frames replaced before rendering, %d stale commits', replaced, stale)
+    cli.log.info('%d frames dropped by the keyboard during the run', (status['dropped'] - dropped) & 0xFFFF)
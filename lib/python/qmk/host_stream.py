@@ -0,0 +1,189 @@
+"""Functions for streaming frames to the RGB_MATRIX_HOST_STREAM effect over raw HID.
+"""
+import time
+
+COMMAND_ID = 0x80
+REPORT_SIZE = 32
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+
+OP_DATA = 0x01
+OP_COMMIT = 0x02
+OP_STATUS = 0x03
+
+RECORD_RUN = 0x80
+RECORD_MAX = 0x7F
+HEADER_SIZE = 3
+
+# Runs shorter than this are cheaper to send as part of a literal record
+MIN_RUN = 3
+
+COMMIT_OK = 0
+COMMIT_REPLACED = 1
+COMMIT_STALE = 2
+
+
+def _run_length(frame, start, end):
+    """Returns how many LEDs from `start` share the color of `start`, up to `end`.
+    """
+    length = 1
+    while start + length < end and length < RECORD_MAX and frame[start + length] == frame[start]:
+        length += 1
+    return length
+
+
+def _changed_spans(previous, frame):
+    """Yields (start, end) for every span of LEDs which differ from the previous frame.
+    """
+    start = None
+    for index, color in enumerate(frame):
+        changed = previous is None or previous[index] != color
+        if changed and start is None:
+            start = index
+        elif not changed and start is not None:
+            yield start, index
+            start = None
+    if start is not None:
+        yield start, len(frame)
+
+
+def encode_frame(seq, frame, previous=None, command_id=COMMAND_ID):
+    """Encodes a frame into DATA reports followed by the COMMIT report.
+
+    Args:
+        seq
+            The frame sequence number, 0-255.
+
+        frame
+            A list of (r, g, b) tuples, one for each LED.
+
+        previous
+            The last frame sent, when given only the LEDs that changed are encoded.
+
+    Returns:
+        A list of `REPORT_SIZE` byte reports.
+    """
+    reports = []
+    packet = bytearray()
+
+    def flush():
+        if packet:
+            reports.append(bytes([command_id, OP_DATA, seq]) + bytes(packet).ljust(REPORT_SIZE - HEADER_SIZE, b'\0'))
+            packet.clear()
+
+    def space():
+        return REPORT_SIZE - HEADER_SIZE - len(packet)
+
+    for span_start, span_end in _changed_spans(previous, frame):
+        index = span_start
+        while index < span_end:
+            run = _run_length(frame, index, span_end)
+            if run >= MIN_RUN:
+                if space() < 5:
+                    flush()
+                packet.extend([index, RECORD_RUN | run, *frame[index]])
+                index += run
+                continue
+
+            # Literal record up to the next worthwhile run
+            end = index + 1
+            while end < span_end and end - index < RECORD_MAX and _run_length(frame, end, span_end) < MIN_RUN:
+                end += 1
+
+            while index < end:
+                if space() < 5:
+                    flush()
+                count = min(end - index, (space() - 2) // 3)
+                packet.extend([index, count])
+                for color in frame[index:index + count]:
+                    packet.extend(color)
+                index += count
+
+    flush()
+    if not reports:
+        # Nothing changed, an empty DATA report still opens the frame
+        reports.append(bytes([command_id, OP_DATA, seq]).ljust(REPORT_SIZE, b'\0'))
+    reports.append(bytes([command_id, OP_COMMIT, seq]).ljust(REPORT_SIZE, b'\0'))
+
+    return reports
+
+
+def find_devices(vid=None, pid=None):
+    """Returns the hid device info for every raw HID interface matching vid/pid.
+    """
+    import hid
+
+    return [device for device in hid.enumerate(vid or 0, pid or 0) if device['usage_page'] == RAW_USAGE_PAGE and device['usage'] == RAW_USAGE_ID]
+
+
+class HostStream:
+    """A raw HID connection to a keyboard running the RGB_MATRIX_HOST_STREAM effect.
+    """
+    def __init__(self, path, command_id=COMMAND_ID, timeout=100):
+        import hid
+
+        self.device = hid.Device(path=path)
+        self.command_id = command_id
+        self.timeout = timeout
+        self.seq = 0
+        self.previous = None
+        self.reports_sent = 0
+        self.frame_reports = 0
+        self.rendered_seq = 0
+
+        # Carry on from wherever the keyboard is, so in_flight() starts at zero
+        self.seq = self.status()['rendered_seq']
+
+    def close(self):
+        self.device.close()
+
+    def _write(self, report):
+        # The leading zero is the report ID, raw HID does not use one
+        self.device.write(b'\0' + report)
+        self.reports_sent += 1
+
+    def _request(self, report):
+        self._write(report)
+        deadline = time.monotonic() + self.timeout / 1000
+        while time.monotonic() < deadline:
+            reply = self.device.read(REPORT_SIZE, self.timeout)
+            if reply and reply[0] == self.command_id and reply[1] == report[1] and reply[2] == report[2]:
+                return reply
+        raise TimeoutError('No reply from the keyboard')
+
+    def status(self):
+        """Returns a dict with the LED count, last rendered sequence number, dropped frames and whether the effect is active.
+        """
+        reply = self._request(bytes([self.command_id, OP_STATUS, self.seq]).ljust(REPORT_SIZE, b'\0'))
+        self.rendered_seq = reply[4]
+        return {
+            'led_count': reply[3],
+            'rendered_seq': reply[4],
+            'dropped': reply[5] | reply[6] << 8,
+            'active': bool(reply[7]),
+        }
+
+    def in_flight(self):
+        return (self.seq - self.rendered_seq) & 0xFF
+
+    def send(self, frame, delta=True, max_in_flight=2):
+        """Sends a frame and commits it, waiting while more than `max_in_flight` frames are not yet rendered.
+
+        Returns the commit status.
+        """
+        while self.in_flight() > max_in_flight:
+            if not self.status()['active']:
+                raise RuntimeError('RGB_MATRIX_HOST_STREAM is not the active effect')
+
+        self.seq = (self.seq + 1) & 0xFF
+        reports = encode_frame(self.seq, frame, self.previous if delta else None, self.command_id)
+        self.frame_reports += len(reports)
+        for report in reports[:-1]:
+            self._write(report)
+
+        reply = self._request(reports[-1])
+        self.rendered_seq = reply[4]
+        # A stale commit means the keyboard lost part of the frame, so the next one must be complete
+        self.previous = list(frame) if reply[3] != COMMIT_STALE else None
+
+        return reply[3]
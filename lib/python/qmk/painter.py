@@ -2,9 +2,15 @@
 """
 import math
 import re
+from collections import deque
 from string import Template
 from PIL import Image, ImageOps
 
+# Compression schemes, see qp_internal_formats.h, painter_compression_t
+IMAGE_UNCOMPRESSED = 0x00
+IMAGE_COMPRESSED_RLE = 0x01
+IMAGE_COMPRESSED_LZ = 0x02
+
 # The list of valid formats Quantum Painter supports
 valid_formats = {
     'rgb888': {
@@ -328,3 +334,149 @@ def compress_bytes_qmk_rle(bytearray):
                 temp = []
                 repeat = False
     return output
+
+
+def decompress_bytes_qmk_rle(bytearray):
+    """Reverses compress_bytes_qmk_rle(), mirroring the decoder in quantum/painter/qp_draw_codec.c.
+    """
+    output = []
+    n = 0
+    # The encoder can leave a dangling marker byte at the end, which the firmware never reads
+    while n + 1 < len(bytearray):
+        c = bytearray[n]
+        if c >= 128:
+            output.extend(bytearray[n + 1:n + 1 + c - 127])
+            n += 1 + c - 127
+        else:
+            output.extend([bytearray[n + 1]] * c)
+            n += 2
+    return output
+
+
+# Parameters of the LZ scheme, see quantum/painter/qp_internal_lz.h
+LZ_WINDOW_SIZE = 256
+LZ_MIN_MATCH = 3
+LZ_MAX_MATCH = 127 + LZ_MIN_MATCH
+LZ_MAX_LITERALS = 128
+
+
+class _LzMatcher:
+    """Finds the longest earlier copy of the data at a position, within the LZ window.
+    """
+    def __init__(self, data):
+        self.data = data
+        # Positions of each 3-byte prefix still within the window, oldest first
+        self.chains = {}
+
+    def _key(self, pos):
+        return tuple(self.data[pos:pos + LZ_MIN_MATCH])
+
+    def insert(self, pos):
+        if pos + LZ_MIN_MATCH <= len(self.data):
+            self.chains.setdefault(self._key(pos), deque()).append(pos)
+
+    def remove_last(self, pos):
+        self.chains[self._key(pos)].pop()
+
+    def longest_match(self, pos):
+        limit = min(LZ_MAX_MATCH, len(self.data) - pos)
+        chain = self.chains.get(self._key(pos)) if limit >= LZ_MIN_MATCH else None
+        if not chain:
+            return (0, 0)
+        while chain and pos - chain[0] > LZ_WINDOW_SIZE:
+            chain.popleft()
+        best_length, best_distance = 0, 0
+        for candidate in reversed(chain):
+            length = LZ_MIN_MATCH
+            while length < limit and self.data[candidate + length] == self.data[pos + length]:
+                length += 1
+            if length > best_length:
+                best_length, best_distance = length, pos - candidate
+                if length == limit:
+                    break
+        return (best_length, best_distance)
+
+
+def _append_lz_literals(output, literals):
+    for n in range(0, len(literals), LZ_MAX_LITERALS):
+        chunk = literals[n:n + LZ_MAX_LITERALS]
+        output.append(len(chunk) - 1)
+        output.extend(chunk)
+    literals.clear()
+
+
+def compress_bytes_qmk_lz(bytearray):
+    """Compresses using the QMK LZ scheme, which suits dithered or detailed images far better than RLE.
+
+    Marker bytes 0..127 are followed by that many plus one literal bytes. Marker bytes 128..255 describe a copy of
+    (marker - 128 + 3) bytes, followed by a byte holding (distance - 1) back into the last 256 decoded bytes. Copies may
+    overlap the bytes they produce, so a distance of 1 behaves like an RLE run.
+    """
+    data = list(bytearray)
+    matcher = _LzMatcher(data)
+    output = []
+    literals = []
+
+    pos = 0
+    while pos < len(data):
+        (length, distance) = matcher.longest_match(pos)
+
+        # Defer to a literal if the next position has a longer match
+        if length >= LZ_MIN_MATCH and length < LZ_MAX_MATCH:
+            matcher.insert(pos)
+            (next_length, _) = matcher.longest_match(pos + 1)
+            if next_length > length + 1:
+                literals.append(data[pos])
+                pos += 1
+                continue
+            matcher.remove_last(pos)
+
+        if length >= LZ_MIN_MATCH:
+            _append_lz_literals(output, literals)
+            output.append(128 + length - LZ_MIN_MATCH)
+            output.append(distance - 1)
+            for n in range(pos, pos + length):
+                matcher.insert(n)
+            pos += length
+        else:
+            literals.append(data[pos])
+            matcher.insert(pos)
+            pos += 1
+
+    _append_lz_literals(output, literals)
+    return output
+
+
+def decompress_bytes_qmk_lz(bytearray):
+    """Reverses compress_bytes_qmk_lz(), mirroring the decoder in quantum/painter/qp_internal_lz.h.
+    """
+    output = []
+    n = 0
+    while n < len(bytearray):
+        c = bytearray[n]
+        if c < 128:
+            output.extend(bytearray[n + 1:n + 2 + c])
+            n += 2 + c
+        else:
+            distance = bytearray[n + 1] + 1
+            for _ in range(c - 128 + LZ_MIN_MATCH):
+                output.append(output[-distance])
+            n += 2
+    return output
+
+
+def compress_bytes_smallest(bytearray, use_rle=True, use_lz=False):
+    """Returns whichever of the raw data and the requested compression schemes is smallest.
+
+    The result is a tuple of the compression scheme, matching painter_compression_t, and the data.
+    """
+    best = (IMAGE_UNCOMPRESSED, bytearray)
+    if use_rle:
+        rle_data = compress_bytes_qmk_rle(bytearray)
+        if len(rle_data) < len(best[1]):
+            best = (IMAGE_COMPRESSED_RLE, rle_data)
+    if use_lz:
+        lz_data = compress_bytes_qmk_lz(bytearray)
+        if len(lz_data) < len(best[1]):
+            best = (IMAGE_COMPRESSED_LZ, lz_data)
+    return best
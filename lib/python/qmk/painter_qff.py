@@ -51,7 +51,7 @@ class QFFFontDescriptor:
         self.header = QGFBlockHeader()
         self.header.type_id = QFFFontDescriptor.type_id
         self.header.length = QFFFontDescriptor.length
-        self.version = 1
+        self.version = 2  # v2 guarantees the unicode table is sorted by code point
         self.total_file_size = 0
         self.line_height = 0
         self.has_ascii_table = False
@@ -136,6 +136,7 @@ class QFFUnicodeGlyphTableV1:
         self.header.length = len(self.glyphs.keys()) * 6
         self.header.write(fp)
 
+        # QFF v2 requires ascending code point order, firmware binary searches this table
         for n in sorted(self.glyphs.keys()):
             self.glyphs[n].write(fp, True)
 
@@ -185,24 +186,30 @@ class QFFFont:
         self.glyph_height = 0
         return
 
-    def _extract_glyphs(self, format):
+    def _extract_glyphs(self, format, use_rle, use_lz):
         total_data_size = 0
         total_rle_data_size = 0
+        total_lz_data_size = 0
 
         converted_img = qmk.painter.convert_requested_format(self.image, format)
         (self.palette, _) = qmk.painter.convert_image_bytes(converted_img, format)
 
-        # Work out how many bytes used for RLE vs. non-RLE
+        # Work out how many bytes used for each compression scheme
         for _, glyph_entry in self.glyph_data.items():
             glyph_img = converted_img.crop((glyph_entry.x, 1, glyph_entry.x + glyph_entry.w, 1 + self.glyph_height))
             (_, this_glyph_image_bytes) = qmk.painter.convert_image_bytes(glyph_img, format)
-            this_glyph_rle_bytes = qmk.painter.compress_bytes_qmk_rle(this_glyph_image_bytes)
             total_data_size += len(this_glyph_image_bytes)
-            total_rle_data_size += len(this_glyph_rle_bytes)
             glyph_entry['image_uncompressed_bytes'] = this_glyph_image_bytes
-            glyph_entry['image_compressed_bytes'] = this_glyph_rle_bytes
+            if use_rle:
+                this_glyph_rle_bytes = qmk.painter.compress_bytes_qmk_rle(this_glyph_image_bytes)
+                total_rle_data_size += len(this_glyph_rle_bytes)
+                glyph_entry['image_rle_bytes'] = this_glyph_rle_bytes
+            if use_lz:
+                this_glyph_lz_bytes = qmk.painter.compress_bytes_qmk_lz(this_glyph_image_bytes)
+                total_lz_data_size += len(this_glyph_lz_bytes)
+                glyph_entry['image_lz_bytes'] = this_glyph_lz_bytes
 
-        return (total_data_size, total_rle_data_size)
+        return (total_data_size, total_rle_data_size, total_lz_data_size)
 
     def _parse_image(self, img, include_ascii_glyphs: bool = True, unicode_glyphs: str = ''):
         # Clear out any existing font metadata
@@ -325,23 +332,31 @@ class QFFFont:
         self._parse_image(Image.open(str(img_file)), include_ascii_glyphs, unicode_glyphs)
         return
 
-    def save_to_qff(self, format: Dict[str, Any], use_rle: bool, fp):
+    def save_to_qff(self, format: Dict[str, Any], use_rle: bool, fp, use_lz: bool = False):
         # Drop out if there's no image loaded
         if self.image is None:
             self.logger.error('No image is loaded.')
             return
 
-        # Work out if we want to use RLE at all, skipping it if it's not any smaller (it's applied per-glyph)
-        (total_data_size, total_rle_data_size) = self._extract_glyphs(format)
-        if use_rle:
-            use_rle = (total_rle_data_size < total_data_size)
+        # Work out which compression to use, skipping it if it's not any smaller (it's applied per-glyph)
+        (total_data_size, total_rle_data_size, total_lz_data_size) = self._extract_glyphs(format, use_rle, use_lz)
+        compression = qmk.painter.IMAGE_UNCOMPRESSED
+        if use_rle and total_rle_data_size < total_data_size:
+            compression = qmk.painter.IMAGE_COMPRESSED_RLE
+            total_data_size = total_rle_data_size
+        if use_lz and total_lz_data_size < total_data_size:
+            compression = qmk.painter.IMAGE_COMPRESSED_LZ
+        glyph_bytes_key = {
+            qmk.painter.IMAGE_UNCOMPRESSED: 'image_uncompressed_bytes',
+            qmk.painter.IMAGE_COMPRESSED_RLE: 'image_rle_bytes',
+            qmk.painter.IMAGE_COMPRESSED_LZ: 'image_lz_bytes',
+        }[compression]
 
         # For each glyph, work out which image data we want to use and append it to the image buffer, recording the byte-wise offset
         img_buffer = bytes()
         for _, glyph_entry in self.glyph_data.items():
             glyph_entry['data_offset'] = len(img_buffer)
-            glyph_img_bytes = glyph_entry.image_compressed_bytes if use_rle else glyph_entry.image_uncompressed_bytes
-            img_buffer += bytes(glyph_img_bytes)
+            img_buffer += bytes(glyph_entry[glyph_bytes_key])
 
         font_descriptor = QFFFontDescriptor()
         ascii_table = QFFAsciiGlyphTableV1()
@@ -365,7 +380,7 @@ class QFFFont:
         font_descriptor.unicode_glyph_count = len(unicode_table.glyphs.keys())
         font_descriptor.is_transparent = False
         font_descriptor.format = format['image_format_byte']
-        font_descriptor.compression = 0x01 if use_rle else 0x00
+        font_descriptor.compression = compression
 
         # Write a dummy font descriptor -- we'll have to come back and write it properly once we've rendered out everything else
         font_descriptor_location = fp.tell()
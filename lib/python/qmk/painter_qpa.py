@@ -0,0 +1,140 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Quantum Painter Asset "QPA" bundle format.
+# See https://docs.qmk.fm/#/quantum_painter_qpa for more information.
+
+import re
+from PIL._binary import o8, i16le as i16, i32le as i32, o16le as o16, o32le as o32
+from qmk.painter_qgf import o24, QGFBlockHeader
+
+# Asset types, see qpa.h, qpa_asset_type_t
+QPA_ASSET_IMAGE = 0x00
+QPA_ASSET_FONT = 0x01
+
+# Magic numbers of the asset formats, used to detect the type of each input file
+_asset_magics = {
+    b'QGF': QPA_ASSET_IMAGE,
+    b'QFF': QPA_ASSET_FONT,
+}
+
+########################################################################################################################
+
+
+class QPABundleDescriptor:
+    type_id = 0x10
+    length = 14
+    magic = 0x415051
+
+    def __init__(self):
+        self.header = QGFBlockHeader()
+        self.header.type_id = QPABundleDescriptor.type_id
+        self.header.length = QPABundleDescriptor.length
+        self.version = 1
+        self.total_file_size = 0
+        self.asset_count = 0
+
+    def write(self, fp):
+        self.header.write(fp)
+        fp.write(
+            b''  # start off with empty bytes...
+            + o24(QPABundleDescriptor.magic)  # magic
+            + o8(self.version)  # version
+            + o32(self.total_file_size)  # file size
+            + o32((~self.total_file_size) & 0xFFFFFFFF)  # negated file size
+            + o16(self.asset_count)  # asset count
+        )
+
+
+########################################################################################################################
+
+
+class QPAAssetTable:
+    type_id = 0x11
+    entry_size = 9
+
+    def __init__(self):
+        self.header = QGFBlockHeader()
+        self.header.type_id = QPAAssetTable.type_id
+        self.entries = []
+
+    def write(self, fp):
+        self.header.length = len(self.entries) * QPAAssetTable.entry_size
+        self.header.write(fp)
+        for entry in self.entries:
+            fp.write(b''  # start off with empty bytes...
+                     + o8(entry['type'])  # asset type
+                     + o32(entry['offset'])  # offset from the start of the bundle
+                     + o32(entry['length'])  # asset length
+                     )
+
+
+########################################################################################################################
+
+
+def asset_type(data):
+    """Works out whether the supplied raw asset is a QGF image or a QFF font, from the magic in its descriptor.
+    """
+    if len(data) < 8 or data[5:8] not in _asset_magics:
+        raise ValueError('Not a raw QGF or QFF file')
+    return _asset_magics[data[5:8]]
+
+
+def asset_sane_name(name):
+    """Turns an asset name into something usable as a C identifier.
+    """
+    return re.sub(r"[^a-zA-Z0-9]", "_", name).upper()
+
+
+def save_bundle(assets, fp, alignment=1):
+    """Writes a bundle of raw QGF/QFF assets to the supplied file, returning the table of what was written.
+
+    Each asset is a tuple of `(name, data)`. Assets are padded out to `alignment` bytes, such as the flash page size.
+    """
+    descriptor = QPABundleDescriptor()
+    table = QPAAssetTable()
+
+    offset = QGFBlockHeader.block_size + QPABundleDescriptor.length + QGFBlockHeader.block_size + len(assets) * QPAAssetTable.entry_size
+    padded = []
+    for name, data in assets:
+        offset += (-offset) % alignment
+        padded.append(offset)
+        table.entries.append({'name': name, 'type': asset_type(data), 'offset': offset, 'length': len(data)})
+        offset += len(data)
+
+    descriptor.asset_count = len(assets)
+    descriptor.total_file_size = offset
+
+    start = fp.tell()
+    descriptor.write(fp)
+    table.write(fp)
+    for (name, data), asset_offset in zip(assets, padded):
+        fp.write(b'\xFF' * (asset_offset - (fp.tell() - start)))  # erased flash is all ones
+        fp.write(data)
+
+    return table.entries
+
+
+def load_bundle(data):
+    """Parses a bundle, returning a list of `(type, data)` tuples for the assets it contains.
+    """
+    header_size = QGFBlockHeader.block_size
+    if data[0] != QPABundleDescriptor.type_id or data[5:8] != b'QPA' or data[8] != 1:
+        raise ValueError('Not a QPA bundle')
+
+    total_file_size = i32(data, 9)
+    if i32(data, 13) != (~total_file_size) & 0xFFFFFFFF or total_file_size > len(data):
+        raise ValueError('Invalid QPA bundle size')
+
+    asset_count = i16(data, 17)
+    table_start = header_size + QPABundleDescriptor.length
+    if data[table_start] != QPAAssetTable.type_id:
+        raise ValueError('Missing QPA asset table')
+
+    assets = []
+    for n in range(asset_count):
+        entry = table_start + header_size + n * QPAAssetTable.entry_size
+        offset = i32(data, entry + 1)
+        length = i32(data, entry + 5)
+        assets.append((data[entry], data[offset:offset + length]))
+    return assets
@@ -0,0 +1,51 @@
+"""Functions for RGB Matrix settings from info.json.
+"""
+
+
+def has_output_lut(info_data):
+    """Whether the keyboard gets an RGB Matrix output lookup table.
+
+    An empty `output` object still gets one, with the default gamma and white balance.
+    """
+    return 'output' in info_data.get('rgb_matrix', {})
+
+
+def output_lut(info_data):
+    """Returns the per-channel output lookup table as three lists of 256 values, or None if the keyboard has none.
+    """
+    if not has_output_lut(info_data):
+        return None
+
+    output = info_data['rgb_matrix']['output']
+    gamma = output.get('gamma', 1.0)
+    white_balance = output.get('white_balance', [255, 255, 255])
+
+    return [[round(((value / 255)**gamma) * channel) for value in range(256)] for channel in white_balance]
+
+
+def generate_output_lut(info_data):
+    """Returns the lines of C defining g_rgb_matrix_output_lut, if the keyboard has an output lookup table.
+    """
+    lut = output_lut(info_data)
+
+    lines = []
+    if lut is None:
+        return lines
+
+    output = info_data['rgb_matrix']['output']
+    gamma = output.get('gamma', 1.0)
+    white_balance = output.get('white_balance', [255, 255, 255])
+
+    lines.append('#ifdef RGB_MATRIX_ENABLE')
+    lines.append('#include "rgb_matrix.h"')
+    lines.append(f'// gamma: {gamma}, white balance: {white_balance}')
+    lines.append('const uint8_t PROGMEM g_rgb_matrix_output_lut[3][256] = {')
+    for values in lut:
+        lines.append('  {')
+        for pos in range(0, 256, 16):
+            lines.append(f'    {", ".join(str(v) for v in values[pos:pos + 16])},')
+        lines.append('  },')
+    lines.append('};')
+    lines.append('#endif')
+
+    return lines
@@ -0,0 +1,60 @@
+from qmk.host_stream import COMMAND_ID, OP_COMMIT, OP_DATA, RECORD_RUN, REPORT_SIZE, encode_frame
+
+
+def _apply(reports, frame):
+    """Decodes DATA reports the same way quantum/rgb_matrix/animations/host_stream_anim.h does.
+    """
+    frame = list(frame)
+    for report in reports:
+        assert len(report) == REPORT_SIZE
+        assert report[0] == COMMAND_ID
+        if report[1] != OP_DATA:
+            continue
+        i = 3
+        while i + 2 <= len(report):
+            start, count, run = report[i], report[i + 1] & ~RECORD_RUN, report[i + 1] & RECORD_RUN
+            i += 2
+            if count == 0:
+                break
+            if run:
+                frame[start:start + count] = [tuple(report[i:i + 3])] * count
+                i += 3
+            else:
+                for j in range(count):
+                    frame[start + j] = tuple(report[i:i + 3])
+                    i += 3
+    return frame
+
+
+def test_encode_full_frame():
+    frame = [(i, 255 - i, i * 2 % 256) for i in range(100)]
+    reports = encode_frame(7, frame)
+    assert reports[-1][:3] == bytes([COMMAND_ID, OP_COMMIT, 7])
+    # 9 LEDs fit in each report, plus the commit
+    assert len(reports) == 13
+    assert _apply(reports, [(0, 0, 0)] * 100) == frame
+
+
+def test_encode_runs():
+    frame = [(255, 0, 0)] * 50 + [(0, 0, 255)] * 50
+    reports = encode_frame(1, frame)
+    assert len(reports) == 2
+    assert _apply(reports, [(0, 0, 0)] * 100) == frame
+
+
+def test_encode_delta_frame():
+    previous = [(i, i, i) for i in range(100)]
+    frame = list(previous)
+    frame[3] = (1, 2, 3)
+    frame[60:64] = [(9, 9, 9)] * 4
+    frame[99] = (4, 5, 6)
+    reports = encode_frame(2, frame, previous)
+    assert len(reports) == 2
+    assert _apply(reports, previous) == frame
+
+
+def test_encode_unchanged_frame():
+    frame = [(1, 1, 1)] * 10
+    reports = encode_frame(3, frame, frame)
+    assert [report[1] for report in reports] == [OP_DATA, OP_COMMIT]
+    assert _apply(reports, frame) == frame
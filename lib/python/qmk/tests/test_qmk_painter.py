@@ -0,0 +1,112 @@
+import random
+import re
+from io import BytesIO
+
+from qmk.constants import QMK_FIRMWARE
+from qmk.painter import IMAGE_COMPRESSED_LZ, IMAGE_COMPRESSED_RLE, IMAGE_UNCOMPRESSED, compress_bytes_qmk_lz, compress_bytes_qmk_rle, compress_bytes_smallest, decompress_bytes_qmk_lz, decompress_bytes_qmk_rle
+from qmk.painter_qpa import QPA_ASSET_FONT, QPA_ASSET_IMAGE, load_bundle, save_bundle
+
+
+def _sample_data():
+    rng = random.Random(1234)
+    yield [0x55] * 1000
+    yield [rng.randrange(256) for _ in range(1000)]
+    yield [rng.randrange(4) for _ in range(1000)]
+    yield [(0xAA if (n // 37) % 2 else 0x55) for n in range(1000)]
+    yield ([rng.randrange(256) for _ in range(200)] * 5)[:900]
+    yield [n % 251 for n in range(3000)]
+
+
+def _converted_asset(source):
+    """Returns the raw bytes of an image or font already converted to a C source file.
+    """
+    text = source.read_text()
+    return bytes(int(b, 16) for b in re.findall(r'0x([0-9A-Fa-f]{2})', text[text.index('= {'):]))
+
+
+def _qgf_frames(data):
+    """Yields the uncompressed pixel data of each frame in a QGF file.
+    """
+    pos = 0
+    compression = IMAGE_UNCOMPRESSED
+    while pos < len(data):
+        type_id = data[pos]
+        length = data[pos + 2] | data[pos + 3] << 8 | data[pos + 4] << 16
+        block = data[pos + 5:pos + 5 + length]
+        if type_id == 0x02:
+            compression = block[2]
+        elif type_id == 0x05:
+            yield list(block) if compression == IMAGE_UNCOMPRESSED else decompress_bytes_qmk_rle(list(block))
+        pos += 5 + length
+
+
+def test_rle_roundtrip():
+    for data in _sample_data():
+        assert decompress_bytes_qmk_rle(compress_bytes_qmk_rle(data)) == data
+
+
+def test_lz_roundtrip():
+    for data in _sample_data():
+        compressed = compress_bytes_qmk_lz(data)
+        assert all(0 <= c <= 255 for c in compressed)
+        assert decompress_bytes_qmk_lz(compressed) == data
+
+
+def test_lz_known_encoding():
+    # These vectors are also decoded by quantum/painter/tests/qp_lz_tests.cpp
+    assert compress_bytes_qmk_lz([1, 2, 3, 1, 2, 3, 1, 2, 3, 4]) == [2, 1, 2, 3, 131, 2, 0, 4]
+    assert compress_bytes_qmk_lz([7] * 10) == [0, 7, 134, 0]
+
+
+def test_lz_beats_rle_on_dither():
+    data = [(0xAA if (n // 37) % 2 else 0x55) ^ (n % 3) for n in range(2000)]
+    assert len(compress_bytes_qmk_lz(data)) < len(compress_bytes_qmk_rle(data)) / 4
+
+
+def test_compress_bytes_smallest():
+    rng = random.Random(1)
+    noise = [rng.randrange(256) for _ in range(100)]
+    assert compress_bytes_smallest(noise, True, True) == (IMAGE_UNCOMPRESSED, noise)
+    assert compress_bytes_smallest([1] * 100, True, False)[0] == IMAGE_COMPRESSED_RLE
+    assert compress_bytes_smallest([1, 2, 3, 4] * 100, True, True)[0] == IMAGE_COMPRESSED_LZ
+    assert compress_bytes_smallest([1, 2, 3, 4] * 100, False, False) == (IMAGE_UNCOMPRESSED, [1, 2, 3, 4] * 100)
+
+
+def test_lz_size_on_converted_images():
+    """Compares RLE against LZ on the images already converted for keyboards in the repository.
+    """
+    sources = sorted((QMK_FIRMWARE / 'keyboards').glob('**/*.qgf.c'))
+    assert sources
+
+    rle_size = lz_size = 0
+    for source in sources:
+        for frame in _qgf_frames(_converted_asset(source)):
+            lz = compress_bytes_qmk_lz(frame)
+            assert decompress_bytes_qmk_lz(lz) == frame
+            rle_size += min(len(frame), len(compress_bytes_qmk_rle(frame)))
+            lz_size += min(len(frame), len(lz))
+
+    assert lz_size <= rle_size
+
+
+def test_qpa_bundle_roundtrip():
+    sources = sorted((QMK_FIRMWARE / 'keyboards/tzarc/ghoul/graphics').glob('*.q[gf]f.c'))
+    assert sources
+    assets = [(source.name.split('.')[0], _converted_asset(source)) for source in sources]
+
+    for alignment in (1, 256):
+        fp = BytesIO()
+        entries = save_bundle(assets, fp, alignment)
+        bundle = fp.getvalue()
+
+        assert len(bundle) == entries[-1]['offset'] + entries[-1]['length']
+        assert all(entry['offset'] % alignment == 0 for entry in entries)
+        assert load_bundle(bundle) == [(QPA_ASSET_FONT if source.name.endswith('.qff.c') else QPA_ASSET_IMAGE, data) for source, (_, data) in zip(sources, assets)]
+
+
+def test_qpa_rejects_unknown_assets():
+    try:
+        save_bundle([('junk', b'\x00' * 32)], BytesIO())
+    except ValueError:
+        return
+    assert False, 'Packing a non-QGF/QFF asset should fail'
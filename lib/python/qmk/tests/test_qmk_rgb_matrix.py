@@ -0,0 +1,32 @@
+from qmk.rgb_matrix import generate_output_lut, has_output_lut, output_lut
+
+
+def test_no_output_lut():
+    for info_data in ({}, {'rgb_matrix': {}}):
+        assert not has_output_lut(info_data)
+        assert output_lut(info_data) is None
+        assert generate_output_lut(info_data) == []
+
+
+def test_empty_output_lut():
+    # info_config.h defines RGB_MATRIX_OUTPUT_LUT whenever there's an output object, so an empty one still needs the table
+    info_data = {'rgb_matrix': {'output': {}}}
+    assert has_output_lut(info_data)
+    assert output_lut(info_data) == [list(range(256))] * 3
+
+    lines = generate_output_lut(info_data)
+    assert 'const uint8_t PROGMEM g_rgb_matrix_output_lut[3][256] = {' in lines
+
+
+def test_output_lut():
+    info_data = {'rgb_matrix': {'output': {'gamma': 2.0, 'white_balance': [255, 128, 0]}}}
+    assert has_output_lut(info_data)
+
+    red, green, blue = output_lut(info_data)
+    assert red[0] == 0 and red[128] == 64 and red[255] == 255
+    assert green[255] == 128
+    assert blue == [0] * 256
+
+    lines = generate_output_lut(info_data)
+    assert 'const uint8_t PROGMEM g_rgb_matrix_output_lut[3][256] = {' in lines
+    assert sum(1 for line in lines if line == '  {') == 3
@@ -30,6 +30,29 @@ uint32_t timer_elapsed32(uint32_t tlast) {
     return TIMER_DIFF_32(timer_read32(), tlast);
 }
 
+// TC4 counts microseconds from the 1MHz timebase and wraps every millisecond, raising the interrupt that advances ms_clk
+uint32_t timer_read_us(void) {
+    uint32_t irqflags = __get_PRIMASK();
+    __disable_irq();
+
+    TC4->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
+    while (TC4->COUNT16.SYNCBUSY.bit.CTRLB || TC4->COUNT16.CTRLBSET.bit.CMD) {
+    }
+    uint32_t us = TC4->COUNT16.COUNT.reg;
+    uint64_t ms = ms_clk;
+    // The counter has wrapped but its interrupt is held off, so ms_clk is a millisecond behind
+    if (TC4->COUNT16.INTFLAG.bit.MC0 && us < 500) {
+        ms++;
+    }
+
+    __set_PRIMASK(irqflags);
+    return (uint32_t)(ms * 1000 + us);
+}
+
+uint32_t timer_elapsed_us(uint32_t tlast) {
+    return TIMER_DIFF_32(timer_read_us(), tlast);
+}
+
 void timer_clear(void) {
     set_time(0);
 }
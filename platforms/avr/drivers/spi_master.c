@@ -151,6 +151,15 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    // No DMA available, so the transfer is complete on return
+    return spi_transmit(data, length);
+}
+
+spi_status_t spi_async_wait(void) {
+    return SPI_STATUS_SUCCESS;
+}
+
 spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     spi_status_t status;
 
@@ -178,3 +187,8 @@ void spi_stop(void) {
         currentSlave2X     = false;
     }
 }
+
+void spi_stop_async(void) {
+    // Transfers are always complete on AVR, so the device can be released straight away
+    spi_stop();
+}
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <avr/interrupt.h>
 #include <util/atomic.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "timer_avr.h"
 #include "timer.h"
 
@@ -134,6 +135,43 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+/** \brief timer read in microseconds
+ *
+ * Combines the millisecond count with the current Timer0 value. Wraps modulo 2**32.
+ */
+uint32_t timer_read_us(void) {
+    uint32_t t;
+    uint8_t  raw;
+    bool     pending;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t   = timer_count;
+        raw = TIMER_RAW;
+#if defined(__AVR_ATmega32A__)
+        pending = TIFR & _BV(OCF0);
+#elif defined(__AVR_ATtiny85__)
+        pending = TIFR & _BV(OCF0A);
+#else
+        pending = TIFR0 & _BV(OCF0A);
+#endif
+    }
+
+    // the compare match fired but the ISR has not run yet, so the counter already restarted
+    if (pending && raw < TIMER_RAW_TOP / 2) {
+        t++;
+    }
+
+    return t * 1000 + ((uint32_t)raw * 1000) / (TIMER_RAW_TOP + 1);
+}
+
+/** \brief timer elapsed in microseconds
+ *
+ * Time since `last`, a value previously returned by timer_read_us().
+ */
+uint32_t timer_elapsed_us(uint32_t last) {
+    return TIMER_DIFF_32(timer_read_us(), last);
+}
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
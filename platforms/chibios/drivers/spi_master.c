@@ -26,6 +26,21 @@ static SPIConfig spiConfig = {NULL, 0, 0, 0};
 static SPIConfig spiConfig = {false, NULL, 0, 0, 0, 0};
 #endif
 
+static volatile bool      asyncPending     = false;
+static bool               asyncStopPending = false;
+static thread_reference_t asyncThread      = NULL;
+
+static void spi_async_complete(SPIDriver *spip) {
+    osalSysLockFromISR();
+    if (asyncStopPending) {
+        // Deselect the device as soon as the transfer ends, the driver itself is stopped by the next spi_start()
+        spiUnselectI(spip);
+    }
+    asyncPending = false;
+    osalThreadResumeI(&asyncThread, MSG_OK);
+    osalSysUnlockFromISR();
+}
+
 __attribute__((weak)) void spi_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -52,6 +67,11 @@ __attribute__((weak)) void spi_init(void) {
 }
 
 bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    // Finish releasing a device left selected by spi_stop_async()
+    if (asyncStopPending) {
+        spi_stop();
+    }
+
     if (currentSlavePin != NO_PIN || slavePin == NO_PIN) {
         return false;
     }
@@ -251,6 +271,12 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     spiConfig.ssport = PAL_PORT(slavePin);
     spiConfig.sspad  = PAL_PAD(slavePin);
 
+#if defined(HAL_LLD_SELECT_SPI_V2)
+    spiConfig.data_cb = spi_async_complete;
+#else
+    spiConfig.end_cb = spi_async_complete;
+#endif
+
     setPinOutput(slavePin);
     spiStart(&SPI_DRIVER, &spiConfig);
     spiSelect(&SPI_DRIVER);
@@ -260,6 +286,9 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
 
 spi_status_t spi_write(uint8_t data) {
     uint8_t rxData;
+    if (spi_async_wait() != SPI_STATUS_SUCCESS) {
+        return SPI_STATUS_TIMEOUT;
+    }
     spiExchange(&SPI_DRIVER, 1, &data, &rxData);
 
     return rxData;
@@ -267,25 +296,91 @@ spi_status_t spi_write(uint8_t data) {
 
 spi_status_t spi_read(void) {
     uint8_t data = 0;
+    if (spi_async_wait() != SPI_STATUS_SUCCESS) {
+        return SPI_STATUS_TIMEOUT;
+    }
     spiReceive(&SPI_DRIVER, 1, &data);
 
     return data;
 }
 
 spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    if (spi_async_wait() != SPI_STATUS_SUCCESS) {
+        return SPI_STATUS_TIMEOUT;
+    }
     spiSend(&SPI_DRIVER, length, data);
     return SPI_STATUS_SUCCESS;
 }
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    // Only one transfer can be in progress at a time
+    if (spi_async_wait() != SPI_STATUS_SUCCESS) {
+        return SPI_STATUS_TIMEOUT;
+    }
+    asyncPending = true;
+    spiStartSend(&SPI_DRIVER, length, data);
+    return SPI_STATUS_SUCCESS;
+}
+
+// Stops a transfer which didn't finish in time, leaving the driver ready for the next one. call with the system locked
+static void spi_async_abort_S(void) {
+#if defined(HAL_LLD_SELECT_SPI_V2)
+    spiStopTransferI(&SPI_DRIVER, NULL);
+#elif SPI_SUPPORTS_CIRCULAR == TRUE
+    spiAbortI(&SPI_DRIVER);
+#else
+    // There's no abort without circular support, restarting the peripheral stops its DMA streams
+    spi_lld_stop(&SPI_DRIVER);
+    spi_lld_start(&SPI_DRIVER);
+    SPI_DRIVER.state = SPI_READY;
+#endif
+}
+
+spi_status_t spi_async_wait(void) {
+    msg_t msg = MSG_OK;
+    osalSysLock();
+    if (asyncPending) {
+        msg = osalThreadSuspendTimeoutS(&asyncThread, TIME_MS2I(SPI_ASYNC_TIMEOUT));
+        if (msg == MSG_TIMEOUT) {
+            // Give up on the transfer rather than blocking every later SPI call, the DMA has to be stopped first
+            spi_async_abort_S();
+            if (asyncStopPending) {
+                spiUnselectI(&SPI_DRIVER);
+            }
+            asyncPending = false;
+        }
+    }
+    osalSysUnlock();
+    return msg == MSG_TIMEOUT ? SPI_STATUS_TIMEOUT : SPI_STATUS_SUCCESS;
+}
+
 spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    if (spi_async_wait() != SPI_STATUS_SUCCESS) {
+        return SPI_STATUS_TIMEOUT;
+    }
     spiReceive(&SPI_DRIVER, length, data);
     return SPI_STATUS_SUCCESS;
 }
 
 void spi_stop(void) {
     if (currentSlavePin != NO_PIN) {
+        spi_async_wait();
         spiUnselect(&SPI_DRIVER);
         spiStop(&SPI_DRIVER);
-        currentSlavePin = NO_PIN;
+        currentSlavePin  = NO_PIN;
+        asyncStopPending = false;
+    }
+}
+
+void spi_stop_async(void) {
+    // Checked under the lock so a transfer ending in between can't miss the deselect
+    osalSysLock();
+    if (asyncPending) {
+        // The transfer is still running; its completion deselects the device and the next spi_start() releases the driver
+        asyncStopPending = true;
+        osalSysUnlock();
+        return;
     }
+    osalSysUnlock();
+    spi_stop();
 }
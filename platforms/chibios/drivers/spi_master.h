@@ -63,6 +63,10 @@
 #    endif
 #endif
 
+#ifndef SPI_ASYNC_TIMEOUT
+#    define SPI_ASYNC_TIMEOUT 100
+#endif
+
 typedef int16_t spi_status_t;
 
 #define SPI_STATUS_SUCCESS (0)
@@ -85,9 +89,15 @@ spi_status_t spi_read(void);
 
 spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length);
+
+spi_status_t spi_async_wait(void);
+
 spi_status_t spi_receive(uint8_t *data, uint16_t length);
 
 void spi_stop(void);
+
+void spi_stop_async(void);
 #ifdef __cplusplus
 }
 #endif
@@ -1,7 +1,9 @@
+#include <string.h>
 #include "ws2812.h"
 #include "gpio.h"
 #include "util.h"
 #include "chibios_config.h"
+#include "ws2812_spi_encode.h"
 
 /* Adapted from https://github.com/gamazeps/ws2812b-chibios-SPIDMA/ */
 
@@ -63,79 +65,119 @@
 #endif
 
 // Use SPI circular buffer
-#ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
+#if defined(WS2812_SPI_USE_CIRCULAR_BUFFER) || defined(WS2812_SPI_USE_STREAMING)
 #    define WS2812_SPI_BUFFER_MODE 1 // circular buffer
 #else
 #    define WS2812_SPI_BUFFER_MODE 0 // normal buffer
 #endif
 
+#ifdef WS2812_SPI_USE_STREAMING
+#    if !defined(HAL_LLD_SELECT_SPI_V2) || SPI_SUPPORTS_CIRCULAR != TRUE
+#        error "WS2812_SPI_USE_STREAMING requires the SPI v2 driver with circular buffer support"
+#    endif
+#    if defined(WS2812_SPI_USE_CIRCULAR_BUFFER)
+#        error "WS2812_SPI_USE_STREAMING and WS2812_SPI_USE_CIRCULAR_BUFFER are mutually exclusive"
+#    endif
+#    ifndef WS2812_SPI_STREAM_LEDS
+#        define WS2812_SPI_STREAM_LEDS 4 // LEDs encoded per half of the circular buffer
+#    endif
+#    define WS2812_SPI_DATA_CB ws2812_stream_cb
+#else
+#    define WS2812_SPI_DATA_CB NULL
+#endif
+
 #if defined(USE_GPIOV1)
 #    define WS2812_SCK_OUTPUT_MODE PAL_MODE_ALTERNATE_PUSHPULL
 #else
 #    define WS2812_SCK_OUTPUT_MODE PAL_MODE_ALTERNATE(WS2812_SPI_SCK_PAL_MODE) | PAL_OUTPUT_TYPE_PUSHPULL
 #endif
 
-#define BYTES_FOR_LED_BYTE 4
-#ifdef RGBW
-#    define WS2812_CHANNELS 4
-#else
-#    define WS2812_CHANNELS 3
-#endif
-#define BYTES_FOR_LED (BYTES_FOR_LED_BYTE * WS2812_CHANNELS)
+#define BYTES_FOR_LED_BYTE WS2812_SPI_BYTES_PER_CHANNEL
+#define WS2812_CHANNELS WS2812_SPI_CHANNELS
+#define BYTES_FOR_LED WS2812_SPI_BYTES_PER_LED
 #define DATA_SIZE (BYTES_FOR_LED * WS2812_LED_COUNT)
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
-
+#ifdef WS2812_SPI_USE_STREAMING
 /*
- * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
- * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
+ * The frame is encoded on the fly from the caller's LED array into a small circular buffer, one half
+ * at a time from the DMA half/full transfer callback, so RAM use does not depend on the LED count.
+ * The virtual bitstream is made of BYTES_FOR_LED_BYTE sized slots: the preamble, one slot per color
+ * byte, then enough zero slots to cover the reset time.
  */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
+#    define STREAM_HALF_SIZE (BYTES_FOR_LED * WS2812_SPI_STREAM_LEDS)
+#    define STREAM_PREAMBLE_SLOTS (PREAMBLE_SIZE / BYTES_FOR_LED_BYTE)
+#    define STREAM_RESET_SLOTS ((RESET_SIZE + BYTES_FOR_LED_BYTE - 1) / BYTES_FOR_LED_BYTE)
+
+static uint8_t txbuf[2 * STREAM_HALF_SIZE] = {0};
+
+static LED_TYPE*     stream_leds;
+static uint16_t      stream_led;
+static uint8_t       stream_channel;
+static uint32_t      stream_slot;
+static uint32_t      stream_total;
+static bool          stream_padded;
+static volatile bool stream_busy = false;
+// frame latched while another one was being sent, started by the callback once that one is out
+static LED_TYPE* stream_next_leds = NULL;
+static uint16_t  stream_next_count;
+
+static void stream_begin(LED_TYPE* leds, uint16_t count) {
+    stream_leds    = leds;
+    stream_led     = 0;
+    stream_channel = 0;
+    stream_slot    = 0;
+    stream_total   = STREAM_PREAMBLE_SLOTS + (uint32_t)count * WS2812_CHANNELS + STREAM_RESET_SLOTS;
+    stream_padded  = false;
+}
+
+static void stream_fill(uint8_t* half) {
+    for (uint8_t* out = half; out < half + STREAM_HALF_SIZE; out += BYTES_FOR_LED_BYTE) {
+        if (stream_slot >= STREAM_PREAMBLE_SLOTS && stream_slot < stream_total - STREAM_RESET_SLOTS) {
+            ws2812_spi_encode_byte(ws2812_spi_channel(&stream_leds[stream_led], stream_channel), out);
+            if (++stream_channel == WS2812_CHANNELS) {
+                stream_channel = 0;
+                stream_led++;
+            }
+        } else {
+            memset(out, 0, BYTES_FOR_LED_BYTE);
+        }
+        stream_slot++;
+    }
+}
+
+static void ws2812_stream_cb(SPIDriver* spip) {
+    // the half that just finished is free, the other one is being sent
+    uint8_t* half = spiIsBufferComplete(spip) ? &txbuf[STREAM_HALF_SIZE] : &txbuf[0];
+
+    if (stream_slot >= stream_total) {
+        // the tail went out in the half that just finished, nothing left to send
+        if (stream_padded) {
+            chSysLockFromISR();
+            if (stream_next_leds == NULL) {
+                spiStopTransferI(spip, NULL);
+                stream_busy = false;
+                chSysUnlockFromISR();
+                return;
+            }
+            // the half being sent is padding, so the latched frame can follow on without stopping
+            stream_begin(stream_next_leds, stream_next_count);
+            stream_next_leds = NULL;
+            chSysUnlockFromISR();
+        } else {
+            stream_padded = true;
+        }
+    }
+    stream_fill(half);
 }
+#else
+static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
 
 static void set_led_color_rgb(LED_TYPE color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
-
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.b, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.r, j);
-#endif
-#ifdef RGBW
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 4 + j] = get_protocol_eq(color.w, j);
-#endif
+    ws2812_spi_encode_led(&color, &txbuf[PREAMBLE_SIZE + BYTES_FOR_LED * pos]);
 }
+#endif
 
 void ws2812_init(void) {
     palSetLineMode(WS2812_DI_PIN, WS2812_MOSI_OUTPUT_MODE);
@@ -170,8 +212,8 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_SLAVE_MODE == TRUE
         false,
 #    endif
-        NULL, // data_cb
-        NULL, // error_cb
+        WS2812_SPI_DATA_CB, // data_cb
+        NULL,               // error_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
         WS2812_SPI_DIVISOR_CR1_BR_X,
@@ -194,17 +236,36 @@ void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
         s_init = true;
     }
 
+#ifdef WS2812_SPI_USE_STREAMING
+    chSysLock();
+    if (stream_busy) {
+        // don't wait for the previous frame, only the latest one is kept and sent as soon as it is out
+        stream_next_leds  = ledarray;
+        stream_next_count = leds;
+        chSysUnlock();
+        return;
+    }
+    chSysUnlock();
+
+    stream_begin(ledarray, leds);
+    stream_fill(&txbuf[0]);
+    stream_fill(&txbuf[STREAM_HALF_SIZE]);
+
+    stream_busy = true;
+    spiStartSend(&WS2812_SPI, ARRAY_SIZE(txbuf), txbuf);
+#else
     for (uint8_t i = 0; i < leds; i++) {
         set_led_color_rgb(ledarray[i], i);
     }
 
     // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
     // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
-#    ifdef WS2812_SPI_SYNC
+#    ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
+#        ifdef WS2812_SPI_SYNC
     spiSend(&WS2812_SPI, ARRAY_SIZE(txbuf), txbuf);
-#    else
+#        else
     spiStartSend(&WS2812_SPI, ARRAY_SIZE(txbuf), txbuf);
+#        endif
 #    endif
 #endif
 }
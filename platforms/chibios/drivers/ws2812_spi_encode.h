@@ -0,0 +1,70 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "color.h"
+
+/*
+ * The SPI peripheral is clocked at roughly 4x the WS2812 bit rate, so every WS2812 bit is sent as one
+ * SPI nibble: 0b1110 for a 1 and 0b1000 for a 0. Each color byte therefore expands to 4 SPI bytes,
+ * two WS2812 bits per SPI byte, most significant first.
+ */
+#define WS2812_SPI_BYTES_PER_CHANNEL 4
+#ifdef RGBW
+#    define WS2812_SPI_CHANNELS 4
+#else
+#    define WS2812_SPI_CHANNELS 3
+#endif
+#define WS2812_SPI_BYTES_PER_LED (WS2812_SPI_BYTES_PER_CHANNEL * WS2812_SPI_CHANNELS)
+
+static inline void ws2812_spi_encode_byte(uint8_t data, uint8_t *out) {
+    static const uint8_t bit_pairs[4] = {0x88, 0x8E, 0xE8, 0xEE};
+
+    out[0] = bit_pairs[(data >> 6) & 0x03];
+    out[1] = bit_pairs[(data >> 4) & 0x03];
+    out[2] = bit_pairs[(data >> 2) & 0x03];
+    out[3] = bit_pairs[data & 0x03];
+}
+
+/* Returns the color byte sent in position `channel` of an LED frame, according to WS2812_BYTE_ORDER. */
+static inline uint8_t ws2812_spi_channel(const LED_TYPE *color, uint8_t channel) {
+    switch (channel) {
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+        case 0:
+            return color->g;
+        case 1:
+            return color->r;
+        case 2:
+            return color->b;
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+        case 0:
+            return color->r;
+        case 1:
+            return color->g;
+        case 2:
+            return color->b;
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+        case 0:
+            return color->b;
+        case 1:
+            return color->g;
+        case 2:
+            return color->r;
+#endif
+#ifdef RGBW
+        case 3:
+            return color->w;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/* Encodes a whole LED into WS2812_SPI_BYTES_PER_LED bytes at `out`. */
+static inline void ws2812_spi_encode_led(const LED_TYPE *color, uint8_t *out) {
+    for (uint8_t channel = 0; channel < WS2812_SPI_CHANNELS; channel++) {
+        ws2812_spi_encode_byte(ws2812_spi_channel(color, channel), &out[channel * WS2812_SPI_BYTES_PER_CHANNEL]);
+    }
+}
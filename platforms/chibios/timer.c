@@ -5,6 +5,10 @@
 static uint32_t ticks_offset = 0;
 static uint32_t last_ticks   = 0;
 static uint32_t ms_offset    = 0;
+// The microsecond clock keeps its own base, which timer_read32() never moves
+static uint32_t us_last_ticks = 0;
+static uint32_t us_count      = 0;
+static uint32_t us_remainder  = 0;
 #if CH_CFG_ST_RESOLUTION < 32
 static uint32_t last_systime = 0;
 static uint32_t overflow     = 0;
@@ -67,9 +71,12 @@ void timer_init(void) {
 
 void timer_clear(void) {
     chSysLock();
-    ticks_offset = get_system_time_ticks();
-    last_ticks   = 0;
-    ms_offset    = 0;
+    ticks_offset  = get_system_time_ticks();
+    last_ticks    = 0;
+    ms_offset     = 0;
+    us_last_ticks = ticks_offset;
+    us_count      = 0;
+    us_remainder  = 0;
     chSysUnlock();
 }
 
@@ -105,3 +112,29 @@ uint16_t timer_elapsed(uint16_t last) {
 uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(timer_read32(), last);
 }
+
+// Resolution is limited by CH_CFG_ST_FREQUENCY.  The ticks since the previous call are converted and added to a
+// running count, so the value wraps modulo 2**32 microseconds, which is what TIMER_DIFF_32() expects when computing
+// elapsed time.  Like timer_read32(), this must be called at least once for every 2**32 ticks.
+uint32_t timer_read_us(void) {
+    chSysLock();
+    uint32_t ticks = get_system_time_ticks();
+    uint32_t delta = ticks - us_last_ticks;
+    us_last_ticks  = ticks;
+#if (1000000 % CH_CFG_ST_FREQUENCY) == 0
+    us_count += delta * (1000000 / CH_CFG_ST_FREQUENCY);
+#else
+    // carry the fraction of a microsecond, so the count doesn't drift from the tick counter
+    uint64_t scaled = (uint64_t)delta * 1000000 + us_remainder;
+    us_count += (uint32_t)(scaled / CH_CFG_ST_FREQUENCY);
+    us_remainder = (uint32_t)(scaled % CH_CFG_ST_FREQUENCY);
+#endif
+    uint32_t us = us_count;
+    chSysUnlock();
+
+    return us;
+}
+
+uint32_t timer_elapsed_us(uint32_t last) {
+    return TIMER_DIFF_32(timer_read_us(), last);
+}
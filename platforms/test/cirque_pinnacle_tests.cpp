@@ -0,0 +1,388 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "host.h"
+#include "pointing_device.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+extern const pointing_device_driver_t pointing_device_driver;
+}
+
+// A recorded absolute mode sample, as the trackpad reports it before scaling
+struct sample {
+    uint32_t time;
+    uint16_t x;
+    uint16_t y;
+    uint8_t  z;
+};
+
+// Packets the trackpad has ready, the front one is flagged in STATUS1 until the flags are cleared
+static std::deque<std::vector<uint8_t>> packets;
+static int                              packet_reads;
+
+extern "C" void RAP_ReadBytes(uint8_t address, uint8_t *data, uint8_t count) {
+    memset(data, 0, count);
+    if (address == HOSTREG__STATUS1) {
+        data[0] = packets.empty() ? 0 : HOSTREG__STATUS1__DATA_READY;
+    } else if (address == HOSTREG__PACKETBYTE_0 && !packets.empty()) {
+        memcpy(data, packets.front().data(), count);
+        packet_reads++;
+    }
+}
+
+extern "C" void spi_init(void) {}
+
+extern "C" void RAP_Write(uint8_t address, uint8_t data) {
+    if (address == HOSTREG__STATUS1 && !(data & HOSTREG__STATUS1__DATA_READY) && !packets.empty()) {
+        packets.pop_front();
+    }
+}
+
+// Reports sent to the host by pointing_device_task()
+static std::vector<report_mouse_t> sent_reports;
+
+extern "C" bool has_mouse_report_changed(report_mouse_t *new_report, report_mouse_t *old_report) {
+    return new_report->buttons != old_report->buttons || new_report->x != 0 || new_report->y != 0 || new_report->h != 0 || new_report->v != 0;
+}
+
+static uint8_t mock_keyboard_leds(void) {
+    return 0;
+}
+
+static void mock_send_keyboard(report_keyboard_t *report) {}
+
+static void mock_send_mouse(report_mouse_t *report) {
+    sent_reports.push_back(*report);
+}
+
+static void mock_send_extra(report_extra_t *report) {}
+
+static host_driver_t mock_host_driver = {mock_keyboard_leds, mock_send_keyboard, mock_send_mouse, mock_send_extra};
+
+static void queue_packet(uint16_t x, uint16_t y, uint8_t z) {
+    packets.push_back({0, 0, (uint8_t)x, (uint8_t)y, (uint8_t)(((x >> 8) & 0x0F) | ((y >> 8) << 4)), z});
+}
+
+// Point on a circle around the centre of the trackpad, radius given as a percentage of the reachable range
+static sample circle_point(uint32_t time, double angle, double radius_pct) {
+    double r = radius_pct / 200.0;
+    return {time, (uint16_t)(CIRQUE_PINNACLE_X_LOWER + CIRQUE_PINNACLE_X_RANGE * (0.5 + r * cos(angle))), (uint16_t)(CIRQUE_PINNACLE_Y_LOWER + CIRQUE_PINNACLE_Y_RANGE * (0.5 + r * sin(angle))), 20};
+}
+
+// Where the driver puts a raw x coordinate at the current scale
+static int32_t scaled_x(uint16_t x) {
+    pinnacle_data_t data = {};
+    data.xValue          = x;
+    data.yValue          = CIRQUE_PINNACLE_Y_LOWER + CIRQUE_PINNACLE_Y_RANGE / 2;
+    cirque_pinnacle_scale_data(&data, cirque_pinnacle_get_scale(), cirque_pinnacle_get_scale());
+    return data.xValue;
+}
+
+class CirquePinnacle : public testing::Test {
+   protected:
+    void SetUp() override {
+        host_set_driver(&mock_host_driver);
+        packets.clear();
+        cirque_pinnacle_set_scale(CIRQUE_PINNACLE_DEFAULT_SCALE);
+        cirque_pinnacle_enable_tap(true);
+        cirque_pinnacle_enable_circular_scroll(true);
+        cirque_pinnacle_configure_circular_scroll(33, 16, 9102, 18, false);
+        cirque_pinnacle_enable_cursor_glide(true);
+
+        // Empty the ring, end any gesture or glide an earlier test left behind
+        pinnacle_data_t data;
+        while (cirque_pinnacle_next_sample(&data)) {
+        }
+        replay({{100000, 0, 0, 0}});
+        for (int i = 0; i < 100; i++) {
+            advance_time(10);
+            take_report();
+        }
+        // and send what's left of its motion, the first pass may still be throttled from an earlier test
+        task();
+        while (task()) {
+        }
+
+        report       = {};
+        motion_x     = 0;
+        motion_y     = 0;
+        packet_reads = 0;
+        moved.clear();
+        sent_reports.clear();
+    }
+
+    bool task() {
+        advance_time(POINTING_DEVICE_TASK_THROTTLE_MS);
+        return pointing_device_task();
+    }
+
+    // Asks the driver for a report, as pointing_device_task() does, and adds up what it produced
+    void take_report() {
+        report_mouse_t           next   = {};
+        pointing_device_motion_t before = pointing_device_get_motion();
+
+        next.buttons                   = report.buttons;
+        next                           = pointing_device_driver.get_report(next);
+        pointing_device_motion_t after = pointing_device_get_motion();
+        int32_t                  dx     = (int32_t)(after.x - before.x);
+        int32_t                  dy     = (int32_t)(after.y - before.y);
+
+        motion_x += dx;
+        motion_y += dy;
+        moved.push_back(dx != 0 || dy != 0);
+        report.buttons = next.buttons;
+        report.v += next.v;
+        report.h += next.h;
+    }
+
+    // Each packet is buffered when the data ready line goes active, and a report is taken straight after
+    void replay(const std::vector<sample> &trace) {
+        for (const sample &s : trace) {
+            set_time(s.time);
+            queue_packet(s.x, s.y, s.z);
+            pointing_device_driver.sample();
+            take_report();
+        }
+    }
+
+    report_mouse_t    report;
+    int32_t           motion_x;
+    int32_t           motion_y;
+    std::vector<bool> moved;
+};
+
+TEST_F(CirquePinnacle, BuffersSamplesUntilTaken) {
+    pinnacle_data_t data;
+
+    queue_packet(1000, 800, 10);
+    cirque_pinnacle_sample();
+    queue_packet(0x123, 0x456, 20);
+    cirque_pinnacle_sample();
+
+    ASSERT_TRUE(cirque_pinnacle_next_sample(&data));
+    EXPECT_TRUE(data.valid);
+    EXPECT_TRUE(data.touchDown);
+    EXPECT_EQ(data.xValue, 1000);
+    EXPECT_EQ(data.yValue, 800);
+    EXPECT_EQ(data.zValue, 10);
+
+    ASSERT_TRUE(cirque_pinnacle_next_sample(&data));
+    EXPECT_EQ(data.xValue, 0x123);
+    EXPECT_EQ(data.yValue, 0x456);
+    EXPECT_EQ(data.zValue, 20);
+
+    EXPECT_FALSE(cirque_pinnacle_next_sample(&data));
+}
+
+TEST_F(CirquePinnacle, SamplesOnlyWhenDataReady) {
+    pinnacle_data_t data;
+
+    cirque_pinnacle_sample();
+    EXPECT_EQ(packet_reads, 0);
+    EXPECT_FALSE(cirque_pinnacle_next_sample(&data));
+}
+
+TEST_F(CirquePinnacle, DropsOldestSampleWhenFull) {
+    pinnacle_data_t data;
+
+    for (uint16_t i = 1; i <= CIRQUE_PINNACLE_SAMPLE_BUFFER + 2; i++) {
+        queue_packet(i * 100, 500, 10);
+        cirque_pinnacle_sample();
+    }
+    for (uint16_t i = 3; i <= CIRQUE_PINNACLE_SAMPLE_BUFFER + 2; i++) {
+        ASSERT_TRUE(cirque_pinnacle_next_sample(&data));
+        EXPECT_EQ(data.xValue, i * 100);
+    }
+    EXPECT_FALSE(cirque_pinnacle_next_sample(&data));
+}
+
+TEST_F(CirquePinnacle, ShortTouchClicks) {
+    replay({
+        {200000, 1000, 800, 20},
+        {200010, 1002, 801, 22},
+        {200100, 0, 0, 0},
+    });
+    EXPECT_EQ(report.buttons, 1 << POINTING_DEVICE_BUTTON1);
+}
+
+TEST_F(CirquePinnacle, LongTouchDoesNotClick) {
+    replay({
+        {200000, 1000, 800, 20},
+        {200100, 1002, 801, 22},
+        {200400, 0, 0, 0},
+    });
+    EXPECT_EQ(report.buttons, 0);
+}
+
+TEST_F(CirquePinnacle, DisabledTapDoesNotClick) {
+    cirque_pinnacle_enable_tap(false);
+    replay({
+        {200000, 1000, 800, 20},
+        {200100, 0, 0, 0},
+    });
+    EXPECT_EQ(report.buttons, 0);
+}
+
+TEST_F(CirquePinnacle, CircularScrollAlongRing) {
+    std::vector<sample> trace;
+    for (int i = 0; i <= 30; i++) {
+        trace.push_back(circle_point(200000 + i * 10, i * M_PI / 30, 90));
+    }
+    trace.push_back({200310, 0, 0, 0});
+    replay(trace);
+
+    // Half a turn is about half of the wheel clicks, all on the vertical wheel, and none of it moves the cursor
+    EXPECT_LE(abs(report.v), 10);
+    EXPECT_GE(abs(report.v), 8);
+    EXPECT_EQ(report.h, 0);
+    for (size_t i = 1; i < trace.size() - 1; i++) {
+        EXPECT_FALSE(moved[i]) << "sample " << i;
+    }
+    EXPECT_EQ(report.buttons, 0);
+}
+
+TEST_F(CirquePinnacle, CircularScrollDirection) {
+    std::vector<sample> forward, backward;
+    for (int i = 0; i <= 10; i++) {
+        forward.push_back(circle_point(200000 + i * 10, i * M_PI / 10, 90));
+        backward.push_back(circle_point(300000 + i * 10, -i * M_PI / 10, 90));
+    }
+    forward.push_back({200110, 0, 0, 0});
+    backward.push_back({300110, 0, 0, 0});
+
+    replay(forward);
+    int8_t v = report.v;
+    report   = {};
+    replay(backward);
+
+    EXPECT_NE(v, 0);
+    EXPECT_EQ(report.v, -v);
+}
+
+TEST_F(CirquePinnacle, LeftSideScrollsHorizontally) {
+    std::vector<sample> trace;
+    for (int i = 0; i <= 10; i++) {
+        trace.push_back(circle_point(200000 + i * 10, M_PI + i * M_PI / 10, 90));
+    }
+    trace.push_back({200110, 0, 0, 0});
+    replay(trace);
+
+    EXPECT_NE(report.h, 0);
+    EXPECT_EQ(report.v, 0);
+}
+
+TEST_F(CirquePinnacle, MovingInwardsIsNotScroll) {
+    std::vector<sample> trace;
+    for (int i = 0; i <= 10; i++) {
+        trace.push_back(circle_point(200000 + i * 10, 0, 90 - i * 8));
+    }
+    trace.push_back({200110, 0, 0, 0});
+    replay(trace);
+
+    EXPECT_EQ(report.v, 0);
+    EXPECT_EQ(report.h, 0);
+    EXPECT_TRUE(moved[trace.size() - 2]);
+}
+
+TEST_F(CirquePinnacle, CentreTouchIsNotScroll) {
+    std::vector<sample> trace;
+    for (int i = 0; i <= 10; i++) {
+        trace.push_back(circle_point(200000 + i * 10, i * M_PI / 10, 20));
+    }
+    trace.push_back({200110, 0, 0, 0});
+    replay(trace);
+
+    EXPECT_EQ(report.v, 0);
+    EXPECT_EQ(report.h, 0);
+    for (size_t i = 1; i < trace.size() - 1; i++) {
+        EXPECT_TRUE(moved[i]) << "sample " << i;
+    }
+}
+
+TEST_F(CirquePinnacle, ReportTakesBudgetedSamples) {
+    cirque_pinnacle_enable_tap(false);
+    replay({{200000, 1000, 800, 20}});
+
+    // Four samples come in before the next report, each 40 counts further along
+    for (uint16_t i = 1; i <= 4; i++) {
+        set_time(200000 + i * 10);
+        queue_packet(1000 + i * 40, 800, 20);
+        pointing_device_driver.sample();
+    }
+    static_assert(CIRQUE_PINNACLE_GESTURE_BUDGET == 2, "the trace assumes two samples per report");
+
+    // Only the budget is used, the rest wait for the following report
+    take_report();
+    EXPECT_EQ(motion_x, scaled_x(1080) - scaled_x(1000));
+    take_report();
+    EXPECT_EQ(motion_x, scaled_x(1160) - scaled_x(1000));
+    take_report();
+    EXPECT_EQ(motion_x, scaled_x(1160) - scaled_x(1000));
+    EXPECT_EQ(motion_y, 0);
+    EXPECT_EQ(moved, std::vector<bool>({false, true, true, false}));
+}
+
+TEST_F(CirquePinnacle, LargeMoveIsCarriedIntoLaterReports) {
+    cirque_pinnacle_enable_tap(false);
+    cirque_pinnacle_enable_cursor_glide(false);
+    cirque_pinnacle_set_scale(8192);
+    replay({
+        {200000, 400, 800, 20},
+        {200010, 600, 800, 20},
+    });
+    int32_t moved_x = scaled_x(600) - scaled_x(400);
+    ASSERT_GT(moved_x, 2 * XY_REPORT_MAX);
+    EXPECT_EQ(motion_x, moved_x);
+
+    // The reports carry what doesn't fit until all of it is sent
+    int32_t sent_x = 0;
+    while (task()) {
+    }
+    ASSERT_GE(sent_reports.size(), 3u);
+    EXPECT_EQ(sent_reports[0].x, XY_REPORT_MAX);
+    for (const report_mouse_t &sent : sent_reports) {
+        EXPECT_LE(sent.x, XY_REPORT_MAX);
+        EXPECT_EQ(sent.y, 0);
+        sent_x += sent.x;
+    }
+    EXPECT_EQ(sent_x, moved_x);
+}
+
+TEST_F(CirquePinnacle, GlidesWithoutSamples) {
+    cirque_pinnacle_enable_tap(false);
+    std::vector<sample> trace;
+    for (uint16_t i = 0; i <= 5; i++) {
+        trace.push_back({200000 + i * 10u, (uint16_t)(600 + i * 60), 800, 20});
+    }
+    trace.push_back({200060, 0, 0, 0});
+    replay(trace);
+    int32_t swiped = motion_x;
+    ASSERT_GT(swiped, 0);
+
+    // No more samples come in, the cursor keeps moving the same way and slows down
+    int32_t last = swiped;
+    int     reports_moved = 0;
+    for (int i = 0; i < 50; i++) {
+        advance_time(10);
+        take_report();
+        EXPECT_GE(motion_x, last);
+        if (motion_x != last) {
+            reports_moved++;
+        }
+        last = motion_x;
+    }
+    EXPECT_GT(reports_moved, 1);
+    EXPECT_GT(motion_x, swiped);
+    EXPECT_EQ(motion_y, 0);
+}
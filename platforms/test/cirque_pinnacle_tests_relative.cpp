@@ -0,0 +1,116 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "host.h"
+#include "pointing_device.h"
+
+extern const pointing_device_driver_t pointing_device_driver;
+}
+
+// Packets the trackpad has ready, the front one is flagged in STATUS1 until the flags are cleared
+static std::deque<std::vector<uint8_t>> packets;
+
+extern "C" void RAP_ReadBytes(uint8_t address, uint8_t *data, uint8_t count) {
+    memset(data, 0, count);
+    if (address == HOSTREG__STATUS1) {
+        data[0] = packets.empty() ? 0 : HOSTREG__STATUS1__DATA_READY;
+    } else if (address == HOSTREG__PACKETBYTE_0 && !packets.empty()) {
+        memcpy(data, packets.front().data(), count);
+    }
+}
+
+extern "C" void RAP_Write(uint8_t address, uint8_t data) {
+    if (address == HOSTREG__STATUS1 && !(data & HOSTREG__STATUS1__DATA_READY) && !packets.empty()) {
+        packets.pop_front();
+    }
+}
+
+extern "C" void spi_init(void) {}
+
+extern "C" bool has_mouse_report_changed(report_mouse_t *new_report, report_mouse_t *old_report) {
+    return false;
+}
+
+// A relative mode packet, moving right and scrolling by the given amounts
+static void queue_packet(uint8_t x, int8_t wheel) {
+    packets.push_back({0, x, 0, (uint8_t)wheel, 0, 0});
+}
+
+class CirquePinnacleRelative : public testing::Test {
+   protected:
+    void SetUp() override {
+        pinnacle_data_t data;
+        packets.clear();
+        // One count per count, so the deltas read are the deltas reported
+        cirque_pinnacle_set_scale(CIRQUE_PINNACLE_X_RANGE);
+        while (cirque_pinnacle_next_sample(&data)) {
+        }
+    }
+
+    // Asks the driver for a report, returning the cursor motion it added
+    int32_t take_report(report_mouse_t *report) {
+        pointing_device_motion_t before = pointing_device_get_motion();
+        *report                         = pointing_device_driver.get_report(*report);
+        return (int32_t)(pointing_device_get_motion().x - before.x);
+    }
+};
+
+TEST_F(CirquePinnacleRelative, FullRingMergesDeltas) {
+    report_mouse_t report = {};
+    int32_t        x      = 0;
+
+    for (int i = 0; i < CIRQUE_PINNACLE_SAMPLE_BUFFER + 3; i++) {
+        queue_packet(10, 0);
+        pointing_device_driver.sample();
+    }
+    for (int i = 0; i < CIRQUE_PINNACLE_SAMPLE_BUFFER; i++) {
+        x += take_report(&report);
+    }
+
+    // Nothing read while the ring was full is lost
+    EXPECT_EQ(x, 10 * (CIRQUE_PINNACLE_SAMPLE_BUFFER + 3));
+}
+
+TEST_F(CirquePinnacleRelative, FullRingSaturatesWheel) {
+    report_mouse_t report = {};
+    int            v      = 0;
+
+    for (int i = 0; i < CIRQUE_PINNACLE_SAMPLE_BUFFER; i++) {
+        queue_packet(0, 0);
+        pointing_device_driver.sample();
+    }
+    // These three go into the newest sample, 300 clicks would wrap around to scrolling backwards
+    for (int i = 0; i < 3; i++) {
+        queue_packet(0, 100);
+        pointing_device_driver.sample();
+    }
+    for (int i = 0; i < CIRQUE_PINNACLE_SAMPLE_BUFFER; i++) {
+        report = {};
+        take_report(&report);
+        v += report.v;
+    }
+    EXPECT_EQ(v, INT8_MAX);
+}
+
+TEST_F(CirquePinnacleRelative, ReportSaturatesWheel) {
+    report_mouse_t report = {};
+
+    report.v = 100;
+    queue_packet(0, 100);
+    pointing_device_driver.sample();
+    take_report(&report);
+    EXPECT_EQ(report.v, INT8_MAX);
+
+    report.v = -100;
+    queue_packet(0, -100);
+    pointing_device_driver.sample();
+    take_report(&report);
+    EXPECT_EQ(report.v, INT8_MIN);
+}
@@ -23,3 +23,60 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+ws2812_spi_encode_INC := \
+	$(PLATFORM_PATH)/chibios/drivers/
+
+ws2812_spi_encode_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/ws2812_spi_encode_tests.cpp
+
+oled_rotate_INC := \
+	$(TOP_DIR)/drivers/oled
+
+oled_rotate_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/oled_rotate_tests.cpp
+
+cirque_pinnacle_DEFS := \
+	-DNO_PRINT \
+	-DMOUSE_ENABLE \
+	-DPOINTING_DEVICE_ENABLE \
+	-DPOINTING_DEVICE_DRIVER_cirque_pinnacle_spi \
+	-DCIRQUE_PINNACLE_SPI_CS_PIN=0 \
+	-DPOINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE \
+	-DPOINTING_DEVICE_GESTURES_SCROLL_ENABLE \
+	-DCIRQUE_PINNACLE_TAP_ENABLE \
+	-DCIRQUE_PINNACLE_TAPPING_TERM=200
+
+cirque_pinnacle_INC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers \
+	$(TOP_DIR)/drivers/sensors \
+	$(QUANTUM_PATH)/pointing_device
+
+cirque_pinnacle_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/cirque_pinnacle_tests.cpp \
+	$(TOP_DIR)/drivers/sensors/cirque_pinnacle.c \
+	$(TOP_DIR)/drivers/sensors/cirque_pinnacle_gestures.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_drivers.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_gestures.c \
+	$(TMK_PATH)/protocol/host.c
+
+cirque_pinnacle_relative_DEFS := \
+	-DNO_PRINT \
+	-DMOUSE_ENABLE \
+	-DPOINTING_DEVICE_ENABLE \
+	-DPOINTING_DEVICE_DRIVER_cirque_pinnacle_spi \
+	-DCIRQUE_PINNACLE_SPI_CS_PIN=0 \
+	-DCIRQUE_PINNACLE_POSITION_MODE=CIRQUE_PINNACLE_RELATIVE_MODE
+
+cirque_pinnacle_relative_INC := $(cirque_pinnacle_INC)
+
+cirque_pinnacle_relative_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/cirque_pinnacle_tests_relative.cpp \
+	$(TOP_DIR)/drivers/sensors/cirque_pinnacle.c \
+	$(TOP_DIR)/drivers/sensors/cirque_pinnacle_gestures.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_drivers.c \
+	$(TMK_PATH)/protocol/host.c
@@ -39,6 +39,12 @@ uint16_t timer_elapsed(uint16_t last) {
 uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(timer_read32(), last);
 }
+uint32_t timer_read_us(void) {
+    return current_time * 1000;
+}
+uint32_t timer_elapsed_us(uint32_t last) {
+    return TIMER_DIFF_32(timer_read_us(), last);
+}
 
 void set_time(uint32_t t) {
     current_time = t;
@@ -0,0 +1,65 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ws2812_spi_encode.h"
+}
+
+// Per-byte lookup previously used by ws2812_spi.c, kept as the reference output
+static uint8_t reference_protocol_eq(uint8_t data, int pos) {
+    uint8_t eq = 0;
+    if (data & (1 << (2 * (3 - pos))))
+        eq = 0b1110;
+    else
+        eq = 0b1000;
+    if (data & (2 << (2 * (3 - pos))))
+        eq += 0b11100000;
+    else
+        eq += 0b10000000;
+    return eq;
+}
+
+TEST(Ws2812SpiEncode, EncodeByteMatchesReference) {
+    for (int data = 0; data < 256; data++) {
+        uint8_t out[WS2812_SPI_BYTES_PER_CHANNEL];
+        ws2812_spi_encode_byte(data, out);
+        for (int pos = 0; pos < WS2812_SPI_BYTES_PER_CHANNEL; pos++) {
+            EXPECT_EQ(out[pos], reference_protocol_eq(data, pos)) << "data " << data << " pos " << pos;
+        }
+    }
+}
+
+TEST(Ws2812SpiEncode, EncodeLedUsesGrbOrder) {
+    LED_TYPE color = {};
+    color.r        = 0x12;
+    color.g        = 0x34;
+    color.b        = 0x56;
+
+    uint8_t out[WS2812_SPI_BYTES_PER_LED];
+    ws2812_spi_encode_led(&color, out);
+
+    const uint8_t expected_order[3] = {0x34, 0x12, 0x56};
+    for (int channel = 0; channel < 3; channel++) {
+        for (int pos = 0; pos < WS2812_SPI_BYTES_PER_CHANNEL; pos++) {
+            EXPECT_EQ(out[channel * WS2812_SPI_BYTES_PER_CHANNEL + pos], reference_protocol_eq(expected_order[channel], pos));
+        }
+    }
+}
+
+TEST(Ws2812SpiEncode, EncodeLedStaysInBounds) {
+    LED_TYPE color = {};
+    color.r        = 0xFF;
+    color.g        = 0xFF;
+    color.b        = 0xFF;
+
+    uint8_t out[WS2812_SPI_BYTES_PER_LED + 1];
+    out[WS2812_SPI_BYTES_PER_LED] = 0x5A;
+    ws2812_spi_encode_led(&color, out);
+
+    for (int i = 0; i < WS2812_SPI_BYTES_PER_LED; i++) {
+        EXPECT_EQ(out[i], 0xEE);
+    }
+    EXPECT_EQ(out[WS2812_SPI_BYTES_PER_LED], 0x5A);
+}
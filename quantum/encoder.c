@@ -20,13 +20,30 @@
 #include "action.h"
 #include "keycodes.h"
 #include "wait.h"
+#include "timer.h"
+#ifdef ENCODER_INTERRUPT_ENABLE
+#    include "atomic_util.h"
+#endif
 
 #ifdef SPLIT_KEYBOARD
 #    include "split_util.h"
 #endif
 
+// Only mouse wheel keycodes can be batched
+#if defined(ENCODER_MAP_BATCH_ENABLE) && !defined(MOUSEKEY_ENABLE)
+#    undef ENCODER_MAP_BATCH_ENABLE
+#endif
+
+#ifdef ENCODER_MAP_BATCH_ENABLE
+#    include "keymap_common.h"
+#    include "action_layer.h"
+#    include "mousekey.h"
+#endif
+
 // for memcpy
 #include <string.h>
+// for abs
+#include <stdlib.h>
 
 #ifndef ENCODER_MAP_KEY_DELAY
 #    include "action.h"
@@ -37,6 +54,14 @@
 #    define ENCODER_RESOLUTION 4
 #endif
 
+#ifndef ENCODER_ACCELERATION_RATE
+#    define ENCODER_ACCELERATION_RATE 10
+#endif
+
+#ifndef ENCODER_ACCELERATION_LIMIT
+#    define ENCODER_ACCELERATION_LIMIT 8
+#endif
+
 #if !defined(ENCODERS_PAD_A) || !defined(ENCODERS_PAD_B)
 #    error "No encoder pads defined by ENCODERS_PAD_A and ENCODERS_PAD_B"
 #endif
@@ -73,6 +98,15 @@ static uint8_t thatCount;
 
 static uint8_t encoder_value[NUM_ENCODERS] = {0};
 
+#ifdef ENCODER_INTERRUPT_ENABLE
+// steps decoded by the pin interrupts, waiting for encoder_read()
+static volatile int8_t encoder_pending[NUM_ENCODERS_MAX_PER_SIDE] = {0};
+#endif
+
+// time of each encoder's last step, and the time taken per step before it
+static uint32_t encoder_step_time[NUM_ENCODERS]     = {0};
+static uint16_t encoder_step_interval[NUM_ENCODERS] = {0};
+
 __attribute__((weak)) void encoder_wait_pullup_charge(void) {
     wait_us(100);
 }
@@ -111,6 +145,14 @@ __attribute__((weak)) bool should_process_encoder(void) {
     return is_keyboard_master();
 }
 
+#if defined(ENCODER_INTERRUPT_ENABLE) && defined(PROTOCOL_CHIBIOS)
+static void encoder_pal_cb(void *arg) {
+    osalSysLockFromISR();
+    encoder_handle_interrupt((uintptr_t)arg);
+    osalSysUnlockFromISR();
+}
+#endif
+
 void encoder_init(void) {
 #ifdef SPLIT_KEYBOARD
     thisHand  = isLeftHand ? 0 : NUM_ENCODERS_LEFT;
@@ -129,6 +171,10 @@ void encoder_init(void) {
     memset(encoder_value, 0, sizeof(encoder_value));
     memset(encoder_state, 0, sizeof(encoder_state));
     memset(encoder_pulses, 0, sizeof(encoder_pulses));
+    memset(encoder_step_time, 0, sizeof(encoder_step_time));
+#    ifdef ENCODER_INTERRUPT_ENABLE
+    memset((void *)encoder_pending, 0, sizeof(encoder_pending));
+#    endif
     static const pin_t encoders_pad_a_left[] = ENCODERS_PAD_A;
     static const pin_t encoders_pad_b_left[] = ENCODERS_PAD_B;
     for (uint8_t i = 0; i < thisCount; i++) {
@@ -169,6 +215,18 @@ void encoder_init(void) {
     for (uint8_t i = 0; i < thisCount; i++) {
         encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
     }
+    for (uint8_t i = 0; i < NUM_ENCODERS; i++) {
+        encoder_step_interval[i] = UINT16_MAX;
+    }
+
+#if defined(ENCODER_INTERRUPT_ENABLE) && defined(PROTOCOL_CHIBIOS)
+    for (uint8_t i = 0; i < thisCount; i++) {
+        palEnableLineEvent(encoders_pad_a[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_a[i], encoder_pal_cb, (void *)(uintptr_t)i);
+        palEnableLineEvent(encoders_pad_b[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_b[i], encoder_pal_cb, (void *)(uintptr_t)i);
+    }
+#endif
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -184,11 +242,49 @@ static void encoder_exec_mapping(uint8_t index, bool clockwise) {
     wait_ms(ENCODER_MAP_KEY_DELAY);
 #    endif // ENCODER_MAP_KEY_DELAY > 0
 }
+
+#    ifdef ENCODER_MAP_BATCH_ENABLE
+/* Sends a run of detents mapped to a mouse wheel keycode as one wheel movement through mousekey,
+ * instead of a press and release through the keymap for each of them
+ * returns false if the keycode needs the regular handling */
+static bool encoder_exec_mapping_batch(uint8_t index, bool clockwise, uint8_t count) {
+    keyevent_t event   = clockwise ? MAKE_ENCODER_CW_EVENT(index, true) : MAKE_ENCODER_CCW_EVENT(index, true);
+    uint16_t   keycode = keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
+
+    if (!IS_MOUSEKEY_WHEEL(keycode)) {
+        return false;
+    }
+    mousekey_wheel_tap(keycode, count);
+    return true;
+}
+#    endif // ENCODER_MAP_BATCH_ENABLE
+#endif     // ENCODER_MAP_ENABLE
+
+/* Runs the mapping or callbacks for a number of steps of one encoder, positive steps being the
+ * direction that raises its value */
+static void encoder_exec_steps(uint8_t index, int16_t steps) {
+    const bool    clockwise = steps > 0 ? ENCODER_COUNTER_CLOCKWISE : ENCODER_CLOCKWISE;
+    const uint8_t count     = MIN(abs(steps), UINT8_MAX);
+
+#if defined(ENCODER_MAP_ENABLE) && defined(ENCODER_MAP_BATCH_ENABLE)
+    if (encoder_exec_mapping_batch(index, clockwise, count)) {
+        return;
+    }
+#endif
+
+    for (uint8_t i = 0; i < count; i++) {
+#ifdef ENCODER_MAP_ENABLE
+        encoder_exec_mapping(index, clockwise);
+#else  // ENCODER_MAP_ENABLE
+        encoder_update_kb(index, clockwise);
 #endif // ENCODER_MAP_ENABLE
+    }
+}
 
-static bool encoder_update(uint8_t index, uint8_t state) {
-    bool    changed = false;
-    uint8_t i       = index;
+/* Feeds a new pin state of a local encoder into its decoder, safe to call from the pin interrupts
+ * returns 1 or -1 for a completed step, in the direction its value moves, and 0 otherwise */
+static int8_t encoder_decode(uint8_t i, uint8_t new_status) {
+    int8_t step = 0;
 
 #ifdef ENCODER_RESOLUTIONS
     const uint8_t resolution = encoder_resolutions[i];
@@ -196,66 +292,110 @@ static bool encoder_update(uint8_t index, uint8_t state) {
     const uint8_t resolution = ENCODER_RESOLUTION;
 #endif
 
-#ifdef SPLIT_KEYBOARD
-    index += thisHand;
-#endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
+    if ((encoder_state[i] & 0x3) == new_status) {
+        return 0;
+    }
+    encoder_state[i] <<= 2;
+    encoder_state[i] |= new_status;
+    encoder_pulses[i] += encoder_LUT[encoder_state[i] & 0xF];
 
 #ifdef ENCODER_DEFAULT_POS
-    if ((encoder_pulses[i] >= resolution) || (encoder_pulses[i] <= -resolution) || ((state & 0x3) == ENCODER_DEFAULT_POS)) {
+    if ((encoder_pulses[i] >= resolution) || (encoder_pulses[i] <= -resolution) || ((encoder_state[i] & 0x3) == ENCODER_DEFAULT_POS)) {
         if (encoder_pulses[i] >= 1) {
+            step = 1;
+        }
+        if (encoder_pulses[i] <= -1) {
+            step = -1;
+        }
+        encoder_pulses[i] = 0;
+    }
 #else
     if (encoder_pulses[i] >= resolution) {
+        step = 1;
+    }
+    if (encoder_pulses[i] <= -resolution) { // direction is arbitrary here, but this clockwise
+        step = -1;
+    }
+    encoder_pulses[i] %= resolution;
 #endif
+    return step;
+}
 
-            encoder_value[index]++;
-            changed = true;
-#ifdef SPLIT_KEYBOARD
-            if (should_process_encoder())
-#endif // SPLIT_KEYBOARD
-#ifdef ENCODER_MAP_ENABLE
-                encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
-#else  // ENCODER_MAP_ENABLE
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-#endif // ENCODER_MAP_ENABLE
-        }
+static int8_t encoder_sample(uint8_t i) {
+    return encoder_decode(i, (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1));
+}
 
-#ifdef ENCODER_DEFAULT_POS
-        if (encoder_pulses[i] <= -1) {
-#else
-    if (encoder_pulses[i] <= -resolution) { // direction is arbitrary here, but this clockwise
+static void encoder_record_steps(uint8_t index, uint8_t steps) {
+    uint32_t now      = timer_read32();
+    uint32_t interval = TIMER_DIFF_32(now, encoder_step_time[index]) / steps;
+
+    encoder_step_interval[index] = interval > UINT16_MAX ? UINT16_MAX : interval;
+    encoder_step_time[index]     = now;
+}
+
+static bool encoder_update(uint8_t index, int16_t steps) {
+#ifdef SPLIT_KEYBOARD
+    index += thisHand;
 #endif
-            encoder_value[index]--;
-            changed = true;
+    if (steps == 0) {
+        return false;
+    }
+    encoder_record_steps(index, MIN(abs(steps), UINT8_MAX));
+    encoder_value[index] += steps;
+
 #ifdef SPLIT_KEYBOARD
-            if (should_process_encoder())
+    if (should_process_encoder())
 #endif // SPLIT_KEYBOARD
-#ifdef ENCODER_MAP_ENABLE
-                encoder_exec_mapping(index, ENCODER_CLOCKWISE);
-#else  // ENCODER_MAP_ENABLE
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
-#endif // ENCODER_MAP_ENABLE
+        encoder_exec_steps(index, steps);
+    return true;
+}
+
+#ifdef ENCODER_INTERRUPT_ENABLE
+void encoder_handle_interrupt(uint8_t index) {
+    if (index < thisCount) {
+        int16_t pending = encoder_pending[index] + encoder_sample(index);
+        if (pending >= -INT8_MAX && pending <= INT8_MAX) {
+            encoder_pending[index] = pending;
         }
-        encoder_pulses[i] %= resolution;
-#ifdef ENCODER_DEFAULT_POS
-        encoder_pulses[i] = 0;
     }
-#endif
-    return changed;
 }
 
 bool encoder_read(void) {
     bool changed = false;
     for (uint8_t i = 0; i < thisCount; i++) {
-        uint8_t new_status = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        if ((encoder_state[i] & 0x3) != new_status) {
-            encoder_state[i] <<= 2;
-            encoder_state[i] |= new_status;
-            changed |= encoder_update(i, encoder_state[i]);
+        int16_t steps;
+        ATOMIC_BLOCK_FORCEON {
+            steps              = encoder_pending[i];
+            encoder_pending[i] = 0;
         }
+        changed |= encoder_update(i, steps);
+    }
+    return changed;
+}
+#else  // ENCODER_INTERRUPT_ENABLE
+bool encoder_read(void) {
+    bool changed = false;
+    for (uint8_t i = 0; i < thisCount; i++) {
+        changed |= encoder_update(i, encoder_sample(i));
     }
     return changed;
 }
+#endif // ENCODER_INTERRUPT_ENABLE
+
+uint16_t encoder_get_velocity(uint8_t index) {
+    uint32_t interval;
+
+    if (index >= NUM_ENCODERS) {
+        return 0;
+    }
+    // Once the encoder has stopped, the time since its last step bounds the speed
+    interval = MAX(encoder_step_interval[index], timer_elapsed32(encoder_step_time[index]));
+    return 1000 / MAX(interval, 1);
+}
+
+uint8_t encoder_get_acceleration(uint8_t index) {
+    return MIN(1 + encoder_get_velocity(index) / ENCODER_ACCELERATION_RATE, ENCODER_ACCELERATION_LIMIT);
+}
 
 #ifdef SPLIT_KEYBOARD
 void last_encoder_activity_trigger(void);
@@ -269,25 +409,11 @@ void encoder_update_raw(uint8_t *slave_state) {
     for (uint8_t i = 0; i < thatCount; i++) { // Note inverted logic -- we want the opposite side
         const uint8_t index = i + thatHand;
         int8_t        delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            changed = true;
-#    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
-#    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-#    endif // ENCODER_MAP_ENABLE
-        }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
+        if (delta != 0) {
+            encoder_record_steps(index, abs(delta));
+            encoder_value[index] += delta;
+            encoder_exec_steps(index, delta);
             changed = true;
-#    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_CLOCKWISE);
-#    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
-#    endif // ENCODER_MAP_ENABLE
         }
     }
 
@@ -28,6 +28,13 @@ bool encoder_read(void);
 bool encoder_update_kb(uint8_t index, bool clockwise);
 bool encoder_update_user(uint8_t index, bool clockwise);
 
+uint16_t encoder_get_velocity(uint8_t index);
+uint8_t  encoder_get_acceleration(uint8_t index);
+
+#ifdef ENCODER_INTERRUPT_ENABLE
+void encoder_handle_interrupt(uint8_t index);
+#endif
+
 #ifdef SPLIT_KEYBOARD
 
 void encoder_state_raw(uint8_t* slave_state);
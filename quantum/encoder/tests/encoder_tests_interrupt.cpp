@@ -0,0 +1,151 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+
+extern "C" {
+#include "encoder.h"
+#include "encoder/tests/mock.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+struct update {
+    int8_t index;
+    bool   clockwise;
+};
+
+uint8_t updates_array_idx = 0;
+update  updates[32];
+
+bool encoder_update_kb(uint8_t index, bool clockwise) {
+    updates[updates_array_idx % 32] = {index, clockwise};
+    updates_array_idx++;
+    return true;
+}
+
+// An edge on either pin raises the encoder's interrupt
+void setAndInterrupt(pin_t pin, bool val) {
+    setPin(pin, val);
+    encoder_handle_interrupt(0);
+}
+
+void clockwiseStep(void) {
+    setAndInterrupt(0, false);
+    setAndInterrupt(1, false);
+    setAndInterrupt(0, true);
+    setAndInterrupt(1, true);
+}
+
+void counterClockwiseStep(void) {
+    setAndInterrupt(1, false);
+    setAndInterrupt(0, false);
+    setAndInterrupt(1, true);
+    setAndInterrupt(0, true);
+}
+
+class EncoderInterruptTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        updates_array_idx = 0;
+        encoder_init();
+    }
+};
+
+TEST_F(EncoderInterruptTest, TestStepsBetweenReads) {
+    // The main loop stalls for three detents, none of them may be lost
+    clockwiseStep();
+    clockwiseStep();
+    clockwiseStep();
+    EXPECT_EQ(updates_array_idx, 0);
+
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 3);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(updates[i].index, 0);
+        EXPECT_EQ(updates[i].clockwise, true);
+    }
+
+    EXPECT_FALSE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 3);
+}
+
+TEST_F(EncoderInterruptTest, TestBothPinsChangeBetweenReads) {
+    // Polling would see both pins flip at once and drop the step
+    setAndInterrupt(0, false);
+    setAndInterrupt(1, false);
+    encoder_read();
+    setAndInterrupt(0, true);
+    setAndInterrupt(1, true);
+    encoder_read();
+
+    EXPECT_EQ(updates_array_idx, 1);
+    EXPECT_EQ(updates[0].clockwise, true);
+}
+
+TEST_F(EncoderInterruptTest, TestDirectionsCancelBetweenReads) {
+    clockwiseStep();
+    clockwiseStep();
+    counterClockwiseStep();
+    encoder_read();
+
+    EXPECT_EQ(updates_array_idx, 1);
+    EXPECT_EQ(updates[0].clockwise, true);
+}
+
+TEST_F(EncoderInterruptTest, TestReadDoesNotPoll) {
+    setPin(0, false);
+    setPin(1, false);
+    setPin(0, true);
+    setPin(1, true);
+
+    EXPECT_FALSE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 0);
+}
+
+TEST_F(EncoderInterruptTest, TestVelocity) {
+    EXPECT_EQ(encoder_get_velocity(0), 0);
+    EXPECT_EQ(encoder_get_acceleration(0), 1);
+
+    advance_time(1000);
+    clockwiseStep();
+    encoder_read();
+    EXPECT_EQ(encoder_get_velocity(0), 1);
+
+    // one step every 50ms
+    advance_time(50);
+    clockwiseStep();
+    encoder_read();
+    EXPECT_EQ(encoder_get_velocity(0), 20);
+    EXPECT_EQ(encoder_get_acceleration(0), 3);
+
+    // four steps drained by a single read 100ms later
+    advance_time(100);
+    for (int i = 0; i < 4; i++) {
+        clockwiseStep();
+    }
+    encoder_read();
+    EXPECT_EQ(encoder_get_velocity(0), 40);
+    EXPECT_EQ(encoder_get_acceleration(0), 5);
+
+    // slows down once the encoder stops
+    advance_time(500);
+    EXPECT_EQ(encoder_get_velocity(0), 2);
+    EXPECT_EQ(encoder_get_acceleration(0), 1);
+}
+
+TEST_F(EncoderInterruptTest, TestAccelerationLimit) {
+    for (int i = 0; i < 8; i++) {
+        advance_time(1);
+        clockwiseStep();
+        encoder_read();
+    }
+    EXPECT_EQ(encoder_get_velocity(0), 1000);
+    EXPECT_EQ(encoder_get_acceleration(0), 8);
+}
@@ -23,6 +23,9 @@
 #include "print.h"
 #include "debug.h"
 #include "mousekey.h"
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    include "pointing_device.h"
+#endif
 
 static inline int8_t times_inv_sqrt2(int8_t x) {
     // 181/256 (0.70703125) is used as an approximation for 1/sqrt(2)
@@ -622,7 +625,36 @@ void mousekey_send(void) {
     uint16_t time = timer_read();
     if (mouse_report.x || mouse_report.y) last_timer_c = time;
     if (mouse_report.v || mouse_report.h) last_timer_w = time;
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+    // Wheel steps are whole notches, which the host may count in finer steps
+    report_mouse_t report = mouse_report;
+    report.v              = pointing_device_scale_notches(mouse_report.v);
+    report.h              = pointing_device_scale_notches(mouse_report.h);
+    host_mouse_send(&report);
+#else
     host_mouse_send(&mouse_report);
+#endif
+}
+
+/* Sends the wheel movement of a wheel key tapped count times, in as few reports as hold it */
+void mousekey_wheel_tap(uint8_t code, uint8_t count) {
+    int8_t *axis  = (code == KC_MS_WH_UP || code == KC_MS_WH_DOWN) ? &mouse_report.v : &mouse_report.h;
+    int16_t limit = INT8_MAX;
+    int32_t remaining;
+
+    // One press moves the wheel by the unit of the current speed mode
+    mousekey_on(code);
+    remaining = (int32_t)*axis * count;
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+    limit = MAX(limit / pointing_device_get_hires_scroll_resolution(), 1);
+#endif
+    while (remaining != 0) {
+        *axis = remaining > limit ? limit : (remaining < -limit ? -limit : remaining);
+        remaining -= *axis;
+        mousekey_send();
+    }
+    mousekey_off(code);
+    mousekey_send();
 }
 
 void mousekey_clear(void) {
@@ -10,7 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // QFF API
 
-bool qff_read_font_descriptor(qp_stream_t *stream, uint8_t *line_height, bool *has_ascii_table, uint16_t *num_unicode_glyphs, uint8_t *bpp, bool *has_palette, painter_compression_t *compression_scheme, uint32_t *total_bytes) {
+bool qff_read_font_descriptor(qp_stream_t *stream, uint8_t *line_height, bool *has_ascii_table, uint16_t *num_unicode_glyphs, uint8_t *bpp, bool *has_palette, painter_compression_t *compression_scheme, uint32_t *total_bytes, uint8_t *qff_version) {
     // Seek to the start
     qp_stream_setpos(stream, 0);
 
@@ -27,8 +27,8 @@ bool qff_read_font_descriptor(qp_stream_t *stream, uint8_t *line_height, bool *h
     }
 
     // Make sure the magic and version are correct
-    if (font_descriptor.magic != QFF_MAGIC || font_descriptor.qff_version != 0x01) {
-        qp_dprintf("Failed to validate font_descriptor, expected magic 0x%06X was 0x%06X, expected version = 0x%02X was 0x%02X\n", (int)QFF_MAGIC, (int)font_descriptor.magic, (int)0x01, (int)font_descriptor.qff_version);
+    if (font_descriptor.magic != QFF_MAGIC || font_descriptor.qff_version < QFF_VERSION_1 || font_descriptor.qff_version > QFF_VERSION_2) {
+        qp_dprintf("Failed to validate font_descriptor, expected magic 0x%06X was 0x%06X, expected version <= 0x%02X was 0x%02X\n", (int)QFF_MAGIC, (int)font_descriptor.magic, (int)QFF_VERSION_2, (int)font_descriptor.qff_version);
         return false;
     }
 
@@ -59,6 +59,9 @@ bool qff_read_font_descriptor(qp_stream_t *stream, uint8_t *line_height, bool *h
     if (total_bytes) {
         *total_bytes = font_descriptor.total_file_size;
     }
+    if (qff_version) {
+        *qff_version = font_descriptor.qff_version;
+    }
 
     return true;
 }
@@ -79,7 +82,7 @@ static bool qff_validate_ascii_descriptor(qp_stream_t *stream) {
     return true;
 }
 
-static bool qff_validate_unicode_descriptor(qp_stream_t *stream, uint16_t num_unicode_glyphs) {
+static bool qff_validate_unicode_descriptor(qp_stream_t *stream, uint16_t num_unicode_glyphs, bool sorted) {
     // Read the raw descriptor
     qff_unicode_glyph_table_v1_t unicode_descriptor;
     if (qp_stream_read(&unicode_descriptor, sizeof(qff_unicode_glyph_table_v1_t), 1, stream) != 1) {
@@ -92,8 +95,26 @@ static bool qff_validate_unicode_descriptor(qp_stream_t *stream, uint16_t num_un
         return false;
     }
 
-    // Skip the necessary amount of data to get to the next block
-    qp_stream_seek(stream, num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t), SEEK_CUR);
+    if (!sorted) {
+        // Skip the necessary amount of data to get to the next block
+        qp_stream_seek(stream, num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t), SEEK_CUR);
+        return true;
+    }
+
+    // Glyph lookups binary search the table, so make sure it really is in ascending code point order
+    qff_unicode_glyph_v1_t glyph_info;
+    uint32_t               last_code_point = 0;
+    for (uint16_t i = 0; i < num_unicode_glyphs; ++i) {
+        if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, stream) != 1) {
+            qp_dprintf("Failed to read unicode glyph %d\n", (int)i);
+            return false;
+        }
+        if (i > 0 && glyph_info.code_point <= last_code_point) {
+            qp_dprintf("Failed to validate unicode glyph table, code point 0x%06X is out of order\n", (int)glyph_info.code_point);
+            return false;
+        }
+        last_code_point = glyph_info.code_point;
+    }
 
     return true;
 }
@@ -101,8 +122,9 @@ static bool qff_validate_unicode_descriptor(qp_stream_t *stream, uint16_t num_un
 bool qff_validate_stream(qp_stream_t *stream) {
     bool     has_ascii_table;
     uint16_t num_unicode_glyphs;
+    uint8_t  qff_version;
 
-    if (!qff_read_font_descriptor(stream, NULL, &has_ascii_table, &num_unicode_glyphs, NULL, NULL, NULL, NULL)) {
+    if (!qff_read_font_descriptor(stream, NULL, &has_ascii_table, &num_unicode_glyphs, NULL, NULL, NULL, NULL, &qff_version)) {
         return false;
     }
 
@@ -113,7 +135,7 @@ bool qff_validate_stream(qp_stream_t *stream) {
     }
 
     if (num_unicode_glyphs > 0) {
-        if (!qff_validate_unicode_descriptor(stream, num_unicode_glyphs)) {
+        if (!qff_validate_unicode_descriptor(stream, num_unicode_glyphs, qff_version >= QFF_VERSION_2)) {
             return false;
         }
     }
@@ -127,7 +149,7 @@ uint32_t qff_get_total_size(qp_stream_t *stream) {
 
     // Read the font descriptor, grabbing the size
     uint32_t total_size;
-    if (!qff_read_font_descriptor(stream, NULL, NULL, NULL, NULL, NULL, NULL, &total_size)) {
+    if (!qff_read_font_descriptor(stream, NULL, NULL, NULL, NULL, NULL, NULL, &total_size, NULL)) {
         return false;
     }
 
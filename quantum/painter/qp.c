@@ -130,6 +130,75 @@ bool qp_flush(painter_device_t device) {
     return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_scroll
+
+bool qp_scroll(painter_device_t device, uint16_t top, uint16_t bottom, uint16_t offset) {
+    qp_dprintf("qp_scroll: entry\n");
+    painter_driver_t *driver = (painter_driver_t *)device;
+    if (!driver || !driver->validate_ok) {
+        qp_dprintf("qp_scroll: fail (validation_ok == false)\n");
+        return false;
+    }
+
+    if (!driver->driver_vtable->scroll) {
+        qp_dprintf("qp_scroll: fail (not supported by device)\n");
+        return false;
+    }
+
+    uint16_t height;
+    qp_get_geometry(device, NULL, &height, NULL, NULL, NULL);
+    if (top > bottom || bottom >= height) {
+        qp_dprintf("qp_scroll: fail (rows %d-%d outside display)\n", (int)top, (int)bottom);
+        return false;
+    }
+
+    if (!qp_comms_start(device)) {
+        qp_dprintf("qp_scroll: fail (could not start comms)\n");
+        return false;
+    }
+
+    bool ret = driver->driver_vtable->scroll(device, top, bottom, offset % (bottom - top + 1));
+    qp_comms_stop(device);
+    qp_dprintf("qp_scroll: %s\n", ret ? "ok" : "fail");
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_blit
+
+bool qp_blit(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom, uint16_t x, uint16_t y) {
+    qp_dprintf("qp_blit: entry\n");
+    painter_driver_t *driver = (painter_driver_t *)device;
+    if (!driver || !driver->validate_ok) {
+        qp_dprintf("qp_blit: fail (validation_ok == false)\n");
+        return false;
+    }
+
+    if (!driver->driver_vtable->blit) {
+        qp_dprintf("qp_blit: fail (not supported by device)\n");
+        return false;
+    }
+
+    // Both the source and destination need to be entirely on the display
+    uint16_t width, height;
+    qp_get_geometry(device, &width, &height, NULL, NULL, NULL);
+    if (left > right || top > bottom || right >= width || bottom >= height || (uint32_t)x + (right - left) >= width || (uint32_t)y + (bottom - top) >= height) {
+        qp_dprintf("qp_blit: fail (rectangle outside display)\n");
+        return false;
+    }
+
+    if (!qp_comms_start(device)) {
+        qp_dprintf("qp_blit: fail (could not start comms)\n");
+        return false;
+    }
+
+    bool ret = driver->driver_vtable->blit(device, left, top, right, bottom, x, y);
+    qp_comms_stop(device);
+    qp_dprintf("qp_blit: %s\n", ret ? "ok" : "fail");
+    return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_get_geometry
 
@@ -56,6 +56,23 @@
 #    define QUANTUM_PAINTER_LOAD_FONTS_TO_RAM FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE
+/**
+ * @def This controls the number of unicode glyph lookups (width and data offset) remembered by each loaded font, least
+ *      recently used first to be evicted. Each entry costs 9 bytes of RAM per font slot. Set to 0 to disable.
+ */
+#    define QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE 0
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE
+
+#ifndef QUANTUM_PAINTER_PALETTE_CACHE_SIZE
+/**
+ * @def This controls the number of recently-used palettes of up to 16 colors that are kept after conversion to a
+ *      display's native pixel format, so that alternating between a few recolor settings skips the conversion. Each
+ *      entry costs 136 bytes of RAM, so it is disabled by default.
+ */
+#    define QUANTUM_PAINTER_PALETTE_CACHE_SIZE 0
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE
+
 #ifndef QUANTUM_PAINTER_CONCURRENT_ANIMATIONS
 /**
  * @def This controls the maximum number of animations that Quantum Painter can play simultaneously. Increasing this
@@ -72,6 +89,15 @@
 #    define QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE 1024
 #endif
 
+#ifndef QUANTUM_PAINTER_PIXDATA_DOUBLE_BUFFER
+/**
+ * @def This controls whether two pixel data buffers are used, so that the next block of pixel data can be prepared
+ *      while the previous one is still being transmitted. Comms drivers capable of background transfers, such as SPI
+ *      on ChibiOS, then send pixel data asynchronously. Requires another QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE of RAM.
+ */
+#    define QUANTUM_PAINTER_PIXDATA_DOUBLE_BUFFER FALSE
+#endif
+
 #ifndef QUANTUM_PAINTER_SUPPORTS_256_PALETTE
 /**
  * @def This controls whether 256-color palettes are supported. This has relatively hefty requirements on RAM -- at
@@ -88,6 +114,30 @@
 #    define QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+/**
+ * @def This controls whether LZ-compressed images and fonts can be drawn. LZ compresses dithered and detailed images
+ *      far better than RLE, but requires an extra 256 bytes of RAM for its decoding window.
+ */
+#    define QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION FALSE
+#endif
+
+#ifndef QUANTUM_PAINTER_FLASH_ASSETS_ADDRESS
+/**
+ * @def This controls where in external SPI flash the asset bundle produced by `qmk painter-pack` starts. Only used
+ *      when `QUANTUM_PAINTER_FLASH_ASSETS = yes`.
+ */
+#    define QUANTUM_PAINTER_FLASH_ASSETS_ADDRESS 0
+#endif
+
+#ifndef QUANTUM_PAINTER_FLASH_READ_AHEAD_SIZE
+/**
+ * @def This controls the size of the read-ahead buffer used when reading assets from external SPI flash. Larger
+ *      buffers mean fewer flash transactions while decoding, at the cost of RAM.
+ */
+#    define QUANTUM_PAINTER_FLASH_READ_AHEAD_SIZE 128
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter types
 
@@ -175,6 +225,42 @@ bool qp_clear(painter_device_t device);
  */
 bool qp_flush(painter_device_t device);
 
+/**
+ * Scrolls a horizontal band of the display vertically, without redrawing any of it.
+ *
+ * The rows from `top` to `bottom` (inclusive) are shown starting from row `top + offset`, wrapping back around to `top`
+ * after `bottom`. Drawing coordinates are unaffected by scrolling -- to add a line to a scrolling log, draw it over the
+ * rows that are about to wrap around to the bottom, then increase the offset by the line height.
+ *
+ * @note TFT panels use their hardware vertical scrolling, which is only available when using QP_ROTATION_0. Surfaces
+ *       apply the scroll when they're drawn to a display.
+ *
+ * @param device[in] the handle of the device to control
+ * @param top[in] the first row of the scrolling band
+ * @param bottom[in] the last row of the scrolling band
+ * @param offset[in] the number of rows the contents of the band are scrolled upwards by, `0` resets scrolling
+ * @return true if the scroll succeeded
+ * @return false if the scroll failed, or isn't supported by the device
+ */
+bool qp_scroll(painter_device_t device, uint16_t top, uint16_t bottom, uint16_t offset);
+
+/**
+ * Copies a rectangle of pixels to another location on the same device. Overlapping areas are copied correctly.
+ *
+ * @note Only devices which keep their pixels in RAM, such as surfaces, are able to copy pixels.
+ *
+ * @param device[in] the handle of the device to control
+ * @param left[in] the left edge of the source rectangle
+ * @param top[in] the top edge of the source rectangle
+ * @param right[in] the right edge of the source rectangle (inclusive)
+ * @param bottom[in] the bottom edge of the source rectangle (inclusive)
+ * @param x[in] the x-position the top-left of the rectangle is copied to
+ * @param y[in] the y-position the top-left of the rectangle is copied to
+ * @return true if the copy succeeded
+ * @return false if the copy failed, or isn't supported by the device
+ */
+bool qp_blit(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom, uint16_t x, uint16_t y);
+
 /**
  * Retrieves the size, rotation, and offsets for the display.
  *
@@ -318,6 +404,20 @@ bool qp_pixdata(painter_device_t device, const void *pixel_data, uint32_t native
  */
 painter_image_handle_t qp_load_image_mem(const void *buffer);
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+/**
+ * Loads an image from the asset bundle in external SPI flash.
+ *
+ * @note Images can be unloaded by calling \ref qp_close_image.
+ *
+ * @param asset_index[in] the index of the image within the bundle, as listed in the header from `qmk painter-pack`
+ * @return an image handle usable with \ref qp_drawimage, \ref qp_drawimage_recolor, \ref qp_animate, and
+ *         \ref qp_animate_recolor.
+ * @return NULL if loading the image failed
+ */
+painter_image_handle_t qp_load_image_flash(uint16_t asset_index);
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 /**
  * Closes an image handle when no longer in use.
  *
@@ -394,6 +494,30 @@ deferred_token qp_animate_recolor(painter_device_t device, uint16_t x, uint16_t
  */
 void qp_stop_animation(deferred_token anim_token);
 
+/**
+ * Calculates the arena size needed to cache every frame of an animation for the supplied device.
+ *
+ * @param device[in] the handle of the device the animation is drawn to
+ * @param image[in] the handle of the animated image
+ * @return the number of bytes required by \ref qp_animation_set_cache to hold all frames
+ * @return 0 if the image could not be parsed
+ */
+uint32_t qp_animation_cache_size(painter_device_t device, painter_image_handle_t image);
+
+/**
+ * Supplies a running animation with an arena in which to keep decoded frames.
+ *
+ * Frames are converted to the display's native format the first time they're drawn, and subsequently sent straight
+ * from the arena. If the arena is too small, the frames that fit are cached and the remainder are decoded as normal.
+ *
+ * @param anim_token[in] the animation token returned by \ref qp_animate, or \ref qp_animate_recolor.
+ * @param arena[in] 4-byte aligned memory that must remain valid while the animation runs, or NULL to stop caching
+ * @param arena_size[in] the size of the arena in bytes
+ * @return true if the arena was attached to the animation
+ * @return false if the animation could not be found
+ */
+bool qp_animation_set_cache(deferred_token anim_token, void *arena, uint32_t arena_size);
+
 /**
  * Loads a font into memory.
  *
@@ -405,6 +529,19 @@ void qp_stop_animation(deferred_token anim_token);
  */
 painter_font_handle_t qp_load_font_mem(const void *buffer);
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+/**
+ * Loads a font from the asset bundle in external SPI flash.
+ *
+ * @note Fonts can be unloaded by calling \ref qp_close_font.
+ *
+ * @param asset_index[in] the index of the font within the bundle, as listed in the header from `qmk painter-pack`
+ * @return an image handle usable with \ref qp_textwidth, \ref qp_drawtext, and \ref qp_drawtext_recolor.
+ * @return NULL if loading the font failed
+ */
+painter_font_handle_t qp_load_font_flash(uint16_t asset_index);
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 /**
  * Closes a font handle when no longer in use.
  *
@@ -462,6 +599,12 @@ int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, pai
 #    define RGB565_SURFACE_NUM_DEVICES 0
 #endif // QUANTUM_PAINTER_RGB565_SURFACE_ENABLE
 
+#ifdef QUANTUM_PAINTER_SURFACE_ENABLE
+#    include "qp_surface.h"
+#else // QUANTUM_PAINTER_SURFACE_ENABLE
+#    define SURFACE_NUM_DEVICES 0
+#endif // QUANTUM_PAINTER_SURFACE_ENABLE
+
 #ifdef QUANTUM_PAINTER_ILI9163_ENABLE
 #    include "qp_ili9163.h"
 #else // QUANTUM_PAINTER_ILI9163_ENABLE
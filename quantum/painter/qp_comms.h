@@ -16,6 +16,11 @@ bool     qp_comms_start(painter_device_t device);
 void     qp_comms_stop(painter_device_t device);
 uint32_t qp_comms_send(painter_device_t device, const void* data, uint32_t byte_count);
 
+// Temporarily releases the bus held by whichever device is mid-transaction, so other peripherals on the same bus can
+// be used. Returns the suspended device (or NULL), which must be handed back to qp_comms_resume() afterwards.
+painter_device_t qp_comms_suspend(void);
+void             qp_comms_resume(painter_device_t device);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Comms APIs that use a D/C pin
 
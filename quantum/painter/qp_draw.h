@@ -5,12 +5,23 @@
 
 #include "qp_internal.h"
 #include "qp_stream.h"
+#include "qp_internal_lz.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter utility functions
 
 // Global variable used for native pixel data streaming.
+#if QUANTUM_PAINTER_PIXDATA_DOUBLE_BUFFER
+extern uint8_t *qp_internal_global_pixdata_buffer; // whichever of the two buffers is currently being filled
+#else
 extern uint8_t qp_internal_global_pixdata_buffer[QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+#endif
+
+// Must be called before filling the pixdata buffer from the start, swaps buffers if the current one may still be in transit
+void qp_internal_pixdata_buffer_prepare(void);
+
+// Called by comms drivers to check if data can be sent in the background, which marks the pixdata buffer as in transit
+bool qp_internal_pixdata_buffer_send_async(const void *data);
 
 // Check if the supplied bpp is capable of being rendered
 bool qp_internal_bpp_capable(uint8_t bits_per_pixel);
@@ -44,16 +55,21 @@ extern qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 #endif
 
 // Generates a color-interpolated lookup table based off the number of items, from foreground to background, for use with monochrome image rendering.
-// Returns true if a palette was created, false if the palette is reused.
-// As this uses a global, this may present a problem if using the same parameters but a different screen converts pixels -- use qp_internal_invalidate_palette() below to reset.
-bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps);
+// Leaves the lookup table in HSV888 format -- use qp_internal_recolor_palette() below to get the device's native equivalent.
+void qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps);
 
-// Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
+// Sets up the lookup table with the device's native equivalent of an interpolated palette, reusing a previous conversion if one is cached.
+bool qp_internal_recolor_palette(painter_device_t device, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps);
+
+// Resets the global palette and forgets all cached palettes. Only needed if a device changes its internal pixel format.
 void qp_internal_invalidate_palette(void);
 
 // Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset. Expects the stream to be positioned at the start of the block header.
 bool qp_internal_load_qgf_palette(qp_stream_t* stream, uint8_t bpp);
 
+// As above, but also converts the palette to the device's native format, reusing a previous conversion if one is cached.
+bool qp_internal_convert_qgf_palette(painter_device_t device, qp_stream_t* stream, uint8_t bpp);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter codec functions
 
@@ -73,6 +89,10 @@ typedef struct qp_internal_byte_input_state_t {
             enum qp_internal_rle_mode_t mode;
             uint8_t                     remain; // number of bytes remaining in the current mode
         } rle;
+#if QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+        // LZ-specific
+        qp_internal_lz_state_t lz;
+#endif
     };
 } qp_internal_byte_input_state_t;
 
@@ -54,12 +54,9 @@ bool qp_internal_decode_grayscale(painter_device_t device, uint32_t pixel_count,
 }
 
 bool qp_internal_decode_recolor(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, qp_internal_byte_input_callback input_callback, void* input_arg, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, qp_internal_pixel_output_callback output_callback, void* output_arg) {
-    painter_driver_t* driver = (painter_driver_t*)device;
-    int16_t           steps  = 1 << bits_per_pixel; // number of items we need to interpolate
-    if (qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, steps)) {
-        if (!driver->driver_vtable->palette_convert(device, steps, qp_internal_global_pixel_lookup_table)) {
-            return false;
-        }
+    int16_t steps = 1 << bits_per_pixel; // number of items we need to interpolate
+    if (!qp_internal_recolor_palette(device, fg_hsv888, bg_hsv888, steps)) {
+        return false;
     }
 
     return qp_internal_decode_palette(device, pixel_count, bits_per_pixel, input_callback, input_arg, qp_internal_global_pixel_lookup_table, output_callback, output_arg);
@@ -125,10 +122,29 @@ static inline int16_t qp_drawimage_byte_rle_decoder(void* cb_arg) {
     return c;
 }
 
+#if QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+// Window of recently-decoded bytes, only one image or font is ever being decoded at a time
+static uint8_t qp_internal_lz_window[QP_LZ_WINDOW_SIZE];
+
+static int16_t qp_drawimage_lz_stream_get(void* cb_arg) {
+    return qp_stream_get((qp_stream_t*)cb_arg);
+}
+
+static inline int16_t qp_drawimage_byte_lz_decoder(void* cb_arg) {
+    qp_internal_byte_input_state_t* state = (qp_internal_byte_input_state_t*)cb_arg;
+    state->curr                           = qp_internal_lz_decode_byte(&state->lz, qp_internal_lz_window, qp_drawimage_lz_stream_get, state->src_stream);
+    return state->curr;
+}
+#endif // QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+
 bool qp_internal_pixel_appender(qp_pixel_t* palette, uint8_t index, void* cb_arg) {
     qp_internal_pixel_output_state_t* state  = (qp_internal_pixel_output_state_t*)cb_arg;
     painter_driver_t*                 driver = (painter_driver_t*)state->device;
 
+    if (state->pixel_write_pos == 0) {
+        qp_internal_pixdata_buffer_prepare();
+    }
+
     if (!driver->driver_vtable->append_pixels(state->device, qp_internal_global_pixdata_buffer, palette, state->pixel_write_pos++, 1, &index)) {
         return false;
     }
@@ -148,6 +164,10 @@ bool qp_internal_byte_appender(uint8_t byteval, void* cb_arg) {
     qp_internal_byte_output_state_t* state  = (qp_internal_byte_output_state_t*)cb_arg;
     painter_driver_t*                driver = (painter_driver_t*)state->device;
 
+    if (state->byte_write_pos == 0) {
+        qp_internal_pixdata_buffer_prepare();
+    }
+
     if (!driver->driver_vtable->append_pixdata(state->device, qp_internal_global_pixdata_buffer, state->byte_write_pos++, byteval)) {
         return false;
     }
@@ -172,6 +192,11 @@ qp_internal_byte_input_callback qp_internal_prepare_input_state(qp_internal_byte
             input_state->rle.mode   = MARKER_BYTE;
             input_state->rle.remain = 0;
             return qp_drawimage_byte_rle_decoder;
+#if QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+        case IMAGE_COMPRESSED_LZ:
+            qp_internal_lz_reset(&input_state->lz);
+            return qp_drawimage_byte_lz_decoder;
+#endif // QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
         default:
             return NULL;
     }
@@ -20,19 +20,45 @@ _Static_assert((QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE > 0) && (QUANTUM_PAINTER_PIX
 //
 
 // Buffer used for transmitting native pixel data to the downstream device.
+#if QUANTUM_PAINTER_PIXDATA_DOUBLE_BUFFER
+__attribute__((__aligned__(4))) static uint8_t pixdata_buffers[2][QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+uint8_t *                                      qp_internal_global_pixdata_buffer = pixdata_buffers[0];
+static bool                                    pixdata_buffer_in_transit         = false;
+#else
 __attribute__((__aligned__(4))) uint8_t qp_internal_global_pixdata_buffer[QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+#endif
+
+// Identifies the palette held in the lookup table, once it has been converted to a device's native format
+typedef struct qp_palette_key_t {
+    painter_device_t device;
+    qp_pixel_t       fg_hsv888;    // interpolated palettes only
+    qp_pixel_t       bg_hsv888;    // interpolated palettes only
+    uint32_t         palette_hash; // palettes loaded from QGF/QFF only, zero for interpolated palettes
+    int16_t          steps;
+} qp_palette_key_t;
 
 // Static buffer to contain a generated color palette
-static bool                                       generated_palette = false;
-static int16_t                                    generated_steps   = -1;
-__attribute__((__aligned__(4))) static qp_pixel_t interpolated_fg_hsv888;
-__attribute__((__aligned__(4))) static qp_pixel_t interpolated_bg_hsv888;
+static bool             native_palette_valid = false;
+static qp_palette_key_t native_palette_key;
 #if QUANTUM_PAINTER_SUPPORTS_256_PALETTE
 __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table[256];
 #else
 __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 #endif
 
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+// Previously-converted native palettes, so that alternating between a few colors doesn't repeat the conversion
+typedef struct qp_palette_cache_entry_t {
+    qp_palette_key_t key; // key.device is NULL for unused entries
+    uint16_t         last_used;
+    qp_pixel_t       native[16];
+    uint8_t          source[16][3]; // HSV entries of palettes loaded from QGF/QFF, which the hash alone can't tell apart
+} qp_palette_cache_entry_t;
+
+static qp_palette_cache_entry_t palette_cache[QUANTUM_PAINTER_PALETTE_CACHE_SIZE];
+static uint16_t                 palette_cache_clock = 0;
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helpers
 
@@ -41,6 +67,28 @@ uint32_t qp_internal_num_pixels_in_buffer(painter_device_t device) {
     return ((QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE * 8) / driver->native_bits_per_pixel);
 }
 
+void qp_internal_pixdata_buffer_prepare(void) {
+#if QUANTUM_PAINTER_PIXDATA_DOUBLE_BUFFER
+    if (pixdata_buffer_in_transit) {
+        // Comms drivers wait for one transfer to finish before starting the next, so the other buffer is free
+        qp_internal_global_pixdata_buffer = (qp_internal_global_pixdata_buffer == pixdata_buffers[0]) ? pixdata_buffers[1] : pixdata_buffers[0];
+        pixdata_buffer_in_transit         = false;
+    }
+#endif
+}
+
+bool qp_internal_pixdata_buffer_send_async(const void *data) {
+#if QUANTUM_PAINTER_PIXDATA_DOUBLE_BUFFER
+    // Anything else, such as command parameters on the stack, may be reused as soon as the send returns
+    const uint8_t *p = (const uint8_t *)data;
+    if (p >= qp_internal_global_pixdata_buffer && p < qp_internal_global_pixdata_buffer + QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE) {
+        pixdata_buffer_in_transit = true;
+        return true;
+    }
+#endif
+    return false;
+}
+
 // qp_setpixel internal implementation, but accepts a buffer with pre-converted native pixel. Only the first pixel is used.
 bool qp_internal_setpixel_impl(painter_device_t device, uint16_t x, uint16_t y) {
     painter_driver_t *driver = (painter_driver_t *)device;
@@ -58,32 +106,30 @@ void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint
     driver->driver_vtable->palette_convert(device, 1, &color);
 
     // Append the required number of pixels
+    qp_internal_pixdata_buffer_prepare();
+    if (driver->driver_vtable->fill_pixels) {
+        driver->driver_vtable->fill_pixels(device, qp_internal_global_pixdata_buffer, color, 0, num_pixels);
+        return;
+    }
+
     uint8_t palette_idx = 0;
     for (uint32_t i = 0; i < num_pixels; ++i) {
         driver->driver_vtable->append_pixels(device, qp_internal_global_pixdata_buffer, &color, i, 1, &palette_idx);
     }
 }
 
-// Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
+// Resets the global palette and forgets all cached palettes, so that they're regenerated on next use.
 void qp_internal_invalidate_palette(void) {
-    generated_palette = false;
-    generated_steps   = -1;
+    native_palette_valid = false;
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    memset(palette_cache, 0, sizeof(palette_cache));
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
 }
 
 // Interpolates between two colors to generate a palette
-bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps) {
-    // Check if we need to generate a new palette -- if the input parameters match then assume the palette can stay unchanged.
-    // This may present a problem if using the same parameters but a different screen converts pixels -- use qp_internal_invalidate_palette() to reset.
-    if (generated_palette == true && generated_steps == steps && memcmp(&interpolated_fg_hsv888, &fg_hsv888, sizeof(fg_hsv888)) == 0 && memcmp(&interpolated_bg_hsv888, &bg_hsv888, sizeof(bg_hsv888)) == 0) {
-        // We already have the correct palette, no point regenerating it.
-        return false;
-    }
-
-    // Save the parameters so we know whether we can skip generation
-    generated_palette      = true;
-    generated_steps        = steps;
-    interpolated_fg_hsv888 = fg_hsv888;
-    interpolated_bg_hsv888 = bg_hsv888;
+void qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps) {
+    // The lookup table no longer holds native pixels
+    native_palette_valid = false;
 
     int16_t hue_fg = fg_hsv888.hsv888.h;
     int16_t hue_bg = bg_hsv888.hsv888.h;
@@ -103,9 +149,107 @@ bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888,
 
         qp_dprintf("qp_internal_interpolate_palette: %3d of %d -- H: %3d, S: %3d, V: %3d\n", (int)(i + 1), (int)steps, (int)qp_internal_global_pixel_lookup_table[i].hsv888.h, (int)qp_internal_global_pixel_lookup_table[i].hsv888.s, (int)qp_internal_global_pixel_lookup_table[i].hsv888.v);
     }
+}
+
+static bool qp_internal_palette_key_equal(const qp_palette_key_t *a, const qp_palette_key_t *b) {
+    // Only the HSV components are compared, the remainder of the pixel union may be uninitialised
+    return a->device == b->device && a->steps == b->steps && a->palette_hash == b->palette_hash && memcmp(&a->fg_hsv888.hsv888, &b->fg_hsv888.hsv888, sizeof(a->fg_hsv888.hsv888)) == 0 && memcmp(&a->bg_hsv888.hsv888, &b->bg_hsv888.hsv888, sizeof(a->bg_hsv888.hsv888)) == 0;
+}
 
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+// Checks a cached palette was converted from the HSV entries currently in the lookup table, guarding against hash collisions
+static bool qp_internal_palette_source_equal(const qp_palette_cache_entry_t *entry) {
+    if (entry->key.palette_hash == 0) {
+        // Interpolated palettes are fully described by the key
+        return true;
+    }
+
+    for (int16_t i = 0; i < entry->key.steps; ++i) {
+        if (memcmp(entry->source[i], &qp_internal_global_pixel_lookup_table[i].hsv888, sizeof(entry->source[i])) != 0) {
+            return false;
+        }
+    }
     return true;
 }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+// Makes the lookup table hold the native palette matching the key if it's already known, returning false if it needs converting
+static bool qp_internal_palette_restore(const qp_palette_key_t *key) {
+    if (native_palette_valid && qp_internal_palette_key_equal(&native_palette_key, key)) {
+        // We already have the correct palette, no point regenerating it.
+        return true;
+    }
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_PALETTE_CACHE_SIZE; ++i) {
+        qp_palette_cache_entry_t *entry = &palette_cache[i];
+        if (entry->key.device != NULL && qp_internal_palette_key_equal(&entry->key, key) && qp_internal_palette_source_equal(entry)) {
+            memcpy(qp_internal_global_pixel_lookup_table, entry->native, entry->key.steps * sizeof(qp_pixel_t));
+            entry->last_used     = ++palette_cache_clock;
+            native_palette_key   = *key;
+            native_palette_valid = true;
+            return true;
+        }
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+    return false;
+}
+
+// Converts the HSV888 palette in the lookup table to the device's native format, remembering the result against the key
+static bool qp_internal_palette_convert(painter_device_t device, const qp_palette_key_t *key) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    // Only palettes of up to 4bpp are cached, 256-color palettes would need far too much RAM
+    qp_palette_cache_entry_t *victim = NULL;
+    if (key->steps <= 16) {
+        // Replace an unused entry, otherwise the least recently used one
+        victim = &palette_cache[0];
+        for (uint8_t i = 0; i < QUANTUM_PAINTER_PALETTE_CACHE_SIZE && victim->key.device != NULL; ++i) {
+            qp_palette_cache_entry_t *entry = &palette_cache[i];
+            if (entry->key.device == NULL || (uint16_t)(palette_cache_clock - entry->last_used) > (uint16_t)(palette_cache_clock - victim->last_used)) {
+                victim = entry;
+            }
+        }
+
+        // The conversion happens in place, so keep the HSV entries first
+        victim->key.device = NULL;
+        for (int16_t i = 0; i < key->steps; ++i) {
+            memcpy(victim->source[i], &qp_internal_global_pixel_lookup_table[i].hsv888, sizeof(victim->source[i]));
+        }
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+    if (!driver->driver_vtable->palette_convert(device, key->steps, qp_internal_global_pixel_lookup_table)) {
+        native_palette_valid = false;
+        return false;
+    }
+
+    native_palette_key   = *key;
+    native_palette_valid = true;
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    if (victim) {
+        victim->key       = *key;
+        victim->last_used = ++palette_cache_clock;
+        memcpy(victim->native, qp_internal_global_pixel_lookup_table, key->steps * sizeof(qp_pixel_t));
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+    return true;
+}
+
+// Sets up the lookup table with the native equivalent of a palette interpolated between two colors
+bool qp_internal_recolor_palette(painter_device_t device, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps) {
+    qp_palette_key_t key = {.device = device, .fg_hsv888 = fg_hsv888, .bg_hsv888 = bg_hsv888, .palette_hash = 0, .steps = steps};
+    if (qp_internal_palette_restore(&key)) {
+        return true;
+    }
+
+    qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, steps);
+    return qp_internal_palette_convert(device, &key);
+}
 
 // Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset. Expects the stream to be positioned at the start of the block header.
 bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
@@ -118,8 +262,8 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
     // BPP determines the number of palette entries, each entry is a HSV888 triplet.
     const uint16_t palette_entries = 1u << bpp;
 
-    // Ensure we aren't reusing any palette
-    qp_internal_invalidate_palette();
+    // The lookup table no longer holds native pixels
+    native_palette_valid = false;
 
     // Read the palette entries
     for (uint16_t i = 0; i < palette_entries; ++i) {
@@ -140,6 +284,31 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
     return true;
 }
 
+// Loads the palette block specified in the asset, and sets up the lookup table with its native equivalent. Expects the stream to be positioned at the start of the block header.
+bool qp_internal_convert_qgf_palette(painter_device_t device, qp_stream_t *stream, uint8_t bpp) {
+    if (!qp_internal_load_qgf_palette(stream, bpp)) {
+        return false;
+    }
+
+    // FNV-1a over the HSV entries, so that assets sharing a palette also share the converted result
+    const uint16_t palette_entries = 1u << bpp;
+    uint32_t       hash            = 2166136261u;
+    for (uint16_t i = 0; i < palette_entries; ++i) {
+        const uint8_t *hsv = (const uint8_t *)&qp_internal_global_pixel_lookup_table[i].hsv888;
+        for (uint8_t j = 0; j < sizeof(qp_internal_global_pixel_lookup_table[i].hsv888); ++j) {
+            hash = (hash ^ hsv[j]) * 16777619u;
+        }
+    }
+
+    // Zero is reserved for interpolated palettes
+    qp_palette_key_t key = {.device = device, .fg_hsv888 = {.dummy = 0}, .bg_hsv888 = {.dummy = 0}, .palette_hash = hash ? hash : 1, .steps = palette_entries};
+    if (qp_internal_palette_restore(&key)) {
+        return true;
+    }
+
+    return qp_internal_palette_convert(device, &key);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_setpixel
 
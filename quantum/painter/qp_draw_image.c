@@ -5,6 +5,7 @@
 #include "qp_draw.h"
 #include "qp_comms.h"
 #include "qgf.h"
+#include "qpa.h"
 #include "deferred_exec.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +20,9 @@ typedef struct qgf_image_handle_t {
 #ifdef QP_STREAM_HAS_FILE_IO
         qp_file_stream_t file_stream;
 #endif // QP_STREAM_HAS_FILE_IO
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+        qp_flash_stream_t flash_stream;
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
     };
 } qgf_image_handle_t;
 
@@ -85,6 +89,30 @@ painter_image_handle_t qp_load_image_mem(const void *buffer) {
     return qp_load_image_internal(image_mem_stream_factory, (void *)buffer);
 }
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_image_flash
+
+static inline bool image_flash_stream_factory(qgf_image_handle_t *image, void *arg) {
+    uint16_t asset_index = *(uint16_t *)arg;
+
+    // Find where the image lives in flash; the asset table already knows its length
+    uint32_t address, length;
+    if (!qpa_find_flash_asset(asset_index, QPA_ASSET_IMAGE, &address, &length)) {
+        return false;
+    }
+
+    image->flash_stream = qp_make_flash_stream(address, length);
+    return true;
+}
+
+painter_image_handle_t qp_load_image_flash(uint16_t asset_index) {
+    return qp_load_image_internal(image_flash_stream_factory, &asset_index);
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_close_image
 
@@ -123,9 +151,9 @@ typedef struct qgf_frame_info_t {
     uint16_t              delay;
 } qgf_frame_info_t;
 
+// Positions the stream at the frame's pixel data and sets up the palette. Comms are left alone, callers drawing the frame
+// start them afterwards, while caching a frame never needs them.
 static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device, qgf_image_handle_t *qgf_image, uint16_t frame_number, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, qgf_frame_info_t *info) {
-    painter_driver_t *driver = (painter_driver_t *)device;
-
     // Drop out if we can't actually place the data we read out anywhere
     if (!info) {
         qp_dprintf("Failed to prepare stream for read, output info buffer unavailable\n");
@@ -147,39 +175,24 @@ static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device,
         return false;
     }
 
-    // Ensure we aren't reusing any palette
-    qp_internal_invalidate_palette();
-
     if (!qp_internal_bpp_capable(info->bpp)) {
         qp_dprintf("qp_drawimage_recolor: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE or QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS)\n", (int)info->bpp);
-        qp_comms_stop(device);
         return false;
     }
 
-    // Handle palette if needed
-    const uint16_t palette_entries  = 1u << info->bpp;
-    bool           needs_pixconvert = false;
+    // Handle palette if needed, converting it to native format
+    bool palette_ok = true;
     if (info->has_palette) {
         // Load the palette from the stream
-        if (!qp_internal_load_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp)) {
-            return false;
-        }
-
-        needs_pixconvert = true;
-    } else {
-        if (info->bpp <= 8) {
-            // Interpolate from fg/bg
-            needs_pixconvert = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
-        }
+        palette_ok = qp_internal_convert_qgf_palette(device, (qp_stream_t *)&qgf_image->stream, info->bpp);
+    } else if (info->bpp <= 8) {
+        // Interpolate from fg/bg
+        palette_ok = qp_internal_recolor_palette(device, fg_hsv888, bg_hsv888, 1u << info->bpp);
     }
 
-    if (needs_pixconvert) {
-        // Convert the palette to native format
-        if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
-            qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
-            return false;
-        }
+    if (!palette_ok) {
+        qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
+        return false;
     }
 
     // Handle delta if needed
@@ -276,6 +289,7 @@ static bool qp_drawimage_recolor_impl(painter_device_t device, uint16_t x, uint1
     } else if (frame_info->bpp != driver->native_bits_per_pixel) {
         // Prevent stuff like drawing 24bpp images on 16bpp displays
         qp_dprintf("Image's bpp doesn't match the target display's native_bits_per_pixel\n");
+        qp_comms_stop(device);
         return false;
     } else {
         // Set up the output state
@@ -321,15 +335,154 @@ typedef struct animation_state_t {
     qp_pixel_t             bg_hsv888;
     uint16_t               frame_number;
     deferred_token         defer_token;
+
+    // Optional arena holding already-decoded frames, see qp_animation_set_cache()
+    uint8_t *cache;
+    uint32_t cache_size;
+    uint32_t cache_used;
+    uint16_t cache_frames; // frames are cached in order, starting from the first
+    bool     cache_full;
 } animation_state_t;
 
 static deferred_executor_t animation_executors[QUANTUM_PAINTER_CONCURRENT_ANIMATIONS] = {0};
 static animation_state_t   animation_states[QUANTUM_PAINTER_CONCURRENT_ANIMATIONS]    = {0};
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Animation frame cache
+
+// Each cached frame is this header followed by the native pixel data for the region it covers
+typedef struct animation_cache_entry_t {
+    uint32_t size;   // including this header, padded so the next entry stays aligned
+    uint16_t left;   // relative to the image, inclusive
+    uint16_t top;    // relative to the image, inclusive
+    uint16_t right;  // relative to the image, inclusive
+    uint16_t bottom; // relative to the image, inclusive
+    uint16_t delay;
+} animation_cache_entry_t;
+
+typedef struct animation_cache_output_state_t {
+    painter_device_t device;
+    uint8_t *        target;
+    uint32_t         write_pos;
+} animation_cache_output_state_t;
+
+static uint32_t qp_animation_cache_entry_size(painter_device_t device, uint32_t pixel_count) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    uint32_t          bytes  = (pixel_count * driver->native_bits_per_pixel + 7) / 8;
+    return sizeof(animation_cache_entry_t) + ((bytes + 3) & ~3u);
+}
+
+static bool qp_animation_cache_pixel_appender(qp_pixel_t *palette, uint8_t index, void *cb_arg) {
+    animation_cache_output_state_t *state  = (animation_cache_output_state_t *)cb_arg;
+    painter_driver_t *              driver = (painter_driver_t *)state->device;
+    return driver->driver_vtable->append_pixels(state->device, state->target, palette, state->write_pos++, 1, &index);
+}
+
+static bool qp_animation_cache_byte_appender(uint8_t byteval, void *cb_arg) {
+    animation_cache_output_state_t *state  = (animation_cache_output_state_t *)cb_arg;
+    painter_driver_t *              driver = (painter_driver_t *)state->device;
+    return driver->driver_vtable->append_pixdata(state->device, state->target, state->write_pos++, byteval);
+}
+
+static animation_cache_entry_t *qp_animation_cache_find(animation_state_t *state, uint16_t frame_number) {
+    if (frame_number >= state->cache_frames) {
+        return NULL;
+    }
+
+    uint8_t *p = state->cache;
+    for (uint16_t i = 0; i < frame_number; ++i) {
+        p += ((animation_cache_entry_t *)p)->size;
+    }
+    return (animation_cache_entry_t *)p;
+}
+
+// Decodes the current frame into the arena, returning NULL if it doesn't fit
+static animation_cache_entry_t *qp_animation_cache_store(animation_state_t *state) {
+    painter_driver_t *  driver    = (painter_driver_t *)state->device;
+    qgf_image_handle_t *qgf_image = (qgf_image_handle_t *)state->image;
+    qgf_frame_info_t    info      = {0};
+    if (!qp_drawimage_prepare_frame_for_stream_read(state->device, qgf_image, state->frame_number, state->fg_hsv888, state->bg_hsv888, &info)) {
+        return NULL;
+    }
+
+    // Work out the area covered by this frame
+    animation_cache_entry_t header = {.left = 0, .top = 0, .right = state->image->width - 1, .bottom = state->image->height - 1, .delay = info.delay};
+    if (info.is_delta) {
+        header.left   = info.left;
+        header.top    = info.top;
+        header.right  = info.right - 1;
+        header.bottom = info.bottom - 1;
+    }
+    uint32_t pixel_count = ((uint32_t)(header.right - header.left + 1)) * (header.bottom - header.top + 1);
+
+    header.size = qp_animation_cache_entry_size(state->device, pixel_count);
+    if (header.size > state->cache_size - state->cache_used) {
+        qp_dprintf("qp_animation_cache_store: arena full at frame %d\n", (int)state->frame_number);
+        state->cache_full = true;
+        return NULL;
+    }
+
+    qp_internal_byte_input_state_t  input_state    = {.device = state->device, .src_stream = &qgf_image->stream};
+    qp_internal_byte_input_callback input_callback = qp_internal_prepare_input_state(&input_state, info.compression_scheme);
+    if (input_callback == NULL) {
+        return NULL;
+    }
+
+    // Decode straight into the arena, converting to the display's native format on the way
+    animation_cache_entry_t *      entry        = (animation_cache_entry_t *)(state->cache + state->cache_used);
+    animation_cache_output_state_t output_state = {.device = state->device, .target = (uint8_t *)(entry + 1), .write_pos = 0};
+    bool                           ret;
+    if (info.bpp <= 8) {
+        ret = qp_internal_decode_palette(state->device, pixel_count, info.bpp, input_callback, &input_state, qp_internal_global_pixel_lookup_table, qp_animation_cache_pixel_appender, &output_state);
+    } else if (info.bpp == driver->native_bits_per_pixel) {
+        ret = qp_internal_send_bytes(state->device, pixel_count * info.bpp / 8, input_callback, &input_state, qp_animation_cache_byte_appender, &output_state);
+    } else {
+        ret = false;
+    }
+
+    if (!ret) {
+        return NULL;
+    }
+
+    *entry = header;
+    state->cache_used += header.size;
+    state->cache_frames++;
+    return entry;
+}
+
+static bool qp_animation_cache_blit(animation_state_t *state, animation_cache_entry_t *entry) {
+    painter_driver_t *driver      = (painter_driver_t *)state->device;
+    uint32_t          pixel_count = ((uint32_t)(entry->right - entry->left + 1)) * (entry->bottom - entry->top + 1);
+
+    if (!qp_comms_start(state->device)) {
+        qp_dprintf("qp_animation_cache_blit: fail (could not start comms)\n");
+        return false;
+    }
+
+    bool ret = driver->driver_vtable->viewport(state->device, state->x + entry->left, state->y + entry->top, state->x + entry->right, state->y + entry->bottom) && driver->driver_vtable->pixdata(state->device, entry + 1, pixel_count);
+    qp_comms_stop(state->device);
+    return ret;
+}
+
+static bool qp_render_animation_frame(animation_state_t *state, qgf_frame_info_t *frame_info) {
+    if (state->cache) {
+        animation_cache_entry_t *entry = qp_animation_cache_find(state, state->frame_number);
+        if (!entry && !state->cache_full && state->frame_number == state->cache_frames) {
+            entry = qp_animation_cache_store(state);
+        }
+        if (entry) {
+            frame_info->delay = entry->delay;
+            return qp_animation_cache_blit(state, entry);
+        }
+    }
+
+    return qp_drawimage_recolor_impl(state->device, state->x, state->y, state->image, state->frame_number, frame_info, state->fg_hsv888, state->bg_hsv888);
+}
+
 static deferred_token qp_render_animation_state(animation_state_t *state, uint16_t *delay_ms) {
     qgf_frame_info_t frame_info = {0};
     qp_dprintf("qp_render_animation_state: entry (frame #%d)\n", (int)state->frame_number);
-    bool ret = qp_drawimage_recolor_impl(state->device, state->x, state->y, state->image, state->frame_number, &frame_info, state->fg_hsv888, state->bg_hsv888);
+    bool ret = qp_render_animation_frame(state, &frame_info);
     if (ret) {
         ++state->frame_number;
         if (state->frame_number >= state->image->frame_count) {
@@ -377,6 +530,7 @@ deferred_token qp_animate_recolor(painter_device_t device, uint16_t x, uint16_t
     anim_state->fg_hsv888    = (qp_pixel_t){.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
     anim_state->bg_hsv888    = (qp_pixel_t){.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
     anim_state->frame_number = 0;
+    anim_state->cache        = NULL;
 
     // Draw the first frame
     uint16_t delay_ms;
@@ -411,6 +565,74 @@ void qp_stop_animation(deferred_token anim_token) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_animation_cache_size
+
+uint32_t qp_animation_cache_size(painter_device_t device, painter_image_handle_t image) {
+    qgf_image_handle_t *qgf_image = (qgf_image_handle_t *)image;
+    if (!device || !qgf_image || !qgf_image->validate_ok) {
+        qp_dprintf("qp_animation_cache_size: fail (invalid image)\n");
+        return 0;
+    }
+
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < image->frame_count; ++i) {
+        qgf_seek_to_frame_descriptor(&qgf_image->stream, i);
+
+        qgf_frame_v1_t        frame_descriptor;
+        uint8_t               bpp;
+        bool                  has_palette, is_delta;
+        painter_compression_t compression_scheme;
+        uint16_t              delay;
+        if (qp_stream_read(&frame_descriptor, sizeof(qgf_frame_v1_t), 1, &qgf_image->stream) != 1 || !qgf_parse_frame_descriptor(&frame_descriptor, &bpp, &has_palette, &is_delta, &compression_scheme, &delay)) {
+            return 0;
+        }
+
+        uint32_t pixel_count = ((uint32_t)image->width) * image->height;
+        if (is_delta) {
+            // The delta descriptor follows the palette, if there is one
+            if (has_palette) {
+                qgf_palette_v1_t palette_descriptor;
+                if (qp_stream_read(&palette_descriptor, sizeof(qgf_palette_v1_t), 1, &qgf_image->stream) != 1) {
+                    return 0;
+                }
+                qp_stream_seek(&qgf_image->stream, palette_descriptor.header.length, SEEK_CUR);
+            }
+
+            qgf_delta_v1_t delta_descriptor;
+            if (qp_stream_read(&delta_descriptor, sizeof(qgf_delta_v1_t), 1, &qgf_image->stream) != 1) {
+                return 0;
+            }
+            pixel_count = ((uint32_t)(delta_descriptor.right - delta_descriptor.left)) * (delta_descriptor.bottom - delta_descriptor.top);
+        }
+
+        total += qp_animation_cache_entry_size(device, pixel_count);
+    }
+
+    return total;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_animation_set_cache
+
+bool qp_animation_set_cache(deferred_token anim_token, void *arena, uint32_t arena_size) {
+    for (int i = 0; i < QUANTUM_PAINTER_CONCURRENT_ANIMATIONS; ++i) {
+        animation_state_t *state = &animation_states[i];
+        if (state->device != NULL && state->defer_token == anim_token) {
+            // Start again from an empty arena, frames are added as they're next drawn
+            state->cache        = (uint8_t *)arena;
+            state->cache_size   = arena_size;
+            state->cache_used   = 0;
+            state->cache_frames = 0;
+            state->cache_full   = false;
+            return true;
+        }
+    }
+
+    qp_dprintf("qp_animation_set_cache: fail (animation not found)\n");
+    return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter Core API: qp_internal_animation_tick
 
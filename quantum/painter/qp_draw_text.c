@@ -8,10 +8,19 @@
 #include "qp_draw.h"
 #include "qp_comms.h"
 #include "qff.h"
+#include "qpa.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // QFF font handles
 
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+typedef struct qff_glyph_cache_entry_t {
+    uint32_t code_point;
+    uint32_t data_offset;
+    uint8_t  width;
+} qff_glyph_cache_entry_t;
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+
 typedef struct qff_font_handle_t {
     painter_font_desc_t   base;
     bool                  validate_ok;
@@ -20,12 +29,23 @@ typedef struct qff_font_handle_t {
     uint8_t               bpp;
     bool                  has_palette;
     painter_compression_t compression_scheme;
+    uint8_t               qff_version;
+    uint32_t              ascii_table_offset;   // offset of the first ascii glyph entry
+    uint32_t              unicode_table_offset; // offset of the first unicode glyph entry
+    uint32_t              glyph_data_offset;    // offset of the first byte of glyph data
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    qff_glyph_cache_entry_t glyph_cache[QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE]; // most recently used first
+    uint8_t                 glyph_cache_count;
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
     union {
         qp_stream_t        stream;
         qp_memory_stream_t mem_stream;
 #ifdef QP_STREAM_HAS_FILE_IO
         qp_file_stream_t file_stream;
 #endif // QP_STREAM_HAS_FILE_IO
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+        qp_flash_stream_t flash_stream;
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
     };
 #if QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
     bool  owns_buffer;
@@ -72,13 +92,16 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
     font->owns_buffer = false;
     font->buffer      = NULL;
 
-    void *ram_buffer = malloc(font->mem_stream.length);
+    // Ask the font for its size, as only memory streams know their own length
+    uint32_t font_length = qff_get_total_size(&font->stream);
+    void *   ram_buffer  = malloc(font_length);
     if (ram_buffer == NULL) {
         qp_dprintf("qp_load_font: could not allocate enough RAM for font, falling back to original\n");
     } else {
         do {
             // Copy the data into RAM
-            if (qp_stream_read(ram_buffer, 1, font->mem_stream.length, &font->mem_stream) != font->mem_stream.length) {
+            qp_stream_setpos(&font->stream, 0);
+            if (qp_stream_read(ram_buffer, 1, font_length, &font->stream) != font_length) {
                 qp_dprintf("qp_load_font: could not copy from flash to RAM, falling back to original\n");
                 break;
             }
@@ -86,7 +109,7 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
             // Create the new stream with the new buffer
             font->buffer      = ram_buffer;
             font->owns_buffer = true;
-            font->mem_stream  = qp_make_memory_stream(font->buffer, font->mem_stream.length);
+            font->mem_stream  = qp_make_memory_stream(font->buffer, font_length);
         } while (0);
     }
 
@@ -97,7 +120,24 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
 #endif // QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
 
     // Read the info (parsing already successful above, no need to check return value)
-    qff_read_font_descriptor(&font->stream, &font->base.line_height, &font->has_ascii_table, &font->num_unicode_glyphs, &font->bpp, &font->has_palette, &font->compression_scheme, NULL);
+    qff_read_font_descriptor(&font->stream, &font->base.line_height, &font->has_ascii_table, &font->num_unicode_glyphs, &font->bpp, &font->has_palette, &font->compression_scheme, NULL, &font->qff_version);
+
+    // Work out where the glyph tables and data live, so glyph lookups don't need to
+    font->ascii_table_offset = sizeof(qff_font_descriptor_v1_t) // Skip the font descriptor
+                               + sizeof(qgf_block_header_v1_t); // Skip the ascii table header
+    font->unicode_table_offset = sizeof(qff_font_descriptor_v1_t)                                       // Skip the font descriptor
+                                 + (font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0) // Skip the ascii table
+                                 + sizeof(qgf_block_header_v1_t);                                   // Skip the unicode table header
+    font->glyph_data_offset = sizeof(qff_font_descriptor_v1_t)                                                                                                             // Skip the font descriptor
+                              + (font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0)                                                                           // Skip the ascii table
+                              + (font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
+                              + (font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                 // Skip the palette
+                              + sizeof(qgf_block_header_v1_t);                                                                                                             // Skip the data block header
+
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    // Forget any glyphs cached for a font previously loaded into this slot
+    font->glyph_cache_count = 0;
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
 
     if (!qp_internal_bpp_capable(font->bpp)) {
         qp_dprintf("qp_load_font: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE or QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS)\n", (int)font->bpp);
@@ -131,6 +171,30 @@ painter_font_handle_t qp_load_font_mem(const void *buffer) {
     return qp_load_font_internal(font_mem_stream_factory, (void *)buffer);
 }
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_font_flash
+
+static inline bool font_flash_stream_factory(qff_font_handle_t *font, void *arg) {
+    uint16_t asset_index = *(uint16_t *)arg;
+
+    // Find where the font lives in flash; the asset table already knows its length
+    uint32_t address, length;
+    if (!qpa_find_flash_asset(asset_index, QPA_ASSET_FONT, &address, &length)) {
+        return false;
+    }
+
+    font->flash_stream = qp_make_flash_stream(address, length);
+    return true;
+}
+
+painter_font_handle_t qp_load_font_flash(uint16_t asset_index) {
+    return qp_load_font_internal(font_flash_stream_factory, &asset_index);
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_close_font
 
@@ -164,8 +228,6 @@ typedef bool (*code_point_handler)(qff_font_handle_t *qff_font, uint32_t code_po
 
 // Helper that sets up the palette (if required) and returns the offset in the stream that the data starts
 static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device, qff_font_handle_t *qff_font, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, uint32_t *data_offset) {
-    painter_driver_t *driver = (painter_driver_t *)device;
-
     // Drop out if we can't actually place the data we read out anywhere
     if (!data_offset) {
         qp_dprintf("Failed to prepare stream for read, output info buffer unavailable\n");
@@ -181,45 +243,117 @@ static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device,
         offset += sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * 6);
     }
 
-    // Handle palette if needed
-    const uint16_t palette_entries  = 1u << qff_font->bpp;
-    bool           needs_pixconvert = false;
+    // Handle palette if needed, converting it to native format
+    const uint16_t palette_entries = 1u << qff_font->bpp;
+    bool           palette_ok;
     if (qff_font->has_palette) {
         // If this font has a palette, we need to read it out and set up the pixel lookup table
         qp_stream_setpos(&qff_font->stream, offset);
-        if (!qp_internal_load_qgf_palette(&qff_font->stream, qff_font->bpp)) {
-            return false;
-        }
+        palette_ok = qp_internal_convert_qgf_palette(device, &qff_font->stream, qff_font->bpp);
 
         // Skip this block, as far as offset calculations go
         offset += sizeof(qgf_palette_v1_t) + (palette_entries * 3);
-        needs_pixconvert = true;
     } else {
         // Interpolate from fg/bg
-        int16_t palette_entries = 1 << qff_font->bpp;
-        needs_pixconvert        = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
+        palette_ok = qp_internal_recolor_palette(device, fg_hsv888, bg_hsv888, palette_entries);
     }
 
-    if (needs_pixconvert) {
-        // Convert the palette to native format
-        if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
-            qp_dprintf("qp_drawtext_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
-            return false;
-        }
+    if (!palette_ok) {
+        qp_dprintf("qp_drawtext_recolor: fail (could not convert pixels to native)\n");
+        qp_comms_stop(device);
+        return false;
     }
 
     *data_offset = offset;
     return true;
 }
 
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+// Looks up a code point in the glyph cache, moving it to the front on a hit
+static bool qp_drawtext_glyph_cache_find(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t *width, uint32_t *data_offset) {
+    for (uint8_t i = 0; i < qff_font->glyph_cache_count; ++i) {
+        if (qff_font->glyph_cache[i].code_point == code_point) {
+            qff_glyph_cache_entry_t entry = qff_font->glyph_cache[i];
+            memmove(&qff_font->glyph_cache[1], &qff_font->glyph_cache[0], i * sizeof(qff_glyph_cache_entry_t));
+            qff_font->glyph_cache[0] = entry;
+            *width                   = entry.width;
+            *data_offset             = entry.data_offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Adds a code point to the front of the glyph cache, evicting the least recently used entry if full
+static void qp_drawtext_glyph_cache_insert(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint32_t data_offset) {
+    if (qff_font->glyph_cache_count < QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE) {
+        qff_font->glyph_cache_count++;
+    }
+    memmove(&qff_font->glyph_cache[1], &qff_font->glyph_cache[0], (qff_font->glyph_cache_count - 1) * sizeof(qff_glyph_cache_entry_t));
+    qff_font->glyph_cache[0] = (qff_glyph_cache_entry_t){.code_point = code_point, .data_offset = data_offset, .width = width};
+}
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+
+// Helper that finds the glyph info for a code point in the unicode table
+static inline bool qp_drawtext_find_unicode_glyph(qff_font_handle_t *qff_font, uint32_t code_point, uint32_t *glyph_value) {
+    qff_unicode_glyph_v1_t glyph_info;
+
+    if (qff_font->qff_version >= QFF_VERSION_2) {
+        // Table is sorted by code point, binary search it
+        uint16_t lo = 0;
+        uint16_t hi = qff_font->num_unicode_glyphs;
+        while (lo < hi) {
+            uint16_t mid = lo + (hi - lo) / 2;
+            if (qp_stream_setpos(&qff_font->stream, qff_font->unicode_table_offset + (uint32_t)mid * sizeof(qff_unicode_glyph_v1_t)) < 0) {
+                qp_dprintf("Failed to set stream position while reading unicode glyph info\n");
+                return false;
+            }
+
+            if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
+                qp_dprintf("Failed to read unicode glyph info\n");
+                return false;
+            }
+
+            if (glyph_info.code_point == code_point) {
+                *glyph_value = glyph_info.value;
+                return true;
+            } else if (glyph_info.code_point < code_point) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return false;
+    }
+
+    // Version 1 fonts make no guarantees about ordering, scan the whole table
+    if (qp_stream_setpos(&qff_font->stream, qff_font->unicode_table_offset) < 0) {
+        qp_dprintf("Failed to set stream position while preparing glyph data\n");
+        return false;
+    }
+
+    for (uint16_t i = 0; i < qff_font->num_unicode_glyphs; ++i) {
+        if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
+            qp_dprintf("Failed to read unicode glyph info\n");
+            return false;
+        }
+
+        if (glyph_info.code_point == code_point) {
+            *glyph_value = glyph_info.value;
+            return true;
+        }
+    }
+    return false;
+}
+
 static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t *width) {
+    uint32_t glyph_value;
+    uint32_t data_offset;
+
     if (code_point >= 0x20 && code_point < 0x7F && qff_font->has_ascii_table) {
         // Do ascii table
         qff_ascii_glyph_v1_t glyph_info;
-        uint32_t             glyph_info_offset = sizeof(qff_font_descriptor_v1_t)          // Skip the font descriptor
-                                     + sizeof(qgf_block_header_v1_t)                       // Skip the ascii table header
-                                     + (code_point - 0x20) * sizeof(qff_ascii_glyph_v1_t); // Jump direct to the data offset based on the glyph index
+        uint32_t             glyph_info_offset = qff_font->ascii_table_offset + (code_point - 0x20) * sizeof(qff_ascii_glyph_v1_t); // Jump direct to the data offset based on the glyph index
         if (qp_stream_setpos(&qff_font->stream, glyph_info_offset) < 0) {
             qp_dprintf("Failed to set stream position while reading ascii glyph info\n");
             return false;
@@ -230,65 +364,41 @@ static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_f
             return false;
         }
 
-        uint8_t  glyph_width  = (uint8_t)(glyph_info.value & QFF_GLYPH_WIDTH_MASK);
-        uint32_t glyph_offset = ((glyph_info.value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
-        uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
-                               + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0)                                                                              // Skip the ascii table
-                               + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
-                               + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
-                               + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
-                               + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
-
-        if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing ascii glyph data\n");
-            return false;
-        }
-
-        *width = glyph_width;
-        return true;
+        glyph_value = glyph_info.value;
     } else {
         // Do unicode table, which may include singular ascii glyphs if full ascii table isn't specified
-        uint32_t glyph_info_offset = sizeof(qff_font_descriptor_v1_t)                                       // Skip the font descriptor
-                                     + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0) // Skip the ascii table
-                                     + sizeof(qgf_block_header_v1_t);                                       // Skip the unicode block header
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+        if (qp_drawtext_glyph_cache_find(qff_font, code_point, width, &data_offset)) {
+            if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
+                qp_dprintf("Failed to set stream position while preparing unicode glyph data\n");
+                return false;
+            }
+            return true;
+        }
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
 
-        if (qp_stream_setpos(&qff_font->stream, glyph_info_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing glyph data\n");
+        if (!qp_drawtext_find_unicode_glyph(qff_font, code_point, &glyph_value)) {
+            qp_dprintf("Failed to find unicode glyph info\n");
             return false;
         }
+    }
 
-        qff_unicode_glyph_v1_t glyph_info;
-        for (uint16_t i = 0; i < qff_font->num_unicode_glyphs; ++i) {
-            if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
-                qp_dprintf("Failed to set stream position while reading unicode glyph info\n");
-                return false;
-            }
+    uint8_t glyph_width = (uint8_t)(glyph_value & QFF_GLYPH_WIDTH_MASK);
+    data_offset         = qff_font->glyph_data_offset + ((glyph_value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS); // Jump to the specified glyph offset
 
-            if (glyph_info.code_point == code_point) {
-                uint8_t  glyph_width  = (uint8_t)(glyph_info.value & QFF_GLYPH_WIDTH_MASK);
-                uint32_t glyph_offset = ((glyph_info.value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
-                uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
-                                       + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0)                                                                              // Skip the ascii table
-                                       + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
-                                       + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
-                                       + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
-                                       + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
-
-                if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-                    qp_dprintf("Failed to set stream position while preparing unicode glyph data\n");
-                    return false;
-                }
-
-                *width = glyph_width;
-                return true;
-            }
-        }
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    if (!(code_point >= 0x20 && code_point < 0x7F && qff_font->has_ascii_table)) {
+        qp_drawtext_glyph_cache_insert(qff_font, code_point, glyph_width, data_offset);
+    }
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
 
-        // Not found
-        qp_dprintf("Failed to find unicode glyph info\n");
+    if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
+        qp_dprintf("Failed to set stream position while preparing glyph data\n");
         return false;
     }
-    return false;
+
+    *width = glyph_width;
+    return true;
 }
 
 // Function to iterate over each UTF8 codepoint, invoking the callback for each decoded glyph
@@ -351,8 +461,8 @@ static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_f
     code_point_iter_drawglyph_state_t *state  = (code_point_iter_drawglyph_state_t *)cb_arg;
     painter_driver_t *                 driver = (painter_driver_t *)state->device;
 
-    // Reset the input state's RLE mode -- the stream should already be correctly positioned by qp_iterate_code_points()
-    state->input_state->rle.mode = MARKER_BYTE; // ignored if not using RLE
+    // Reset the input state's decoder -- the stream should already be correctly positioned by qp_iterate_code_points()
+    qp_internal_prepare_input_state(state->input_state, qff_font->compression_scheme);
 
     // Reset the output state
     state->output_state->pixel_write_pos = 0;
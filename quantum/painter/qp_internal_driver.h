@@ -17,6 +17,9 @@ typedef bool (*painter_driver_pixdata_func)(painter_device_t device, const void
 typedef bool (*painter_driver_convert_palette_func)(painter_device_t device, int16_t palette_size, qp_pixel_t *palette);
 typedef bool (*painter_driver_append_pixels)(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices);
 typedef bool (*painter_driver_append_pixdata)(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte);
+typedef bool (*painter_driver_fill_pixels)(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count);
+typedef bool (*painter_driver_scroll_func)(painter_device_t device, uint16_t top, uint16_t bottom, uint16_t offset);
+typedef bool (*painter_driver_blit_func)(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom, uint16_t x, uint16_t y);
 
 // Driver vtable definition
 typedef struct painter_driver_vtable_t {
@@ -29,6 +32,9 @@ typedef struct painter_driver_vtable_t {
     painter_driver_convert_palette_func palette_convert;
     painter_driver_append_pixels        append_pixels;
     painter_driver_append_pixdata       append_pixdata;
+    painter_driver_fill_pixels          fill_pixels; // optional, append_pixels is used for each pixel if not supplied
+    painter_driver_scroll_func          scroll;      // optional, qp_scroll fails if not supplied
+    painter_driver_blit_func            blit;        // optional, qp_blit fails if not supplied
 } painter_driver_vtable_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,111 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter solid color fill helpers
+//
+// These fill a run of native pixels with a single color, for use by drivers' fill_pixels implementations. They write
+// whole 32-bit words wherever the buffer alignment allows, instead of one pixel at a time. Sub-byte formats are packed
+// least significant bits first, matching QGF images.
+
+// Fills `count` 16bpp pixels starting at pixel `offset`.
+static inline void qp_internal_fill_16bpp(uint8_t *buffer, uint32_t offset, uint32_t count, uint16_t value) {
+    uint16_t *p = ((uint16_t *)buffer) + offset;
+    if (count > 0 && ((uintptr_t)p & 2)) {
+        *p++ = value;
+        --count;
+    }
+
+    uint32_t  pattern = ((uint32_t)value << 16) | value;
+    uint32_t *w       = (uint32_t *)p;
+    for (uint32_t n = count / 2; n > 0; --n) {
+        *w++ = pattern;
+    }
+
+    if (count & 1) {
+        *(uint16_t *)w = value;
+    }
+}
+
+// Fills `count` 24bpp pixels starting at pixel `offset`, with the bytes in the order supplied.
+static inline void qp_internal_fill_24bpp(uint8_t *buffer, uint32_t offset, uint32_t count, uint8_t b0, uint8_t b1, uint8_t b2) {
+    uint8_t *p = buffer + offset * 3;
+
+    // Pixels are 3 bytes, so at most three are needed to reach a word boundary
+    while (count > 0 && ((uintptr_t)p & 3)) {
+        p[0] = b0;
+        p[1] = b1;
+        p[2] = b2;
+        p += 3;
+        --count;
+    }
+
+    // Four pixels make up three whole words
+    if (count >= 4) {
+        const uint8_t pattern[12] = {b0, b1, b2, b0, b1, b2, b0, b1, b2, b0, b1, b2};
+        uint32_t      w0, w1, w2;
+        memcpy(&w0, &pattern[0], sizeof(w0));
+        memcpy(&w1, &pattern[4], sizeof(w1));
+        memcpy(&w2, &pattern[8], sizeof(w2));
+
+        uint32_t *w = (uint32_t *)p;
+        for (uint32_t n = count / 4; n > 0; --n) {
+            w[0] = w0;
+            w[1] = w1;
+            w[2] = w2;
+            w += 3;
+        }
+        p = (uint8_t *)w;
+        count &= 3;
+    }
+
+    while (count > 0) {
+        p[0] = b0;
+        p[1] = b1;
+        p[2] = b2;
+        p += 3;
+        --count;
+    }
+}
+
+// Sets a single 1, 2 or 4bpp pixel, leaving the other pixels sharing its byte untouched.
+static inline void qp_internal_fill_packed_pixel(uint8_t *buffer, uint8_t bpp, uint32_t index, uint8_t value) {
+    uint8_t  pixels_per_byte = 8 / bpp;
+    uint8_t  shift           = (index % pixels_per_byte) * bpp;
+    uint8_t  mask            = ((1 << bpp) - 1) << shift;
+    uint8_t *byte            = &buffer[index / pixels_per_byte];
+    *byte                    = (*byte & ~mask) | ((value << shift) & mask);
+}
+
+// Fills `count` 1, 2, 4 or 8bpp pixels starting at pixel `offset`.
+static inline void qp_internal_fill_packed(uint8_t *buffer, uint8_t bpp, uint32_t offset, uint32_t count, uint8_t value) {
+    if (bpp == 8) {
+        memset(buffer + offset, value, count);
+        return;
+    }
+
+    // Partial leading byte
+    uint8_t pixels_per_byte = 8 / bpp;
+    while (count > 0 && (offset % pixels_per_byte) != 0) {
+        qp_internal_fill_packed_pixel(buffer, bpp, offset++, value);
+        --count;
+    }
+
+    // Whole bytes, with the value replicated across every pixel in the byte
+    uint8_t byte = value & ((1 << bpp) - 1);
+    for (uint8_t shift = bpp; shift < 8; shift <<= 1) {
+        byte |= byte << shift;
+    }
+    uint32_t whole_pixels = count - (count % pixels_per_byte);
+    memset(buffer + offset / pixels_per_byte, byte, whole_pixels / pixels_per_byte);
+
+    // Partial trailing byte
+    for (offset += whole_pixels, count -= whole_pixels; count > 0; --count) {
+        qp_internal_fill_packed_pixel(buffer, bpp, offset++, value);
+    }
+}
@@ -48,4 +48,4 @@ typedef enum qp_image_format_t {
     RGB888_24BPP   = 0x09,
 } qp_image_format_t;
 
-typedef enum painter_compression_t { IMAGE_UNCOMPRESSED, IMAGE_COMPRESSED_RLE } painter_compression_t;
+typedef enum painter_compression_t { IMAGE_UNCOMPRESSED, IMAGE_COMPRESSED_RLE, IMAGE_COMPRESSED_LZ } painter_compression_t;
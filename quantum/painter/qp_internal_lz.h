@@ -0,0 +1,71 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter LZ decoder
+//
+// Streams out the bytes of data compressed with `compress_bytes_qmk_lz()` in lib/python/qmk/painter.py -- see
+// docs/quantum_painter_lz.md for the format. Copies only ever refer back to the last 256 decoded bytes, so the caller
+// supplies a 256-byte window which is indexed with a wrapping uint8_t.
+
+#define QP_LZ_WINDOW_SIZE 256
+#define QP_LZ_MIN_MATCH 3
+
+typedef int16_t (*qp_internal_lz_input_callback)(void *cb_arg);
+
+typedef struct qp_internal_lz_state_t {
+    uint8_t remain;  // number of bytes remaining in the current literal run or copy
+    uint8_t offset;  // one less than the distance back into the window of the current copy
+    uint8_t pos;     // window position the next decoded byte is written to
+    bool    copying; // whether the current run is a copy rather than literals
+} qp_internal_lz_state_t;
+
+static inline void qp_internal_lz_reset(qp_internal_lz_state_t *state) {
+    state->remain  = 0;
+    state->pos     = 0;
+    state->copying = false;
+}
+
+// Returns the next decoded byte, or a negative value if the input ran out.
+static inline int16_t qp_internal_lz_decode_byte(qp_internal_lz_state_t *state, uint8_t *window, qp_internal_lz_input_callback input_callback, void *input_arg) {
+    // Work out if we're parsing a marker byte
+    if (state->remain == 0) {
+        int16_t marker = input_callback(input_arg);
+        if (marker < 0) {
+            return marker;
+        }
+
+        if (marker < 128) {
+            state->copying = false;
+            state->remain  = marker + 1;
+        } else {
+            int16_t offset = input_callback(input_arg);
+            if (offset < 0) {
+                return offset;
+            }
+            state->copying = true;
+            state->remain  = marker - 128 + QP_LZ_MIN_MATCH;
+            state->offset  = offset;
+        }
+    }
+
+    int16_t c;
+    if (state->copying) {
+        // Copies may overlap the bytes they produce, so read back out of the window one byte at a time
+        c = window[(uint8_t)(state->pos - state->offset - 1)];
+    } else {
+        c = input_callback(input_arg);
+        if (c < 0) {
+            return c;
+        }
+    }
+
+    window[state->pos++] = (uint8_t)c;
+    state->remain--;
+    return c;
+}
@@ -3,10 +3,23 @@
 
 #include "qp_stream.h"
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+#    include <string.h>
+#    include "flash_spi.h"
+#    ifdef QUANTUM_PAINTER_SPI_ENABLE
+#        include "qp_comms.h"
+#    endif // QUANTUM_PAINTER_SPI_ENABLE
+#endif     // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Stream API
 
 uint32_t qp_stream_read_impl(void *output_buf, uint32_t member_size, uint32_t num_members, qp_stream_t *stream) {
+    // Let the stream copy the whole lot at once if it knows how to
+    if (stream->read) {
+        return stream->read(stream, output_buf, num_members * member_size) / member_size;
+    }
+
     uint8_t *output_ptr = (uint8_t *)output_buf;
 
     uint32_t i;
@@ -164,3 +177,183 @@ qp_file_stream_t qp_make_file_stream(FILE *f) {
     return stream;
 }
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// External flash streams
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+// Read-ahead buffer, shared between all flash streams as only one asset is decoded at any one time. Keyed by absolute
+// flash address, so switching between streams over the same data doesn't force a re-read.
+static uint8_t  flash_read_ahead[QUANTUM_PAINTER_FLASH_READ_AHEAD_SIZE];
+static uint32_t flash_read_ahead_address = 0;
+static uint32_t flash_read_ahead_length  = 0;
+
+static inline bool flash_read_direct(uint32_t address, void *buf, uint32_t length) {
+#    ifdef QUANTUM_PAINTER_SPI_ENABLE
+    // The flash is likely to share its SPI bus with the display, which holds the bus for the duration of a draw
+    painter_device_t suspended = qp_comms_suspend();
+#    endif // QUANTUM_PAINTER_SPI_ENABLE
+
+    flash_status_t status = flash_read_block(address, buf, length);
+
+#    ifdef QUANTUM_PAINTER_SPI_ENABLE
+    qp_comms_resume(suspended);
+#    endif // QUANTUM_PAINTER_SPI_ENABLE
+
+    return status == FLASH_STATUS_SUCCESS;
+}
+
+static inline bool flash_fill_read_ahead(qp_flash_stream_t *s) {
+    uint32_t address = s->address + s->position;
+    uint32_t length  = s->length - s->position;
+    if (length > sizeof(flash_read_ahead)) {
+        length = sizeof(flash_read_ahead);
+    }
+
+    if (!flash_read_direct(address, flash_read_ahead, length)) {
+        flash_read_ahead_length = 0;
+        return false;
+    }
+
+    flash_read_ahead_address = address;
+    flash_read_ahead_length  = length;
+    return true;
+}
+
+static inline int16_t flash_get(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return STREAM_EOF;
+    }
+
+    // Unsigned wraparound means addresses before the start of the read-ahead buffer also count as a miss
+    uint32_t index = s->address + s->position - flash_read_ahead_address;
+    if (index >= flash_read_ahead_length) {
+        if (!flash_fill_read_ahead(s)) {
+            s->is_eof = true;
+            return STREAM_EOF;
+        }
+        index = 0;
+    }
+
+    s->position++;
+    return flash_read_ahead[index];
+}
+
+static uint32_t flash_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_flash_stream_t *s          = (qp_flash_stream_t *)stream;
+    uint8_t *          output_ptr = (uint8_t *)output_buf;
+
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return 0;
+    }
+    if (length > (uint32_t)(s->length - s->position)) {
+        length    = s->length - s->position;
+        s->is_eof = true;
+    }
+
+    uint32_t remaining = length;
+    while (remaining > 0) {
+        uint32_t address = s->address + s->position;
+        uint32_t index   = address - flash_read_ahead_address;
+        uint32_t chunk;
+        if (index < flash_read_ahead_length) {
+            // Serve whatever we can from the read-ahead buffer
+            chunk = flash_read_ahead_length - index;
+            if (chunk > remaining) {
+                chunk = remaining;
+            }
+            memcpy(output_ptr, &flash_read_ahead[index], chunk);
+        } else if (remaining >= sizeof(flash_read_ahead)) {
+            // Large sequential reads go straight into the caller's buffer in a single transaction
+            chunk = remaining;
+            if (!flash_read_direct(address, output_ptr, chunk)) {
+                s->is_eof = true;
+                break;
+            }
+        } else {
+            if (!flash_fill_read_ahead(s)) {
+                s->is_eof = true;
+                break;
+            }
+            continue;
+        }
+
+        output_ptr += chunk;
+        s->position += chunk;
+        remaining -= chunk;
+    }
+
+    return length - remaining;
+}
+
+static inline bool flash_put(qp_stream_t *stream, uint8_t c) {
+    // Assets are written to flash ahead of time, the stream is read-only.
+    return false;
+}
+
+static inline int flash_seek(qp_stream_t *stream, int32_t offset, int origin) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+
+    // Handle as per fseek
+    int32_t position = s->position;
+    switch (origin) {
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position += offset;
+            break;
+        case SEEK_END:
+            position = s->length + offset;
+            break;
+        default:
+            return -1;
+    }
+
+    // Out of bounds either way is a failure, being at the end is okay -- as per lseek()
+    if (position < 0 || position > s->length) {
+        return -1;
+    }
+
+    // Update the offset, clearing the EOF flag as per fseek()
+    s->position = position;
+    s->is_eof   = false;
+
+    return 0;
+}
+
+static inline int32_t flash_tell(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->position;
+}
+
+static inline bool flash_is_eof(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->is_eof;
+}
+
+static inline void flash_close(qp_stream_t *stream) {
+    // No-op.
+}
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length) {
+    static bool flash_initialised = false;
+    if (!flash_initialised) {
+        flash_init();
+        flash_initialised = true;
+    }
+
+    qp_flash_stream_t stream = {
+        .base     = {.get = flash_get, .put = flash_put, .seek = flash_seek, .tell = flash_tell, .is_eof = flash_is_eof, .close = flash_close, .read = flash_read},
+        .address  = address,
+        .length   = length,
+        .position = 0,
+    };
+    return stream;
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
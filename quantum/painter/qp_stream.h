@@ -55,6 +55,7 @@ typedef struct qp_stream_t {
     int32_t (*tell)(qp_stream_t *stream);
     bool (*is_eof)(qp_stream_t *stream);
     void (*close)(qp_stream_t *stream);
+    uint32_t (*read)(qp_stream_t *stream, void *output_buf, uint32_t length); // optional, bulk reads fall back to get() if NULL
 } qp_stream_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -83,3 +84,20 @@ typedef struct qp_file_stream_t {
 qp_file_stream_t qp_make_file_stream(FILE *f);
 
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// External flash streams
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+typedef struct qp_flash_stream_t {
+    qp_stream_t base;
+    uint32_t    address;
+    int32_t     length;
+    int32_t     position;
+    bool        is_eof;
+} qp_flash_stream_t;
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length);
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
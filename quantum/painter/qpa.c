@@ -0,0 +1,119 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Quantum Painter Asset "QPA" bundle format.
+// See https://docs.qmk.fm/#/quantum_painter_qpa for more information.
+
+#include "qpa.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QPA API
+
+bool qpa_read_bundle_descriptor(qp_stream_t *stream, uint16_t *asset_count, uint32_t *total_bytes) {
+    // Seek to the start
+    qp_stream_setpos(stream, 0);
+
+    // Read and validate the bundle descriptor
+    qpa_bundle_descriptor_v1_t bundle_descriptor;
+    if (qp_stream_read(&bundle_descriptor, sizeof(qpa_bundle_descriptor_v1_t), 1, stream) != 1) {
+        qp_dprintf("Failed to read bundle_descriptor, expected length was not %d\n", (int)sizeof(qpa_bundle_descriptor_v1_t));
+        return false;
+    }
+
+    // Make sure this block is valid
+    if (!qgf_validate_block_header(&bundle_descriptor.header, QPA_BUNDLE_DESCRIPTOR_TYPEID, (sizeof(qpa_bundle_descriptor_v1_t) - sizeof(qgf_block_header_v1_t)))) {
+        return false;
+    }
+
+    // Make sure the magic and version are correct
+    if (bundle_descriptor.magic != QPA_MAGIC || bundle_descriptor.qpa_version != 0x01) {
+        qp_dprintf("Failed to validate bundle_descriptor, expected magic 0x%06X was 0x%06X, expected version = 0x%02X was 0x%02X\n", (int)QPA_MAGIC, (int)bundle_descriptor.magic, (int)0x01, (int)bundle_descriptor.qpa_version);
+        return false;
+    }
+
+    // Make sure the file length is valid
+    if (bundle_descriptor.neg_total_file_size != ~bundle_descriptor.total_file_size) {
+        qp_dprintf("Failed to validate bundle_descriptor, expected negated length 0x%08X was 0x%08X\n", (int)(~bundle_descriptor.total_file_size), (int)bundle_descriptor.neg_total_file_size);
+        return false;
+    }
+
+    // Copy out the required info
+    if (asset_count) {
+        *asset_count = bundle_descriptor.asset_count;
+    }
+    if (total_bytes) {
+        *total_bytes = bundle_descriptor.total_file_size;
+    }
+
+    return true;
+}
+
+bool qpa_find_asset(qp_stream_t *stream, uint16_t asset_index, qpa_asset_type_t type, uint32_t *offset, uint32_t *length) {
+    uint16_t asset_count;
+    uint32_t total_bytes;
+    if (!qpa_read_bundle_descriptor(stream, &asset_count, &total_bytes)) {
+        return false;
+    }
+
+    // Read and validate the asset table header
+    qpa_asset_table_v1_t asset_table;
+    if (qp_stream_read(&asset_table, sizeof(qpa_asset_table_v1_t), 1, stream) != 1) {
+        qp_dprintf("Failed to read asset_table, expected length was not %d\n", (int)sizeof(qpa_asset_table_v1_t));
+        return false;
+    }
+
+    if (!qgf_validate_block_header(&asset_table.header, QPA_ASSET_TABLE_TYPEID, (asset_count * sizeof(qpa_asset_v1_t)))) {
+        return false;
+    }
+
+    if (asset_index >= asset_count) {
+        qp_dprintf("Invalid asset index, was %d but only %d assets in bundle\n", (int)asset_index, (int)asset_count);
+        return false;
+    }
+
+    // Skip the necessary amount of data to get to the requested asset
+    qp_stream_seek(stream, asset_index * sizeof(qpa_asset_v1_t), SEEK_CUR);
+
+    qpa_asset_v1_t asset;
+    if (qp_stream_read(&asset, sizeof(qpa_asset_v1_t), 1, stream) != 1) {
+        qp_dprintf("Failed to read asset, expected length was not %d\n", (int)sizeof(qpa_asset_v1_t));
+        return false;
+    }
+
+    if (asset.type != type) {
+        qp_dprintf("Asset %d has type 0x%02X, expected 0x%02X\n", (int)asset_index, (int)asset.type, (int)type);
+        return false;
+    }
+
+    // Make sure the asset lies within the bundle
+    if (asset.offset > total_bytes || asset.length > (total_bytes - asset.offset)) {
+        qp_dprintf("Asset %d at offset %d with length %d overflows the bundle (%d bytes)\n", (int)asset_index, (int)asset.offset, (int)asset.length, (int)total_bytes);
+        return false;
+    }
+
+    *offset = asset.offset;
+    *length = asset.length;
+    return true;
+}
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+bool qpa_find_flash_asset(uint16_t asset_index, qpa_asset_type_t type, uint32_t *address, uint32_t *length) {
+    // Assume we can read the bundle descriptor, then extend the stream to cover the whole bundle
+    qp_flash_stream_t stream = qp_make_flash_stream(QUANTUM_PAINTER_FLASH_ASSETS_ADDRESS, sizeof(qpa_bundle_descriptor_v1_t));
+    uint32_t          total_bytes;
+    if (!qpa_read_bundle_descriptor(&stream.base, NULL, &total_bytes)) {
+        return false;
+    }
+    stream.length = total_bytes;
+
+    uint32_t offset;
+    if (!qpa_find_asset(&stream.base, asset_index, type, &offset, length)) {
+        return false;
+    }
+
+    *address = QUANTUM_PAINTER_FLASH_ASSETS_ADDRESS + offset;
+    return true;
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
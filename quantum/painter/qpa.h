@@ -0,0 +1,67 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// Quantum Painter Asset "QPA" bundle format.
+// See https://docs.qmk.fm/#/quantum_painter_qpa for more information.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qp_stream.h"
+#include "qp_internal.h"
+#include "qgf.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QPA structures
+
+/////////////////////////////////////////
+// Bundle descriptor
+
+#define QPA_BUNDLE_DESCRIPTOR_TYPEID 0x10
+
+typedef struct QP_PACKED qpa_bundle_descriptor_v1_t {
+    qgf_block_header_v1_t header;              // = { .type_id = 0x10, .neg_type_id = (~0x10), .length = 14 }
+    uint32_t              magic : 24;          // constant, equal to 0x415051 ("QPA")
+    uint8_t               qpa_version;         // constant, equal to 0x01
+    uint32_t              total_file_size;     // total size of the entire bundle, starting at offset zero
+    uint32_t              neg_total_file_size; // negated value of total_file_size
+    uint16_t              asset_count;         // number of entries in the asset table
+} qpa_bundle_descriptor_v1_t;
+
+_Static_assert(sizeof(qpa_bundle_descriptor_v1_t) == (sizeof(qgf_block_header_v1_t) + 14), "qpa_bundle_descriptor_v1_t must be 19 bytes in v1 of QPA");
+
+#define QPA_MAGIC 0x415051
+
+/////////////////////////////////////////
+// Asset table
+
+#define QPA_ASSET_TABLE_TYPEID 0x11
+
+typedef enum qpa_asset_type_t { QPA_ASSET_IMAGE = 0x00, QPA_ASSET_FONT = 0x01 } qpa_asset_type_t;
+
+typedef struct QP_PACKED qpa_asset_v1_t {
+    qpa_asset_type_t type : 8; // QGF image or QFF font
+    uint32_t         offset;   // offset of the asset, relative to the start of the bundle
+    uint32_t         length;   // length of the asset, in bytes
+} qpa_asset_v1_t;
+
+_Static_assert(sizeof(qpa_asset_v1_t) == 9, "qpa_asset_v1_t must be 9 bytes in v1 of QPA");
+
+typedef struct QP_PACKED qpa_asset_table_v1_t {
+    qgf_block_header_v1_t header;   // = { .type_id = 0x11, .neg_type_id = (~0x11), .length = (N * 9) }
+    qpa_asset_v1_t        asset[0]; // Extent of '0' signifies that this struct is immediately followed by the asset entries
+} qpa_asset_table_v1_t;
+
+_Static_assert(sizeof(qpa_asset_table_v1_t) == sizeof(qgf_block_header_v1_t), "qpa_asset_table_v1_t must only contain qgf_block_header_v1_t in v1 of QPA");
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QPA API
+
+bool qpa_read_bundle_descriptor(qp_stream_t *stream, uint16_t *asset_count, uint32_t *total_bytes);
+bool qpa_find_asset(qp_stream_t *stream, uint16_t asset_index, qpa_asset_type_t type, uint32_t *offset, uint32_t *length);
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+bool qpa_find_flash_asset(uint16_t asset_index, qpa_asset_type_t type, uint32_t *address, uint32_t *length);
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
@@ -4,8 +4,11 @@ QUANTUM_PAINTER_ANIMATIONS_ENABLE ?= yes
 
 QUANTUM_PAINTER_LVGL_INTEGRATION ?= no
 
+QUANTUM_PAINTER_FLASH_ASSETS ?= no
+
 # The list of permissible drivers that can be listed in QUANTUM_PAINTER_DRIVERS
 VALID_QUANTUM_PAINTER_DRIVERS := \
+	surface \
 	rgb565_surface \
 	ili9163_spi \
 	ili9341_spi \
@@ -44,6 +47,9 @@ endif
 # Comms flags
 QUANTUM_PAINTER_NEEDS_COMMS_SPI ?= no
 
+# Surface flags
+QUANTUM_PAINTER_NEEDS_SURFACE ?= no
+
 # Handler for each driver
 define handle_quantum_painter_driver
     CURRENT_PAINTER_DRIVER := $1
@@ -51,12 +57,13 @@ define handle_quantum_painter_driver
     ifeq ($$(filter $$(strip $$(CURRENT_PAINTER_DRIVER)),$$(VALID_QUANTUM_PAINTER_DRIVERS)),)
         $$(error "$$(CURRENT_PAINTER_DRIVER)" is not a valid Quantum Painter driver)
 
+    else ifeq ($$(strip $$(CURRENT_PAINTER_DRIVER)),surface)
+        QUANTUM_PAINTER_NEEDS_SURFACE := yes
+        OPT_DEFS += -DQUANTUM_PAINTER_SURFACE_ENABLE
+
     else ifeq ($$(strip $$(CURRENT_PAINTER_DRIVER)),rgb565_surface)
-        OPT_DEFS += -DQUANTUM_PAINTER_RGB565_SURFACE_ENABLE
-        COMMON_VPATH += \
-            $(DRIVER_PATH)/painter/generic
-        SRC += \
-            $(DRIVER_PATH)/painter/generic/qp_rgb565_surface.c \
+        QUANTUM_PAINTER_NEEDS_SURFACE := yes
+        OPT_DEFS += -DQUANTUM_PAINTER_SURFACE_ENABLE -DQUANTUM_PAINTER_RGB565_SURFACE_ENABLE
 
     else ifeq ($$(strip $$(CURRENT_PAINTER_DRIVER)),ili9163_spi)
         QUANTUM_PAINTER_NEEDS_COMMS_SPI := yes
@@ -155,6 +162,19 @@ ifeq ($(strip $(QUANTUM_PAINTER_NEEDS_COMMS_SPI)), yes)
     endif
 endif
 
+# If surfaces are needed, set up the required files
+ifeq ($(strip $(QUANTUM_PAINTER_NEEDS_SURFACE)), yes)
+    COMMON_VPATH += $(DRIVER_PATH)/painter/generic
+    SRC += $(DRIVER_PATH)/painter/generic/qp_surface.c
+endif
+
+# If assets are stored in external flash, enable the flash driver alongside the asset bundle parser
+ifeq ($(strip $(QUANTUM_PAINTER_FLASH_ASSETS)), yes)
+    OPT_DEFS += -DQUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+    FLASH_DRIVER := spi
+    SRC += $(QUANTUM_DIR)/painter/qpa.c
+endif
+
 # Check if LVGL needs to be enabled
 ifeq ($(strip $(QUANTUM_PAINTER_LVGL_INTEGRATION)), yes)
 	include $(QUANTUM_DIR)/painter/lvgl/rules.mk
@@ -0,0 +1,46 @@
+// Copyright 2023 QMK -- generated source code only, image retains original copyright
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// This file was auto-generated by `qmk painter-convert-graphics -i qp_test_anim.gif -f pal16`
+
+#include <qp.h>
+
+const uint32_t gfx_qp_test_anim_length = 517;
+
+// clang-format off
+const uint8_t gfx_qp_test_anim[517] = {
+    0x00, 0xFF, 0x12, 0x00, 0x00, 0x51, 0x47, 0x46, 0x01, 0x05, 0x02, 0x00, 0x00, 0xFA, 0xFD, 0xFF,
+    0xFF, 0x10, 0x00, 0x10, 0x00, 0x03, 0x00, 0x01, 0xFE, 0x0C, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0xB4, 0x00, 0x00, 0x00, 0x79, 0x01, 0x00, 0x00, 0x02, 0xFD, 0x06, 0x00, 0x00, 0x06, 0x00, 0x01,
+    0xFF, 0x64, 0x00, 0x03, 0xFC, 0x30, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x15, 0xFF, 0xFF, 0x09, 0xEF,
+    0xF0, 0x07, 0xDB, 0xE0, 0x04, 0xC5, 0xD0, 0xFC, 0xA6, 0xB8, 0xEC, 0x93, 0x98, 0xD5, 0x7F, 0x80,
+    0xC3, 0x8C, 0x8F, 0xB3, 0x9D, 0xA7, 0xAA, 0xA9, 0xBF, 0xA5, 0xC3, 0xCF, 0xA2, 0xDA, 0xDF, 0xA0,
+    0xED, 0xEF, 0x9F, 0xFF, 0xFF, 0xAA, 0xFF, 0x40, 0x05, 0xFA, 0x47, 0x00, 0x00, 0x87, 0xDE, 0xBC,
+    0x9A, 0x89, 0x67, 0x56, 0x45, 0x23, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11,
+    0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11,
+    0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11,
+    0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11,
+    0x04, 0xFF, 0x80, 0x0F, 0x02, 0xFD, 0x06, 0x00, 0x00, 0x06, 0x00, 0x00, 0xFF, 0x64, 0x00, 0x03,
+    0xFC, 0x30, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x15, 0xFF, 0xFF, 0x0F, 0xEF, 0xF0, 0x0E, 0xDB, 0xE0,
+    0x0C, 0xC5, 0xD0, 0x09, 0x9C, 0xB8, 0xF9, 0x5D, 0x98, 0xD5, 0x3F, 0x80, 0xB8, 0x53, 0x8F, 0xA5,
+    0x78, 0xA7, 0x9F, 0xA9, 0xBF, 0x9D, 0xC3, 0xCF, 0x9B, 0xDA, 0xDF, 0x9A, 0xED, 0xEF, 0x9A, 0xFF,
+    0xFF, 0xAA, 0xFF, 0x40, 0x05, 0xFA, 0x80, 0x00, 0x00, 0xDE, 0xBC, 0x9A, 0x89, 0x67, 0x56, 0x45,
+    0x23, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF,
+    0xF0, 0xFF, 0xFF, 0x1F, 0x11, 0x11, 0xF1, 0xFF, 0xFF, 0x02, 0xFD, 0x06, 0x00, 0x00, 0x06, 0x00,
+    0x01, 0xFF, 0x64, 0x00, 0x03, 0xFC, 0x30, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x15, 0xFF, 0xFF, 0x15,
+    0xEF, 0xF0, 0x15, 0xDB, 0xE0, 0x15, 0xC5, 0xD0, 0x15, 0x9C, 0xB8, 0x15, 0x52, 0x98, 0x2A, 0x01,
+    0x80, 0x94, 0x37, 0x8F, 0x94, 0x78, 0xA7, 0x94, 0xA9, 0xBF, 0x94, 0xC3, 0xCF, 0x94, 0xDA, 0xDF,
+    0x94, 0xED, 0xEF, 0x94, 0xFF, 0xFF, 0xAA, 0xFF, 0x40, 0x05, 0xFA, 0x47, 0x00, 0x00, 0x87, 0xDE,
+    0xBC, 0x9A, 0x89, 0x67, 0x56, 0x45, 0x23, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05,
+    0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05,
+    0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05,
+    0xFF, 0x03, 0x11, 0x05, 0xFF, 0x03, 0x11, 0x05, 0xFF, 0x82, 0x11, 0x01, 0x11, 0x05, 0xFF, 0x03,
+    0x11, 0x05, 0xFF, 0x03, 0x11,
+};
+// clang-format on
@@ -0,0 +1,36 @@
+// Copyright 2023 QMK -- generated source code only, image retains original copyright
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// This file was auto-generated by `qmk painter-convert-graphics -i qp_test_image.png -f pal16`
+
+#include <qp.h>
+
+const uint32_t gfx_qp_test_image_length = 360;
+
+// clang-format off
+const uint8_t gfx_qp_test_image[360] = {
+    0x00, 0xFF, 0x12, 0x00, 0x00, 0x51, 0x47, 0x46, 0x01, 0x68, 0x01, 0x00, 0x00, 0x97, 0xFE, 0xFF,
+    0xFF, 0x18, 0x00, 0x18, 0x00, 0x01, 0x00, 0x01, 0xFE, 0x04, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+    0x02, 0xFD, 0x06, 0x00, 0x00, 0x06, 0x00, 0x01, 0xFF, 0xE8, 0x03, 0x03, 0xFC, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0x2A, 0xFF, 0xFF, 0x6A, 0xFF, 0xFF, 0x55, 0xFF, 0xFF, 0x6A, 0xE9, 0xEB, 0x6A,
+    0xCF, 0xD7, 0x6A, 0xB0, 0xC3, 0x6A, 0x73, 0xA5, 0x6B, 0x2D, 0x8C, 0xE9, 0x3D, 0x91, 0xE9, 0x8A,
+    0xAF, 0xE9, 0xB8, 0xC8, 0xE9, 0xDC, 0xE1, 0xD4, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xAA, 0xFF, 0xFF,
+    0x05, 0xFA, 0x03, 0x01, 0x00, 0x06, 0xEE, 0x05, 0x33, 0x80, 0xD3, 0x06, 0xEE, 0x05, 0x33, 0x80,
+    0x3D, 0x06, 0xEE, 0x04, 0x33, 0x81, 0xD3, 0x33, 0x06, 0xEE, 0x04, 0x33, 0x81, 0x3D, 0x33, 0x04,
+    0xEE, 0x80, 0x0E, 0x02, 0x00, 0x82, 0x30, 0x33, 0xD3, 0x02, 0x33, 0x04, 0xEE, 0x04, 0x00, 0x81,
+    0x33, 0x3D, 0x02, 0x33, 0x03, 0xEE, 0x02, 0x00, 0x83, 0xEE, 0x33, 0x00, 0xD0, 0x03, 0x33, 0x03,
+    0xEE, 0x80, 0x00, 0x02, 0xEE, 0x02, 0x33, 0x80, 0x0D, 0x03, 0x33, 0x02, 0xEE, 0x81, 0x0E, 0xE0,
+    0x02, 0xEE, 0x83, 0x33, 0xD3, 0x03, 0x30, 0x02, 0x33, 0x02, 0xEE, 0x81, 0x00, 0xE0, 0x02, 0xEE,
+    0x83, 0x33, 0x3D, 0x03, 0x00, 0x02, 0x33, 0x02, 0xEE, 0x80, 0x00, 0x03, 0xEE, 0x80, 0xD3, 0x02,
+    0x33, 0x80, 0x00, 0x02, 0x33, 0x02, 0xEE, 0x80, 0x00, 0x03, 0xEE, 0x80, 0x3D, 0x02, 0x33, 0x80,
+    0x00, 0x02, 0x33, 0x02, 0xFF, 0x80, 0x00, 0x02, 0xFF, 0x80, 0xDF, 0x03, 0x11, 0x80, 0x00, 0x02,
+    0x11, 0x02, 0xFF, 0x80, 0x00, 0x02, 0xFF, 0x80, 0xFD, 0x03, 0x11, 0x80, 0x00, 0x02, 0x11, 0x02,
+    0xFF, 0x83, 0x00, 0xF0, 0xDF, 0xFF, 0x02, 0x11, 0x81, 0x01, 0x00, 0x02, 0x11, 0x02, 0xFF, 0x83,
+    0x0F, 0xF0, 0xFD, 0xFF, 0x02, 0x11, 0x81, 0x01, 0x10, 0x02, 0x11, 0x03, 0xFF, 0x80, 0xD0, 0x02,
+    0xFF, 0x02, 0x11, 0x80, 0x00, 0x03, 0x11, 0x03, 0xFF, 0x83, 0x0D, 0x00, 0xFF, 0x11, 0x02, 0x00,
+    0x03, 0x11, 0x02, 0xFF, 0x81, 0xDF, 0xFF, 0x04, 0x00, 0x04, 0x11, 0x02, 0xFF, 0x82, 0xFD, 0xFF,
+    0x0F, 0x02, 0x00, 0x80, 0x10, 0x04, 0x11, 0x81, 0xFF, 0xDF, 0x04, 0xFF, 0x06, 0x11, 0x81, 0xFF,
+    0xFD, 0x04, 0xFF, 0x06, 0x11, 0x80, 0xDF, 0x05, 0xFF, 0x06, 0x11, 0x8B, 0x42, 0x44, 0x65, 0x66,
+    0x77, 0x87, 0x98, 0x99, 0xA9, 0xBA, 0xBB, 0xCC,
+};
+// clang-format on
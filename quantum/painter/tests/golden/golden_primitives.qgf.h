@@ -0,0 +1,11 @@
+// Copyright 2023 QMK -- generated source code only, image retains original copyright
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// This file was auto-generated by `qmk painter-convert-graphics -i golden_primitives.png -f rgb565 --no-rle`
+
+#pragma once
+
+#include <qp.h>
+
+extern const uint32_t gfx_golden_primitives_length;
+extern const uint8_t  gfx_golden_primitives[8240];
@@ -0,0 +1,131 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "qp_internal_fill.h"
+}
+
+// Per-pixel writes, equivalent to what append_pixels produces for a single color
+static void reference_fill_16bpp(uint8_t *buffer, uint32_t offset, uint32_t count, uint16_t value) {
+    for (uint32_t i = 0; i < count; ++i) {
+        memcpy(&buffer[(offset + i) * 2], &value, sizeof(value));
+    }
+}
+
+static void reference_fill_24bpp(uint8_t *buffer, uint32_t offset, uint32_t count, uint8_t b0, uint8_t b1, uint8_t b2) {
+    for (uint32_t i = 0; i < count; ++i) {
+        buffer[(offset + i) * 3 + 0] = b0;
+        buffer[(offset + i) * 3 + 1] = b1;
+        buffer[(offset + i) * 3 + 2] = b2;
+    }
+}
+
+static void reference_fill_packed(uint8_t *buffer, uint8_t bpp, uint32_t offset, uint32_t count, uint8_t value) {
+    uint8_t pixels_per_byte = 8 / bpp;
+    uint8_t mask            = (1 << bpp) - 1;
+    for (uint32_t i = offset; i < offset + count; ++i) {
+        uint8_t shift = (i % pixels_per_byte) * bpp;
+
+        buffer[i / pixels_per_byte] &= ~(mask << shift);
+        buffer[i / pixels_per_byte] |= (value & mask) << shift;
+    }
+}
+
+TEST(QpFill, Fill16bppMatchesReference) {
+    alignas(4) uint8_t expected[64];
+    alignas(4) uint8_t actual[64];
+    for (uint32_t offset = 0; offset < 4; ++offset) {
+        for (uint32_t count = 0; count < 28; ++count) {
+            memset(expected, 0xAA, sizeof(expected));
+            memset(actual, 0xAA, sizeof(actual));
+            reference_fill_16bpp(expected, offset, count, 0x1234);
+            qp_internal_fill_16bpp(actual, offset, count, 0x1234);
+            EXPECT_EQ(memcmp(expected, actual, sizeof(expected)), 0) << "offset " << offset << " count " << count;
+        }
+    }
+}
+
+TEST(QpFill, Fill24bppMatchesReference) {
+    alignas(4) uint8_t expected[96];
+    alignas(4) uint8_t actual[96];
+    for (uint32_t offset = 0; offset < 4; ++offset) {
+        for (uint32_t count = 0; count < 28; ++count) {
+            memset(expected, 0xAA, sizeof(expected));
+            memset(actual, 0xAA, sizeof(actual));
+            reference_fill_24bpp(expected, offset, count, 0x12, 0x34, 0x56);
+            qp_internal_fill_24bpp(actual, offset, count, 0x12, 0x34, 0x56);
+            EXPECT_EQ(memcmp(expected, actual, sizeof(expected)), 0) << "offset " << offset << " count " << count;
+        }
+    }
+}
+
+TEST(QpFill, FillPackedMatchesReference) {
+    for (uint8_t bpp : {1, 2, 4, 8}) {
+        uint8_t value = (1 << bpp) - 2; // not all ones, so neighbouring pixels are visibly untouched
+        for (uint32_t offset = 0; offset < 16; ++offset) {
+            for (uint32_t count = 0; count < 40; ++count) {
+                uint8_t expected[64];
+                uint8_t actual[64];
+                memset(expected, 0xA5, sizeof(expected));
+                memset(actual, 0xA5, sizeof(actual));
+                reference_fill_packed(expected, bpp, offset, count, value);
+                qp_internal_fill_packed(actual, bpp, offset, count, value);
+                EXPECT_EQ(memcmp(expected, actual, sizeof(expected)), 0) << "bpp " << (int)bpp << " offset " << offset << " count " << count;
+            }
+        }
+    }
+}
+
+// Fills an RGB565 surface sized buffer, comparing the previous per-pixel append_pixels calls against the bulk fill
+typedef bool (*append_pixels_func)(uint8_t *target_buffer, uint16_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices);
+
+static bool append_pixels_rgb565(uint8_t *target_buffer, uint16_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    uint16_t *buf = (uint16_t *)target_buffer;
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        buf[pixel_offset + i] = palette[palette_indices[i]];
+    }
+    return true;
+}
+
+TEST(QpFill, BenchmarkRgb565Surface) {
+    const uint32_t width      = 320;
+    const uint32_t height     = 240;
+    const uint32_t iterations = 20;
+
+    std::vector<uint32_t> per_pixel_storage(width * height / 2);
+    std::vector<uint32_t> bulk_storage(width * height / 2);
+    uint8_t *             per_pixel   = (uint8_t *)per_pixel_storage.data();
+    uint8_t *             bulk        = (uint8_t *)bulk_storage.data();
+    uint16_t              color       = 0xE007;
+    uint8_t               palette_idx = 0;
+
+    // Called through a volatile pointer, as the driver vtable would be
+    append_pixels_func volatile append = append_pixels_rgb565;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < iterations; ++n) {
+        for (uint32_t i = 0; i < width * height; ++i) {
+            append(per_pixel, &color, i, 1, &palette_idx);
+        }
+    }
+    auto per_pixel_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < iterations; ++n) {
+        qp_internal_fill_16bpp(bulk, 0, width * height, color);
+    }
+    auto bulk_time = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(memcmp(per_pixel, bulk, width * height * 2), 0);
+
+    auto per_pixel_us = std::chrono::duration_cast<std::chrono::microseconds>(per_pixel_time).count() / iterations;
+    auto bulk_us      = std::chrono::duration_cast<std::chrono::microseconds>(bulk_time).count() / iterations;
+    RecordProperty("per_pixel_us", (int)per_pixel_us);
+    RecordProperty("bulk_us", (int)bulk_us);
+}
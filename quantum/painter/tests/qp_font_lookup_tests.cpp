@@ -0,0 +1,177 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Unicode glyph lookups are checked through qp_textwidth(), using fonts built here with a distinct width per glyph so
+// that the glyph found can be told apart. Fonts are read in place from their buffers, so changing a glyph's width after
+// it was looked up shows whether the next lookup came from the glyph cache or the table.
+
+extern "C" {
+#include "qp.h"
+#include "qff.h"
+}
+
+typedef std::vector<std::pair<uint32_t, uint8_t>> glyph_list;
+
+static void put_le(std::vector<uint8_t> &out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back((value >> (i * 8)) & 0xFF);
+    }
+}
+
+static void put_block_header(std::vector<uint8_t> &out, uint8_t type_id, uint32_t length) {
+    out.push_back(type_id);
+    out.push_back(~type_id);
+    put_le(out, length, 3);
+}
+
+// A 1bpp font with no ascii table and the glyphs' unicode entries in the order given, all sharing one byte of data
+static std::vector<uint8_t> make_font(uint8_t version, const glyph_list &glyphs) {
+    uint32_t total_size = sizeof(qff_font_descriptor_v1_t) + sizeof(qgf_block_header_v1_t) + glyphs.size() * sizeof(qff_unicode_glyph_v1_t) + sizeof(qgf_block_header_v1_t) + 1;
+
+    std::vector<uint8_t> font;
+    put_block_header(font, QFF_FONT_DESCRIPTOR_TYPEID, sizeof(qff_font_descriptor_v1_t) - sizeof(qgf_block_header_v1_t));
+    put_le(font, QFF_MAGIC, 3);
+    font.push_back(version);
+    put_le(font, total_size, 4);
+    put_le(font, ~total_size, 4);
+    font.push_back(8);     // line height
+    font.push_back(false); // ascii table
+    put_le(font, glyphs.size(), 2);
+    font.push_back(GRAYSCALE_1BPP);
+    font.push_back(0); // flags
+    font.push_back(IMAGE_UNCOMPRESSED);
+    font.push_back(0); // transparency index
+
+    put_block_header(font, QFF_UNICODE_GLYPH_DESCRIPTOR_TYPEID, glyphs.size() * sizeof(qff_unicode_glyph_v1_t));
+    for (const auto &glyph : glyphs) {
+        put_le(font, glyph.first, 3);
+        put_le(font, glyph.second & QFF_GLYPH_WIDTH_MASK, 3);
+    }
+
+    put_block_header(font, QGF_FRAME_DATA_DESCRIPTOR_TYPEID, 1);
+    font.push_back(0);
+    return font;
+}
+
+// Changes the width of the n-th entry in the unicode table
+static void set_glyph_width(std::vector<uint8_t> &font, size_t n, uint8_t width) {
+    font[sizeof(qff_font_descriptor_v1_t) + sizeof(qgf_block_header_v1_t) + n * sizeof(qff_unicode_glyph_v1_t) + 3] = width;
+}
+
+static std::string utf8(uint32_t code_point) {
+    std::string out;
+    if (code_point < 0x80) {
+        out += (char)code_point;
+    } else if (code_point < 0x800) {
+        out += (char)(0xC0 | (code_point >> 6));
+        out += (char)(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += (char)(0xE0 | (code_point >> 12));
+        out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+        out += (char)(0x80 | (code_point & 0x3F));
+    } else {
+        out += (char)(0xF0 | (code_point >> 18));
+        out += (char)(0x80 | ((code_point >> 12) & 0x3F));
+        out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+        out += (char)(0x80 | (code_point & 0x3F));
+    }
+    return out;
+}
+
+static int16_t width_of(painter_font_handle_t font, uint32_t code_point) {
+    return qp_textwidth(font, utf8(code_point).c_str());
+}
+
+class QpFontLookup : public ::testing::Test {
+   protected:
+    painter_font_handle_t font = nullptr;
+
+    void TearDown() override {
+        if (font) {
+            qp_close_font(font);
+        }
+    }
+};
+
+TEST_F(QpFontLookup, FindsFirstAndLastGlyphs) {
+    // sorted by code point, as the QFF generator writes them
+    glyph_list glyphs = {{0xA9, 1}, {0x3B1, 2}, {0x20AC, 6}, {0x2603, 3}, {0x1F600, 4}, {0x1F680, 5}};
+    auto       data   = make_font(QFF_VERSION_2, glyphs);
+    font              = qp_load_font_mem(data.data());
+    ASSERT_NE(font, nullptr);
+
+    for (const auto &glyph : glyphs) {
+        EXPECT_EQ(width_of(font, glyph.first), glyph.second) << "code point 0x" << std::hex << glyph.first;
+    }
+}
+
+TEST_F(QpFontLookup, MissingGlyphsAreNotFound) {
+    auto data = make_font(QFF_VERSION_2, {{0xA9, 1}, {0x3B1, 2}, {0x2603, 3}, {0x1F600, 4}, {0x1F680, 5}});
+    font      = qp_load_font_mem(data.data());
+    ASSERT_NE(font, nullptr);
+
+    // below the first, between entries, above the last, and ascii without an ascii table
+    for (uint32_t code_point : {0xA8, 0x3B2, 0x2602, 0x1F601, 0x1F681, 0x41}) {
+        EXPECT_EQ(width_of(font, code_point), 0) << "code point 0x" << std::hex << code_point;
+    }
+}
+
+TEST_F(QpFontLookup, LooksUpCodePointsInAnyOrder) {
+    auto data = make_font(QFF_VERSION_2, {{0xA9, 1}, {0x3B1, 2}, {0x2603, 3}, {0x1F600, 4}, {0x1F680, 5}});
+    font      = qp_load_font_mem(data.data());
+    ASSERT_NE(font, nullptr);
+
+    EXPECT_EQ(qp_textwidth(font, (utf8(0x1F680) + utf8(0xA9) + utf8(0x2603) + utf8(0x3B1) + utf8(0x1F600) + utf8(0xA9)).c_str()), 5 + 1 + 3 + 2 + 4 + 1);
+}
+
+TEST_F(QpFontLookup, RejectsUnsortedVersion2Table) {
+    auto data = make_font(QFF_VERSION_2, {{0xA9, 1}, {0x2603, 3}, {0x3B1, 2}});
+    EXPECT_EQ(qp_load_font_mem(data.data()), nullptr);
+
+    data = make_font(QFF_VERSION_2, {{0xA9, 1}, {0xA9, 2}});
+    EXPECT_EQ(qp_load_font_mem(data.data()), nullptr);
+}
+
+TEST_F(QpFontLookup, ScansUnsortedVersion1Table) {
+    glyph_list glyphs = {{0x1F680, 5}, {0x2603, 3}, {0xA9, 1}, {0x1F600, 4}, {0x3B1, 2}};
+    auto       data   = make_font(QFF_VERSION_1, glyphs);
+    font              = qp_load_font_mem(data.data());
+    ASSERT_NE(font, nullptr);
+
+    for (const auto &glyph : glyphs) {
+        EXPECT_EQ(width_of(font, glyph.first), glyph.second) << "code point 0x" << std::hex << glyph.first;
+    }
+    EXPECT_EQ(width_of(font, 0x3B2), 0);
+}
+
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE == 2
+TEST_F(QpFontLookup, GlyphCacheEvictsLeastRecentlyUsed) {
+    auto data = make_font(QFF_VERSION_2, {{0xA9, 1}, {0x3B1, 2}, {0x2603, 3}});
+    font      = qp_load_font_mem(data.data());
+    ASSERT_NE(font, nullptr);
+
+    // cached on first use, so a changed table entry isn't seen
+    EXPECT_EQ(width_of(font, 0xA9), 1);
+    set_glyph_width(data, 0, 11);
+    EXPECT_EQ(width_of(font, 0xA9), 1);
+
+    // two other glyphs push it out, so the table is read again
+    EXPECT_EQ(width_of(font, 0x3B1), 2);
+    EXPECT_EQ(width_of(font, 0x2603), 3);
+    EXPECT_EQ(width_of(font, 0xA9), 11);
+
+    // and it is cached again, having evicted the least recently used glyph rather than the one just looked up
+    set_glyph_width(data, 0, 12);
+    set_glyph_width(data, 1, 22);
+    set_glyph_width(data, 2, 33);
+    EXPECT_EQ(width_of(font, 0xA9), 11);
+    EXPECT_EQ(width_of(font, 0x2603), 3);
+    EXPECT_EQ(width_of(font, 0x3B1), 22);
+}
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE == 2
@@ -0,0 +1,208 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "qp_internal_lz.h"
+}
+
+typedef std::vector<uint8_t> bytes;
+
+struct byte_source {
+    const bytes &data;
+    size_t       pos;
+};
+
+static int16_t byte_source_get(void *cb_arg) {
+    byte_source *src = (byte_source *)cb_arg;
+    return src->pos < src->data.size() ? src->data[src->pos++] : -1;
+}
+
+static bytes lz_decode(const bytes &compressed, size_t length) {
+    uint8_t                window[QP_LZ_WINDOW_SIZE];
+    qp_internal_lz_state_t state;
+    byte_source            src = {compressed, 0};
+    bytes                  out;
+    qp_internal_lz_reset(&state);
+    for (size_t i = 0; i < length; ++i) {
+        int16_t c = qp_internal_lz_decode_byte(&state, window, byte_source_get, &src);
+        if (c < 0) {
+            break;
+        }
+        out.push_back((uint8_t)c);
+    }
+    return out;
+}
+
+// Greedy equivalent of compress_bytes_qmk_lz() in lib/python/qmk/painter.py
+static bytes lz_encode(const bytes &data) {
+    bytes out, literals;
+    auto  flush = [&]() {
+        for (size_t n = 0; n < literals.size(); n += 128) {
+            size_t count = std::min<size_t>(128, literals.size() - n);
+            out.push_back(count - 1);
+            out.insert(out.end(), literals.begin() + n, literals.begin() + n + count);
+        }
+        literals.clear();
+    };
+
+    for (size_t pos = 0; pos < data.size();) {
+        size_t best_length = 0, best_distance = 0;
+        size_t limit = std::min<size_t>(127 + QP_LZ_MIN_MATCH, data.size() - pos);
+        for (size_t distance = 1; distance <= QP_LZ_WINDOW_SIZE && distance <= pos; ++distance) {
+            size_t length = 0;
+            while (length < limit && data[pos - distance + length] == data[pos + length]) {
+                ++length;
+            }
+            if (length > best_length) {
+                best_length   = length;
+                best_distance = distance;
+            }
+        }
+
+        if (best_length >= QP_LZ_MIN_MATCH) {
+            flush();
+            out.push_back(128 + best_length - QP_LZ_MIN_MATCH);
+            out.push_back(best_distance - 1);
+            pos += best_length;
+        } else {
+            literals.push_back(data[pos++]);
+        }
+    }
+    flush();
+    return out;
+}
+
+// Equivalent of compress_bytes_qmk_rle() in lib/python/qmk/painter.py
+static bytes rle_encode(const bytes &data) {
+    bytes out;
+    for (size_t pos = 0; pos < data.size();) {
+        size_t run = 1;
+        while (pos + run < data.size() && run < 127 && data[pos + run] == data[pos]) {
+            ++run;
+        }
+        if (run >= 2) {
+            out.push_back(run);
+            out.push_back(data[pos]);
+            pos += run;
+            continue;
+        }
+
+        size_t literal = 0;
+        while (pos + literal < data.size() && literal < 128 && (pos + literal + 1 >= data.size() || data[pos + literal + 1] != data[pos + literal])) {
+            ++literal;
+        }
+        literal = std::max<size_t>(literal, 1);
+        out.push_back(127 + literal);
+        out.insert(out.end(), data.begin() + pos, data.begin() + pos + literal);
+        pos += literal;
+    }
+    return out;
+}
+
+// Mirrors qp_drawimage_byte_rle_decoder() in quantum/painter/qp_draw_codec.c
+static bytes rle_decode(const bytes &compressed, size_t length) {
+    byte_source src = {compressed, 0};
+    bytes       out;
+    uint8_t     mode = 0, remain = 0;
+    int16_t     curr = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (remain == 0) {
+            int16_t c = byte_source_get(&src);
+            mode      = c >= 128;
+            remain    = c >= 128 ? c - 127 : c;
+            curr      = byte_source_get(&src);
+        }
+        out.push_back((uint8_t)curr);
+        if (--remain > 0 && mode) {
+            curr = byte_source_get(&src);
+        }
+    }
+    return out;
+}
+
+// A 4bpp image with an ordered dither across a gradient, which RLE barely compresses
+static bytes make_dithered_image(size_t width, size_t height) {
+    static const uint8_t bayer[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+    bytes                data;
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; x += 2) {
+            uint8_t level = (x * 16 / width);
+            uint8_t lo    = (level + (bayer[y % 4][x % 4] > level * 15 / 16)) & 0x0F;
+            uint8_t hi    = (level + (bayer[y % 4][(x + 1) % 4] > level * 15 / 16)) & 0x0F;
+            data.push_back(lo | (hi << 4));
+        }
+    }
+    return data;
+}
+
+TEST(QpLz, DecodesKnownVectors) {
+    // Produced by compress_bytes_qmk_lz(), see lib/python/qmk/tests/test_qmk_painter.py
+    EXPECT_EQ(lz_decode({2, 1, 2, 3, 131, 2, 0, 4}, 10), bytes({1, 2, 3, 1, 2, 3, 1, 2, 3, 4}));
+    EXPECT_EQ(lz_decode({0, 7, 134, 0}, 10), bytes(10, 7));
+}
+
+TEST(QpLz, StopsAtEndOfInput) {
+    EXPECT_EQ(lz_decode({3, 1, 2}, 10), bytes({1, 2}));
+    EXPECT_EQ(lz_decode({0, 1, 130}, 10), bytes({1}));
+}
+
+TEST(QpLz, CopiesReachTheWholeWindow) {
+    bytes data;
+    for (size_t i = 0; i < 256; ++i) {
+        data.push_back((i * 37) ^ (i >> 3));
+    }
+    // Repeat the block so every copy refers back the full 256 bytes, wrapping the window several times
+    for (size_t i = 0; i < 1000; ++i) {
+        data.push_back(data[i]);
+    }
+
+    bytes compressed = lz_encode(data);
+    EXPECT_LT(compressed.size(), 300u);
+    EXPECT_EQ(lz_decode(compressed, data.size()), data);
+}
+
+TEST(QpLz, RoundTripsImages) {
+    bytes flat(4000, 0x11);
+    bytes dithered = make_dithered_image(120, 64);
+    for (const bytes &data : {flat, dithered}) {
+        EXPECT_EQ(lz_decode(lz_encode(data), data.size()), data);
+        EXPECT_EQ(rle_decode(rle_encode(data), data.size()), data);
+    }
+}
+
+TEST(QpLz, BenchmarkAgainstRle) {
+    const size_t iterations = 20;
+    struct {
+        const char *name;
+        bytes       data;
+    } images[] = {{"flat 240x320 4bpp", bytes(240 * 320 / 2, 0x00)}, {"dithered 240x320 4bpp", make_dithered_image(240, 320)}};
+
+    for (auto &image : images) {
+        bytes rle = rle_encode(image.data);
+        bytes lz  = lz_encode(image.data);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < iterations; ++n) {
+            EXPECT_EQ(rle_decode(rle, image.data.size()).size(), image.data.size());
+        }
+        auto rle_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < iterations; ++n) {
+            EXPECT_EQ(lz_decode(lz, image.data.size()).size(), image.data.size());
+        }
+        auto lz_time = std::chrono::steady_clock::now() - start;
+
+        auto rle_us = std::chrono::duration_cast<std::chrono::microseconds>(rle_time).count() / iterations;
+        auto lz_us  = std::chrono::duration_cast<std::chrono::microseconds>(lz_time).count() / iterations;
+        std::cout << image.name << ": raw " << image.data.size() << " bytes, RLE " << rle.size() << " bytes in " << rle_us << "us, LZ " << lz.size() << " bytes in " << lz_us << "us" << std::endl;
+        EXPECT_LE(lz.size(), rle.size());
+    }
+}
@@ -0,0 +1,195 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "color.h"
+#include "qp_internal.h"
+#include "qp_comms.h"
+#include "qp_internal_fill.h"
+#include "qp_mock_display.h"
+
+// Device definition
+typedef struct mock_display_device_t {
+    painter_driver_t base; // must be first, so it can be cast to/from the painter_device_t* type
+
+    // Current window and write location, mirroring a TFT's GRAM addressing
+    uint16_t viewport_l;
+    uint16_t viewport_t;
+    uint16_t viewport_r;
+    uint16_t viewport_b;
+    uint16_t pixdata_x;
+    uint16_t pixdata_y;
+
+    mock_display_stats_t stats;
+    uint8_t              gram[MOCK_DISPLAY_MAX_PIXELS * 2];
+} mock_display_device_t;
+
+static mock_display_device_t mock_displays[MOCK_DISPLAY_NUM_DEVICES] = {0};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Driver vtable
+
+static bool qp_mock_display_init(painter_device_t device, painter_rotation_t rotation) {
+    mock_display_device_t *mock = (mock_display_device_t *)device;
+    memset(mock->gram, 0, sizeof(mock->gram));
+    return true;
+}
+
+static bool qp_mock_display_power(painter_device_t device, bool power_on) {
+    return true;
+}
+
+static bool qp_mock_display_clear(painter_device_t device) {
+    mock_display_device_t *mock = (mock_display_device_t *)device;
+    memset(mock->gram, 0, sizeof(mock->gram));
+    return true;
+}
+
+static bool qp_mock_display_flush(painter_device_t device) {
+    return true;
+}
+
+static bool qp_mock_display_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    mock_display_device_t *mock = (mock_display_device_t *)device;
+
+    // Same amount of data as a TFT's column and row address commands
+    uint8_t window[8] = {left >> 8, left & 0xFF, right >> 8, right & 0xFF, top >> 8, top & 0xFF, bottom >> 8, bottom & 0xFF};
+    qp_comms_send(device, window, sizeof(window));
+    mock->stats.viewports++;
+
+    mock->viewport_l = left;
+    mock->viewport_t = top;
+    mock->viewport_r = right;
+    mock->viewport_b = bottom;
+    mock->pixdata_x  = left;
+    mock->pixdata_y  = top;
+    return true;
+}
+
+static bool qp_mock_display_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    mock_display_device_t *mock  = (mock_display_device_t *)device;
+    const uint8_t *        bytes = (const uint8_t *)pixel_data;
+    qp_comms_send(device, pixel_data, native_pixel_count * 2);
+
+    for (uint32_t i = 0; i < native_pixel_count; ++i) {
+        uint32_t index            = ((uint32_t)mock->pixdata_y) * mock->base.panel_width + mock->pixdata_x;
+        mock->gram[index * 2 + 0] = bytes[i * 2 + 0];
+        mock->gram[index * 2 + 1] = bytes[i * 2 + 1];
+
+        // Wrap around the window the same way the panels do
+        if (++mock->pixdata_x > mock->viewport_r) {
+            mock->pixdata_x = mock->viewport_l;
+            if (++mock->pixdata_y > mock->viewport_b) {
+                mock->pixdata_y = mock->viewport_t;
+            }
+        }
+    }
+    return true;
+}
+
+static bool qp_mock_display_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    ((mock_display_device_t *)device)->stats.palette_converts++;
+    for (int16_t i = 0; i < palette_size; ++i) {
+        RGB      rgb      = hsv_to_rgb_nocie((HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v});
+        uint16_t rgb565   = (((uint16_t)rgb.r) >> 3) << 11 | (((uint16_t)rgb.g) >> 2) << 5 | (((uint16_t)rgb.b) >> 3);
+        palette[i].rgb565 = __builtin_bswap16(rgb565);
+    }
+    return true;
+}
+
+static bool qp_mock_display_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    uint16_t *buf = (uint16_t *)target_buffer;
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        buf[pixel_offset + i] = palette[palette_indices[i]].rgb565;
+    }
+    return true;
+}
+
+static bool qp_mock_display_append_pixdata(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte) {
+    target_buffer[pixdata_offset] = pixdata_byte;
+    return true;
+}
+
+static bool qp_mock_display_fill_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t color, uint32_t pixel_offset, uint32_t pixel_count) {
+    qp_internal_fill_16bpp(target_buffer, pixel_offset, pixel_count, color.rgb565);
+    return true;
+}
+
+static const painter_driver_vtable_t mock_display_driver_vtable = {
+    .init            = qp_mock_display_init,
+    .power           = qp_mock_display_power,
+    .clear           = qp_mock_display_clear,
+    .flush           = qp_mock_display_flush,
+    .pixdata         = qp_mock_display_pixdata,
+    .viewport        = qp_mock_display_viewport,
+    .palette_convert = qp_mock_display_palette_convert,
+    .append_pixels   = qp_mock_display_append_pixels,
+    .append_pixdata  = qp_mock_display_append_pixdata,
+    .fill_pixels     = qp_mock_display_fill_pixels,
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Comms vtable, counting the traffic instead of sending it anywhere
+
+static bool qp_mock_display_comms_init(painter_device_t device) {
+    return true;
+}
+
+static bool qp_mock_display_comms_start(painter_device_t device) {
+    mock_display_device_t *mock = (mock_display_device_t *)device;
+    mock->stats.transactions++;
+    return true;
+}
+
+static void qp_mock_display_comms_stop(painter_device_t device) {}
+
+static uint32_t qp_mock_display_comms_send(painter_device_t device, const void *data, uint32_t byte_count) {
+    mock_display_device_t *mock = (mock_display_device_t *)device;
+    mock->stats.bytes += byte_count;
+    return byte_count;
+}
+
+static const painter_comms_vtable_t mock_display_comms_vtable = {
+    .comms_init  = qp_mock_display_comms_init,
+    .comms_start = qp_mock_display_comms_start,
+    .comms_stop  = qp_mock_display_comms_stop,
+    .comms_send  = qp_mock_display_comms_send,
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Factory and test accessors
+
+painter_device_t qp_mock_display_make(uint16_t panel_width, uint16_t panel_height) {
+    if (((uint32_t)panel_width) * panel_height > MOCK_DISPLAY_MAX_PIXELS) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < MOCK_DISPLAY_NUM_DEVICES; ++i) {
+        mock_display_device_t *mock = &mock_displays[i];
+        if (!mock->base.driver_vtable) {
+            mock->base.driver_vtable         = &mock_display_driver_vtable;
+            mock->base.comms_vtable          = &mock_display_comms_vtable;
+            mock->base.native_bits_per_pixel = 16;
+            mock->base.panel_width           = panel_width;
+            mock->base.panel_height          = panel_height;
+            mock->base.rotation              = QP_ROTATION_0;
+            mock->base.offset_x              = 0;
+            mock->base.offset_y              = 0;
+            return (painter_device_t)mock;
+        }
+    }
+    return NULL;
+}
+
+const uint8_t *qp_mock_display_gram(painter_device_t device) {
+    return ((mock_display_device_t *)device)->gram;
+}
+
+mock_display_stats_t qp_mock_display_stats(painter_device_t device) {
+    return ((mock_display_device_t *)device)->stats;
+}
+
+void qp_mock_display_reset_stats(painter_device_t device) {
+    memset(&((mock_display_device_t *)device)->stats, 0, sizeof(mock_display_stats_t));
+}
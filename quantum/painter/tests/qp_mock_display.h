@@ -0,0 +1,28 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qp.h"
+
+#define MOCK_DISPLAY_NUM_DEVICES 8
+#define MOCK_DISPLAY_MAX_PIXELS (128 * 128)
+
+// Traffic seen on the mock display's bus, along with the conversions asked of the driver
+typedef struct mock_display_stats_t {
+    uint32_t transactions;     // number of times comms were started
+    uint32_t viewports;        // number of viewport changes
+    uint32_t bytes;            // total bytes sent, window setup included
+    uint32_t palette_converts; // number of palettes converted to RGB565
+} mock_display_stats_t;
+
+// RGB565 panel which keeps its GRAM in RAM, as the big-endian bytes that were sent to it
+painter_device_t qp_mock_display_make(uint16_t panel_width, uint16_t panel_height);
+
+const uint8_t *qp_mock_display_gram(painter_device_t device);
+
+mock_display_stats_t qp_mock_display_stats(painter_device_t device);
+void                 qp_mock_display_reset_stats(painter_device_t device);
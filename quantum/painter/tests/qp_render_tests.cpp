@@ -0,0 +1,602 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Renders scripted scenes to a mock RGB565 panel, both directly and through a surface, and compares the result against
+// the golden images in golden/. The golden images are checked in uncompressed and compared byte for byte, so that none
+// of the decoding under test is involved. Mismatched renders are written to .build/test/ as PNGs for inspection; if a
+// change is intended, copy the render over golden/golden_<scene>.png and regenerate the image using:
+//     qmk painter-convert-graphics -f rgb565 --no-rle -i golden_<scene>.png
+// Draw time and bus traffic are recorded as test properties for each scene, with the traffic budgets in the scene
+// table guarding against regressions.
+
+extern "C" {
+#include "qp.h"
+#include "qp_draw.h"
+#include "qgf.h"
+#include "qp_surface.h"
+#include "qp_mock_display.h"
+#include "thintel15.qff.h"
+#include "qp_test_image.qgf.h"
+#include "qp_test_anim.qgf.h"
+#include "golden_primitives.qgf.h"
+#include "golden_text.qgf.h"
+#include "golden_image.qgf.h"
+#include "golden_animation.qgf.h"
+
+void advance_time(uint32_t ms);
+void qp_internal_animation_tick(void);
+}
+
+// Every scene is rendered at this size, matching the golden images
+#define SCENE_WIDTH 64
+#define SCENE_HEIGHT 64
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scenes
+
+static void scene_primitives(painter_device_t device) {
+    qp_rect(device, 0, 0, SCENE_WIDTH - 1, SCENE_HEIGHT - 1, 170, 255, 64, true);
+    qp_rect(device, 4, 4, 27, 19, 0, 255, 255, true);
+    qp_rect(device, 32, 4, 59, 19, 85, 255, 255, false);
+    qp_line(device, 0, 0, SCENE_WIDTH - 1, SCENE_HEIGHT - 1, 0, 0, 255);
+    qp_line(device, 0, 40, 63, 24, 43, 255, 255);
+    qp_circle(device, 16, 44, 12, 128, 255, 255, true);
+    qp_circle(device, 16, 44, 14, 0, 0, 255, false);
+    qp_ellipse(device, 46, 44, 14, 8, 213, 255, 255, true);
+    for (uint16_t i = 0; i < 16; ++i) {
+        qp_setpixel(device, 40 + i, 60, i * 16, 255, 255);
+    }
+}
+
+static void scene_text(painter_device_t device) {
+    painter_font_handle_t font = qp_load_font_mem(font_thintel15);
+    ASSERT_NE(font, nullptr);
+    qp_rect(device, 0, 0, SCENE_WIDTH - 1, SCENE_HEIGHT - 1, 0, 0, 0, true);
+    qp_drawtext(device, 2, 2, font, "QMK");
+    qp_drawtext_recolor(device, 2, 18, font, "Painter", 0, 255, 255, 170, 255, 128);
+    qp_drawtext_recolor(device, 2, 34, font, "0123456789", 85, 255, 255, 0, 0, 0);
+    qp_drawtext_recolor(device, 2, 48, font, "~!@#$%", 43, 255, 255, 0, 0, 32);
+    qp_close_font(font);
+}
+
+static void scene_image(painter_device_t device) {
+    painter_image_handle_t image = qp_load_image_mem(gfx_qp_test_image);
+    ASSERT_NE(image, nullptr);
+    qp_rect(device, 0, 0, SCENE_WIDTH - 1, SCENE_HEIGHT - 1, 0, 0, 32, true);
+    qp_drawimage(device, 0, 0, image);
+    qp_drawimage(device, 30, 10, image);
+    qp_drawimage(device, 8, 38, image);
+    qp_close_image(image);
+}
+
+static void scene_animation(painter_device_t device) {
+    painter_image_handle_t image = qp_load_image_mem(gfx_qp_test_anim);
+    ASSERT_NE(image, nullptr);
+    qp_rect(device, 0, 0, SCENE_WIDTH - 1, SCENE_HEIGHT - 1, 0, 0, 0, true);
+
+    // Step the animation through to its last frame, which is drawn as a delta on top of the earlier frames
+    deferred_token token = qp_animate(device, 24, 24, image);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+    for (int frame = 1; frame < 3; ++frame) {
+        advance_time(100);
+        qp_internal_animation_tick();
+    }
+    qp_stop_animation(token);
+    qp_close_image(image);
+}
+
+typedef void (*scene_func)(painter_device_t device);
+
+// Only one surface can exist at a time, so every test drawing through one shares it
+static painter_device_t shared_surface(void) {
+    static uint8_t          buffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(SCENE_WIDTH, SCENE_HEIGHT, 16)];
+    static painter_device_t surface = qp_make_surface(SCENE_WIDTH, SCENE_HEIGHT, 16, buffer);
+    return surface;
+}
+
+struct scene_t {
+    const char *   name;
+    scene_func     draw;
+    const uint8_t *golden;
+    uint32_t       golden_length;
+    uint32_t       max_bytes;        // bus traffic budget when drawing directly to a display
+    uint32_t       max_transactions; // comms transaction budget when drawing directly to a display
+};
+
+// Finds the pixels of a golden image, which must be a single uncompressed frame covering the whole scene
+static const uint8_t *golden_pixels(const uint8_t *qgf, uint32_t length) {
+    uint8_t compression = 0xFF;
+    for (uint32_t pos = 0; pos + 5 <= length;) {
+        uint8_t  type_id      = qgf[pos];
+        uint32_t block_length = qgf[pos + 2] | (qgf[pos + 3] << 8) | (qgf[pos + 4] << 16);
+        if (type_id == QGF_FRAME_DESCRIPTOR_TYPEID) {
+            compression = qgf[pos + 5 + 2];
+        } else if (type_id == QGF_FRAME_DATA_DESCRIPTOR_TYPEID) {
+            bool usable = compression == IMAGE_UNCOMPRESSED && block_length == SCENE_WIDTH * SCENE_HEIGHT * 2 && pos + 5 + block_length <= length;
+            return usable ? qgf + pos + 5 : nullptr;
+        }
+        pos += 5 + block_length;
+    }
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PNG output, for inspecting mismatched renders -- uncompressed, so no zlib is required
+
+static uint32_t png_crc(const uint8_t *data, size_t len, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static void png_put32(std::vector<uint8_t> &out, uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+static void png_chunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+    std::vector<uint8_t> body(type, type + 4);
+    body.insert(body.end(), data.begin(), data.end());
+    png_put32(out, data.size());
+    out.insert(out.end(), body.begin(), body.end());
+    png_put32(out, png_crc(body.data(), body.size()));
+}
+
+static void write_png(const std::string &path, const uint8_t *rgb565, uint16_t width, uint16_t height) {
+    // Expand the big-endian RGB565 to RGB888, replicating the top bits so converting back is lossless
+    std::vector<uint8_t> raw;
+    for (uint16_t y = 0; y < height; ++y) {
+        raw.push_back(0); // no filter
+        for (uint16_t x = 0; x < width; ++x) {
+            uint32_t i = ((uint32_t)y * width + x) * 2;
+            uint16_t c = (rgb565[i] << 8) | rgb565[i + 1];
+            uint8_t  r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            raw.push_back((r << 3) | (r >> 2));
+            raw.push_back((g << 2) | (g >> 4));
+            raw.push_back((b << 3) | (b >> 2));
+        }
+    }
+
+    // zlib stream made of stored deflate blocks
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    uint32_t             a = 1, b = 0;
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+        uint16_t len = (uint16_t)std::min<size_t>(raw.size() - pos, 65535);
+        zlib.push_back((pos + len == raw.size()) ? 1 : 0);
+        zlib.push_back(len & 0xFF);
+        zlib.push_back(len >> 8);
+        zlib.push_back(~len & 0xFF);
+        zlib.push_back((~len >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+        if (len == 0) {
+            break;
+        }
+    }
+    for (uint8_t c : raw) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    png_put32(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    png_put32(ihdr, width);
+    png_put32(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0}); // 8-bit RGB
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    png_chunk(png, "IHDR", ihdr);
+    png_chunk(png, "IDAT", zlib);
+    png_chunk(png, "IEND", {});
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f) {
+        fwrite(png.data(), 1, png.size(), f);
+        fclose(f);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Test fixture
+
+class QpRender : public ::testing::TestWithParam<scene_t> {
+   protected:
+    static painter_device_t direct;
+    static painter_device_t target;
+    static painter_device_t surface;
+
+    static void SetUpTestSuite() {
+        direct  = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+        target  = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+        surface = shared_surface();
+    }
+
+    // Compares what the display holds against the golden image, writing out the render if they differ
+    void check_golden(painter_device_t display, const scene_t &scene, const char *path) {
+        const uint8_t *golden = golden_pixels(scene.golden, scene.golden_length);
+        ASSERT_NE(golden, nullptr) << "golden/" << scene.name << " is not a single uncompressed " << SCENE_WIDTH << "x" << SCENE_HEIGHT << " RGB565 frame";
+
+        if (memcmp(qp_mock_display_gram(display), golden, SCENE_WIDTH * SCENE_HEIGHT * 2) != 0) {
+            std::string output = std::string(".build/test/qp_render_") + scene.name + "_" + path + ".png";
+            write_png(output, qp_mock_display_gram(display), SCENE_WIDTH, SCENE_HEIGHT);
+            ADD_FAILURE() << "Scene '" << scene.name << "' drawn " << path << " does not match golden/" << scene.name << ".png, render written to " << output;
+        }
+    }
+
+    static void report(std::chrono::steady_clock::duration elapsed, const mock_display_stats_t &stats) {
+        RecordProperty("us", (int)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        RecordProperty("bytes", (int)stats.bytes);
+        RecordProperty("transactions", (int)stats.transactions);
+        RecordProperty("viewports", (int)stats.viewports);
+    }
+};
+
+painter_device_t QpRender::direct;
+painter_device_t QpRender::target;
+painter_device_t QpRender::surface;
+
+TEST_P(QpRender, DirectMatchesGolden) {
+    const scene_t &scene = GetParam();
+    ASSERT_TRUE(qp_init(direct, QP_ROTATION_0));
+    qp_mock_display_reset_stats(direct);
+
+    auto start = std::chrono::steady_clock::now();
+    scene.draw(direct);
+    qp_flush(direct);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    mock_display_stats_t stats = qp_mock_display_stats(direct);
+    report(elapsed, stats);
+    check_golden(direct, scene, "direct");
+
+    // Guard against regressions in the amount of data sent to the display
+    EXPECT_LE(stats.bytes, scene.max_bytes);
+    EXPECT_LE(stats.transactions, scene.max_transactions);
+}
+
+TEST_P(QpRender, SurfaceMatchesGolden) {
+    const scene_t &scene = GetParam();
+    ASSERT_TRUE(qp_init(surface, QP_ROTATION_0));
+    ASSERT_TRUE(qp_init(target, QP_ROTATION_0));
+    qp_mock_display_reset_stats(target);
+
+    auto start = std::chrono::steady_clock::now();
+    scene.draw(surface);
+    ASSERT_TRUE(qp_surface_draw(surface, target, 0, 0));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    report(elapsed, qp_mock_display_stats(target));
+    check_golden(target, scene, "surface");
+}
+
+// The traffic budgets leave about 10% above what the scenes currently need, so that unrelated changes don't have to touch
+// the table while larger regressions still fail
+#define SCENE_GOLDEN(name) gfx_golden_##name, sizeof(gfx_golden_##name)
+static const scene_t scenes[] = {
+    // name        draw              golden                         max_bytes  max_transactions
+    {"primitives", scene_primitives, SCENE_GOLDEN(primitives), 15500, 28},
+    {"text", scene_text, SCENE_GOLDEN(text), 12400, 7},
+    {"image", scene_image, SCENE_GOLDEN(image), 12900, 6},
+    {"animation", scene_animation, SCENE_GOLDEN(animation), 10800, 6},
+};
+
+INSTANTIATE_TEST_CASE_P(Scenes, QpRender, ::testing::ValuesIn(scenes), [](const ::testing::TestParamInfo<scene_t> &info) { return std::string(info.param.name); });
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scrolling and copying
+
+// Draws the same rows to a surface and directly to a display, then checks where each row ends up after the surface is drawn
+class QpSurfaceOps : public ::testing::Test {
+   protected:
+    static painter_device_t surface;
+    static painter_device_t target;
+    static painter_device_t reference;
+
+    static void SetUpTestSuite() {
+        surface   = shared_surface();
+        target    = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+        reference = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(qp_init(surface, QP_ROTATION_0));
+        ASSERT_TRUE(qp_init(target, QP_ROTATION_0));
+        ASSERT_TRUE(qp_init(reference, QP_ROTATION_0));
+
+        // Every row gets its own color
+        for (uint16_t y = 0; y < SCENE_HEIGHT; ++y) {
+            qp_line(surface, 0, y, SCENE_WIDTH - 1, y, y * 4, 255, 255);
+            qp_line(reference, 0, y, SCENE_WIDTH - 1, y, y * 4, 255, 255);
+        }
+    }
+
+    // True if display row `row` of the target shows what row `source_row` holds
+    static bool row_shows(uint16_t row, uint16_t source_row) {
+        return memcmp(qp_mock_display_gram(target) + row * SCENE_WIDTH * 2, qp_mock_display_gram(reference) + source_row * SCENE_WIDTH * 2, SCENE_WIDTH * 2) == 0;
+    }
+};
+
+painter_device_t QpSurfaceOps::surface;
+painter_device_t QpSurfaceOps::target;
+painter_device_t QpSurfaceOps::reference;
+
+TEST_F(QpSurfaceOps, ScrollWrapsWithinBand) {
+    const uint16_t top = 16, bottom = 47, height = bottom - top + 1;
+
+    // Offsets beyond the band's height wrap around, so both of these show the band moved up by 10 rows
+    for (uint16_t offset : {10, 10 + height}) {
+        ASSERT_TRUE(qp_scroll(surface, top, bottom, offset));
+        ASSERT_TRUE(qp_surface_draw(surface, target, 0, 0));
+        for (uint16_t row = 0; row < SCENE_HEIGHT; ++row) {
+            uint16_t source_row = (row < top || row > bottom) ? row : top + (row - top + 10) % height;
+            EXPECT_TRUE(row_shows(row, source_row)) << "offset " << offset << ", row " << row;
+        }
+    }
+
+    // Resetting the scroll puts every row back where it was drawn
+    ASSERT_TRUE(qp_scroll(surface, top, bottom, 0));
+    ASSERT_TRUE(qp_surface_draw(surface, target, 0, 0));
+    for (uint16_t row = 0; row < SCENE_HEIGHT; ++row) {
+        EXPECT_TRUE(row_shows(row, row)) << "row " << row;
+    }
+
+    // Bands have to be on the display
+    EXPECT_FALSE(qp_scroll(surface, 47, 16, 10));
+    EXPECT_FALSE(qp_scroll(surface, 16, SCENE_HEIGHT, 10));
+}
+
+TEST_F(QpSurfaceOps, BlitRejectsRectanglesOutsideDisplay) {
+    // Source past the edges, or inverted
+    EXPECT_FALSE(qp_blit(surface, 0, 0, SCENE_WIDTH, 15, 0, 32));
+    EXPECT_FALSE(qp_blit(surface, 0, 0, 15, SCENE_HEIGHT, 32, 0));
+    EXPECT_FALSE(qp_blit(surface, 15, 0, 0, 15, 32, 32));
+    EXPECT_FALSE(qp_blit(surface, 0, 15, 15, 0, 32, 32));
+
+    // Destination running off the right or bottom edge
+    EXPECT_FALSE(qp_blit(surface, 0, 0, 15, 15, SCENE_WIDTH - 15, 0));
+    EXPECT_FALSE(qp_blit(surface, 0, 0, 15, 15, 0, SCENE_HEIGHT - 15));
+    EXPECT_FALSE(qp_blit(surface, 0, 0, 15, 15, 0xFFFF, 0));
+
+    // None of them touched the surface
+    ASSERT_TRUE(qp_surface_draw(surface, target, 0, 0));
+    for (uint16_t row = 0; row < SCENE_HEIGHT; ++row) {
+        EXPECT_TRUE(row_shows(row, row)) << "row " << row;
+    }
+
+    // Whereas a rectangle just fitting in the bottom right corner is copied
+    EXPECT_TRUE(qp_blit(surface, 0, 0, 15, 15, SCENE_WIDTH - 16, SCENE_HEIGHT - 16));
+    ASSERT_TRUE(qp_surface_draw(surface, target, 0, 0));
+    EXPECT_FALSE(row_shows(SCENE_HEIGHT - 16, SCENE_HEIGHT - 16));
+    EXPECT_TRUE(row_shows(0, 0));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Animation cache
+
+// Mirrors the header qp_draw_image.c puts in front of each cached frame's native pixels
+struct anim_cache_entry_t {
+    uint32_t size;
+    uint16_t left;
+    uint16_t top;
+    uint16_t right;
+    uint16_t bottom;
+    uint16_t delay;
+};
+
+#define ANIM_X 24
+#define ANIM_Y 24
+#define ARENA_SENTINEL 0xA5
+
+// Runs the same animation on two displays, one of them with a cache, and checks they always show the same thing
+class QpAnimationCache : public ::testing::Test {
+   protected:
+    static painter_device_t cached;
+    static painter_device_t plain;
+
+    static void SetUpTestSuite() {
+        cached = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+        plain  = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(qp_init(cached, QP_ROTATION_0));
+        ASSERT_TRUE(qp_init(plain, QP_ROTATION_0));
+        image = qp_load_image_mem(gfx_qp_test_anim);
+        ASSERT_NE(image, nullptr);
+        memset(arena, ARENA_SENTINEL, sizeof(arena));
+
+        // The first frame is drawn before the cache is attached, so caching starts when the animation wraps around
+        cached_token = qp_animate(cached, ANIM_X, ANIM_Y, image);
+        plain_token  = qp_animate(plain, ANIM_X, ANIM_Y, image);
+        ASSERT_NE(cached_token, INVALID_DEFERRED_TOKEN);
+        ASSERT_NE(plain_token, INVALID_DEFERRED_TOKEN);
+    }
+
+    void TearDown() override {
+        qp_stop_animation(cached_token);
+        qp_stop_animation(plain_token);
+        qp_close_image(image);
+    }
+
+    // Draws the next frame on both displays
+    void step() {
+        advance_time(100);
+        qp_internal_animation_tick();
+        EXPECT_EQ(memcmp(qp_mock_display_gram(cached), qp_mock_display_gram(plain), SCENE_WIDTH * SCENE_HEIGHT * 2), 0);
+    }
+
+    // Size of a cached frame covering the whole image on an RGB565 display
+    uint32_t full_frame_size() const {
+        return sizeof(anim_cache_entry_t) + ((image->width * image->height * 2 + 3) & ~3u);
+    }
+
+    bool arena_untouched_from(uint32_t offset) const {
+        for (uint32_t i = offset; i < sizeof(arena); ++i) {
+            if (((const uint8_t *)arena)[i] != ARENA_SENTINEL) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    painter_image_handle_t image;
+    deferred_token         cached_token;
+    deferred_token         plain_token;
+    uint32_t               arena[1024];
+};
+
+painter_device_t QpAnimationCache::cached;
+painter_device_t QpAnimationCache::plain;
+
+TEST_F(QpAnimationCache, StoresAndReplaysFrames) {
+    uint32_t needed = qp_animation_cache_size(cached, image);
+    ASSERT_GT(needed, full_frame_size());
+    ASSERT_LE(needed, sizeof(arena));
+    ASSERT_TRUE(qp_animation_set_cache(cached_token, arena, needed));
+
+    // Draw the rest of the first loop, then the whole of the second one, which stores every frame
+    for (uint16_t i = 0; i < 2 * image->frame_count - 1; ++i) {
+        step();
+    }
+
+    // The frames fill the arena exactly, and nothing is written past it
+    uint32_t offset = 0;
+    for (uint16_t i = 0; i < image->frame_count; ++i) {
+        const anim_cache_entry_t *entry = (const anim_cache_entry_t *)((const uint8_t *)arena + offset);
+        ASSERT_GT(entry->size, sizeof(anim_cache_entry_t)) << "frame " << i;
+        offset += entry->size;
+    }
+    EXPECT_EQ(offset, needed);
+    EXPECT_TRUE(arena_untouched_from(needed));
+
+    // The next loop is drawn from the arena, so whatever it holds for the first frame ends up on the display
+    const anim_cache_entry_t *first = (const anim_cache_entry_t *)arena;
+    EXPECT_EQ(first->size, full_frame_size());
+    memset((uint8_t *)(first + 1), 0xFF, first->size - sizeof(anim_cache_entry_t));
+    advance_time(100);
+    qp_internal_animation_tick();
+
+    const uint8_t *gram = qp_mock_display_gram(cached);
+    for (uint16_t y = 0; y < image->height; ++y) {
+        for (uint16_t x = 0; x < image->width; ++x) {
+            uint32_t i = ((uint32_t)(ANIM_Y + y) * SCENE_WIDTH + ANIM_X + x) * 2;
+            ASSERT_EQ(gram[i], 0xFF) << "pixel " << x << "," << y;
+            ASSERT_EQ(gram[i + 1], 0xFF) << "pixel " << x << "," << y;
+        }
+    }
+}
+
+TEST_F(QpAnimationCache, FullArenaFallsBackToDecoding) {
+    // Only the first frame fits, the others are decoded every time they're drawn
+    uint32_t arena_size = full_frame_size();
+    ASSERT_LT(arena_size, qp_animation_cache_size(cached, image));
+    ASSERT_TRUE(qp_animation_set_cache(cached_token, arena, arena_size));
+
+    for (uint16_t i = 0; i < 3 * image->frame_count; ++i) {
+        step();
+    }
+
+    const anim_cache_entry_t *first = (const anim_cache_entry_t *)arena;
+    EXPECT_EQ(first->size, arena_size);
+    EXPECT_EQ(first->left, 0);
+    EXPECT_EQ(first->top, 0);
+    EXPECT_EQ(first->right, image->width - 1);
+    EXPECT_EQ(first->bottom, image->height - 1);
+    EXPECT_TRUE(arena_untouched_from(arena_size));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Palette cache
+
+// Two 16-color palettes which only differ in their last two entries, picked so that both have the FNV-1a hash 0x3AE1EDE0
+static const uint8_t collision_tail_a[6] = {26, 49, 211, 247, 166, 224};
+static const uint8_t collision_tail_b[6] = {20, 135, 144, 31, 46, 93};
+static const uint8_t other_tail[6]       = {0, 0, 255, 0, 0, 0};
+
+class QpPaletteCache : public ::testing::Test {
+   protected:
+    static painter_device_t display;
+
+    static void SetUpTestSuite() {
+        display = qp_mock_display_make(SCENE_WIDTH, SCENE_HEIGHT);
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(qp_init(display, QP_ROTATION_0));
+        qp_internal_invalidate_palette();
+        qp_mock_display_reset_stats(display);
+    }
+
+    // Loads a palette block as it appears in a QGF/QFF asset, returning the native palette it produced
+    static std::vector<uint16_t> convert(const uint8_t tail[6]) {
+        std::vector<uint8_t> block = {QGF_FRAME_PALETTE_DESCRIPTOR_TYPEID, (uint8_t)~QGF_FRAME_PALETTE_DESCRIPTOR_TYPEID, 48, 0, 0};
+        for (uint8_t i = 0; i < 14; ++i) {
+            block.insert(block.end(), {(uint8_t)(i * 16), 255, 255});
+        }
+        block.insert(block.end(), tail, tail + 6);
+
+        qp_memory_stream_t stream = qp_make_memory_stream(block.data(), block.size());
+        EXPECT_TRUE(qp_internal_convert_qgf_palette(display, (qp_stream_t *)&stream, 4));
+
+        std::vector<uint16_t> native;
+        for (uint8_t i = 0; i < 16; ++i) {
+            native.push_back(qp_internal_global_pixel_lookup_table[i].rgb565);
+        }
+        return native;
+    }
+
+    static uint32_t converts() {
+        return qp_mock_display_stats(display).palette_converts;
+    }
+};
+
+painter_device_t QpPaletteCache::display;
+
+TEST_F(QpPaletteCache, RepeatedPaletteIsNotConvertedAgain) {
+    std::vector<uint16_t> first = convert(collision_tail_a);
+    convert(other_tail);
+    EXPECT_EQ(converts(), 2);
+
+    EXPECT_EQ(convert(collision_tail_a), first);
+    EXPECT_EQ(converts(), 2);
+}
+
+TEST_F(QpPaletteCache, DifferentPaletteIsConverted) {
+    std::vector<uint16_t> first = convert(collision_tail_a);
+    std::vector<uint16_t> other = convert(other_tail);
+    EXPECT_EQ(converts(), 2);
+    EXPECT_NE(first, other);
+}
+
+TEST_F(QpPaletteCache, HashCollisionIsConverted) {
+    std::vector<uint16_t> a = convert(collision_tail_a);
+    std::vector<uint16_t> b = convert(collision_tail_b);
+    EXPECT_EQ(converts(), 2);
+    EXPECT_NE(a, b);
+
+    // Matches what the palette converts to with nothing cached
+    qp_internal_invalidate_palette();
+    EXPECT_EQ(convert(collision_tail_b), b);
+}
+
+TEST(QpSurface, Rejects8bppWithout256Palette) {
+    // Drawing an 8bpp surface needs 256 palette entries, the default lookup table only holds 16
+    static uint8_t buffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(SCENE_WIDTH, SCENE_HEIGHT, 8)];
+    EXPECT_EQ(qp_make_surface(SCENE_WIDTH, SCENE_HEIGHT, 8, buffer), nullptr);
+}
@@ -0,0 +1,84 @@
+qp_fill_INC := \
+	$(QUANTUM_PATH)/painter
+
+qp_fill_SRC := \
+	$(QUANTUM_PATH)/painter/tests/qp_fill_tests.cpp
+
+qp_lz_INC := \
+	$(QUANTUM_PATH)/painter
+
+qp_lz_SRC := \
+	$(QUANTUM_PATH)/painter/tests/qp_lz_tests.cpp
+
+qp_font_lookup_DEFS := \
+	-include stdio.h \
+	-DQUANTUM_PAINTER_ENABLE \
+	-DQUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE=2
+
+qp_font_lookup_INC := \
+	$(QUANTUM_PATH)/painter \
+	$(QUANTUM_PATH)/unicode
+
+qp_font_lookup_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/logging/debug.c \
+	$(QUANTUM_PATH)/unicode/utf8.c \
+	$(QUANTUM_PATH)/painter/qp.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qgf.c \
+	$(QUANTUM_PATH)/painter/qff.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/qp_draw_text.c \
+	$(QUANTUM_PATH)/painter/tests/qp_font_lookup_tests.cpp
+
+# qp_stream.h pulls in stdio.h after debug.h has defined dprintf, which clashes with glibc's declaration
+qp_render_DEFS := \
+	-include stdio.h \
+	-DQUANTUM_PAINTER_ENABLE \
+	-DQUANTUM_PAINTER_SURFACE_ENABLE \
+	-DQUANTUM_PAINTER_ANIMATIONS_ENABLE \
+	-DQUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS=1 \
+	-DQUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION=1 \
+	-DQUANTUM_PAINTER_PALETTE_CACHE_SIZE=4 \
+	-DQUANTUM_PAINTER_DISPLAY_TIMEOUT=0 \
+	-DDEFERRED_EXEC_ENABLE
+
+qp_render_INC := \
+	$(QUANTUM_PATH)/painter \
+	$(QUANTUM_PATH)/painter/tests \
+	$(QUANTUM_PATH)/painter/tests/assets \
+	$(QUANTUM_PATH)/painter/tests/golden \
+	$(QUANTUM_PATH)/unicode \
+	$(DRIVER_PATH)/painter/generic
+
+qp_render_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/deferred_exec.c \
+	$(QUANTUM_PATH)/logging/debug.c \
+	$(QUANTUM_PATH)/unicode/utf8.c \
+	$(QUANTUM_PATH)/painter/qp.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_internal.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qgf.c \
+	$(QUANTUM_PATH)/painter/qff.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/qp_draw_circle.c \
+	$(QUANTUM_PATH)/painter/qp_draw_ellipse.c \
+	$(QUANTUM_PATH)/painter/qp_draw_image.c \
+	$(QUANTUM_PATH)/painter/qp_draw_text.c \
+	$(DRIVER_PATH)/painter/generic/qp_surface.c \
+	$(QUANTUM_PATH)/painter/tests/qp_mock_display.c \
+	$(QUANTUM_PATH)/painter/tests/assets/thintel15.qff.c \
+	$(QUANTUM_PATH)/painter/tests/assets/qp_test_image.qgf.c \
+	$(QUANTUM_PATH)/painter/tests/assets/qp_test_anim.qgf.c \
+	$(QUANTUM_PATH)/painter/tests/golden/golden_primitives.qgf.c \
+	$(QUANTUM_PATH)/painter/tests/golden/golden_text.qgf.c \
+	$(QUANTUM_PATH)/painter/tests/golden/golden_image.qgf.c \
+	$(QUANTUM_PATH)/painter/tests/golden/golden_animation.qgf.c \
+	$(QUANTUM_PATH)/painter/tests/qp_render_tests.cpp
@@ -0,0 +1,4 @@
+TEST_LIST += qp_fill
+TEST_LIST += qp_lz
+TEST_LIST += qp_font_lookup
+TEST_LIST += qp_render
@@ -17,6 +17,7 @@
  */
 
 #include "pointing_device.h"
+#include <stdlib.h>
 #include <string.h>
 #include "timer.h"
 #ifdef MOUSEKEY_ENABLE
@@ -37,8 +38,11 @@
 #    include "transactions.h"
 #    include "keyboard.h"
 
-report_mouse_t shared_mouse_report = {};
-uint16_t       shared_cpi          = 0;
+report_mouse_t                  shared_mouse_report  = {};
+uint16_t                        shared_cpi           = 0;
+static pointing_device_motion_t shared_motion        = {};
+static pointing_device_motion_t shared_motion_sent   = {};
+static bool                     shared_motion_resync = true;
 
 /**
  * @brief Sets the shared mouse report used be pointing device task
@@ -51,6 +55,35 @@ void pointing_device_set_shared_report(report_mouse_t new_mouse_report) {
     shared_mouse_report = new_mouse_report;
 }
 
+/**
+ * @brief Sets the motion totals of the shared pointing device
+ *
+ * The totals are absolute, so receiving the same totals more than once doesn't repeat any motion. The first totals
+ * after a resync only set the starting point, as the other side restarts them from zero when it resets.
+ *
+ * NOTE : Only available when using SPLIT_POINTING_ENABLE
+ *
+ * @param[in] motion pointing_device_motion_t totals from the other side
+ */
+void pointing_device_set_shared_motion(pointing_device_motion_t motion) {
+    shared_motion = motion;
+    if (shared_motion_resync) {
+        shared_motion_sent   = motion;
+        shared_motion_resync = false;
+    }
+}
+
+/**
+ * @brief Discards shared motion which hasn't been sent once the next totals arrive
+ *
+ * Called when a transfer from the other side fails, as it may have been reset before the link comes back.
+ *
+ * NOTE : Only available when using SPLIT_POINTING_ENABLE
+ */
+void pointing_device_resync_shared_motion(void) {
+    shared_motion_resync = true;
+}
+
 /**
  * @brief Gets current pointing device CPI if supported
  *
@@ -74,8 +107,16 @@ uint16_t pointing_device_get_shared_cpi(void) {
 
 #endif // defined(SPLIT_POINTING_ENABLE)
 
-static report_mouse_t local_mouse_report         = {};
-static bool           pointing_device_force_send = false;
+static report_mouse_t           local_mouse_report         = {};
+static bool                     pointing_device_force_send = false;
+static pointing_device_motion_t local_motion               = {};
+static pointing_device_motion_t local_motion_sent          = {};
+#if defined(POINTING_DEVICE_ACCEL_ENABLE) || defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE)
+static pointing_device_carry_t local_carry = {};
+#    if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+static pointing_device_carry_t shared_carry = {};
+#    endif
+#endif
 
 extern const pointing_device_driver_t pointing_device_driver;
 
@@ -216,6 +257,236 @@ report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report) {
     return mouse_report;
 }
 
+/**
+ * @brief Moves motion which hasn't been sent yet into a report axis
+ *
+ * Takes as much of the difference between the running total and the motion already sent as the axis has room for,
+ * leaving the rest to be carried into the following reports.
+ *
+ * @param[in] value mouse_xy_report_t current axis value
+ * @param[in] total uint32_t running total of motion
+ * @param[in,out] sent uint32_t* motion already sent, advanced by the amount taken
+ * @return mouse_xy_report_t new axis value
+ */
+static mouse_xy_report_t pointing_device_drain_axis(mouse_xy_report_t value, uint32_t total, uint32_t *sent) {
+    int32_t pending = (int32_t)(total - *sent);
+
+    if (pending > (int32_t)XY_REPORT_MAX - value) {
+        pending = (int32_t)XY_REPORT_MAX - value;
+    } else if (pending < (int32_t)XY_REPORT_MIN - value) {
+        pending = (int32_t)XY_REPORT_MIN - value;
+    }
+    *sent += pending;
+    return value + pending;
+}
+
+/**
+ * @brief Adds unsent motion to a mouse report
+ *
+ * @param[in] mouse_report report_mouse_t
+ * @param[in] total pointing_device_motion_t* running totals of motion
+ * @param[in,out] sent pointing_device_motion_t* motion already sent
+ * @return report_mouse_t with the motion added
+ */
+static report_mouse_t pointing_device_drain_motion(report_mouse_t mouse_report, const pointing_device_motion_t *total, pointing_device_motion_t *sent) {
+    mouse_report.x = pointing_device_drain_axis(mouse_report.x, total->x, &sent->x);
+    mouse_report.y = pointing_device_drain_axis(mouse_report.y, total->y, &sent->y);
+    return mouse_report;
+}
+
+/**
+ * @brief Checks whether the pointing device has motion to read
+ *
+ * @return true if the motion pin is asserted, or if there is no motion pin
+ */
+bool pointing_device_motion_detected(void) {
+#if defined(POINTING_DEVICE_MOTION_PIN)
+#    if defined(POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW)
+    return !readPin(POINTING_DEVICE_MOTION_PIN);
+#    else
+    return readPin(POINTING_DEVICE_MOTION_PIN);
+#    endif
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Checks whether the driver should be asked for a report
+ *
+ * Drivers which buffer their own samples are always asked, as they may still have samples or gestures
+ * to finish after the motion pin has gone idle.
+ *
+ * @return true if the driver samples on its own or the motion pin is active
+ */
+bool pointing_device_report_ready(void) {
+    return pointing_device_driver.sample != NULL || pointing_device_motion_detected();
+}
+
+/**
+ * @brief Adds sensor motion to the running totals
+ *
+ * Drivers call this instead of writing the deltas into the report, so motion that doesn't fit in one report
+ * is sent in the next ones rather than clamped away.
+ *
+ * @param[in] x int16_t motion along x
+ * @param[in] y int16_t motion along y
+ */
+void pointing_device_add_motion(int16_t x, int16_t y) {
+    local_motion.x += x;
+    local_motion.y += y;
+}
+
+/**
+ * @brief Gets the running totals of this side's sensor motion
+ *
+ * @return pointing_device_motion_t
+ */
+pointing_device_motion_t pointing_device_get_motion(void) {
+    return local_motion;
+}
+
+/**
+ * @brief Scales a value, carrying the fraction and anything beyond the output range into later calls
+ *
+ * @param[in] value int16_t value to scale
+ * @param[in] scale uint16_t fixed-point scale factor
+ * @param[in,out] carry int32_t* fixed-point remainder from earlier calls
+ * @param[in] min int16_t smallest output
+ * @param[in] max int16_t largest output
+ * @return int16_t scaled value
+ */
+static int16_t pointing_device_scale_carry(int16_t value, uint16_t scale, int32_t *carry, int16_t min, int16_t max) {
+    const int32_t carry_limit = (int32_t)INT16_MAX << POINTING_DEVICE_SCALE_SHIFT;
+    int32_t       total       = (int32_t)value * scale + *carry;
+    int32_t       output      = total / (1 << POINTING_DEVICE_SCALE_SHIFT);
+
+    if (output > max) {
+        output = max;
+    } else if (output < min) {
+        output = min;
+    }
+    total -= output * (1 << POINTING_DEVICE_SCALE_SHIFT);
+
+    // Bound the backlog, so a long run of saturated reports can't overflow it
+    if (total > carry_limit) {
+        total = carry_limit;
+    } else if (total < -carry_limit) {
+        total = -carry_limit;
+    }
+    *carry = total;
+    return output;
+}
+
+/**
+ * @brief Scales x/y motion without losing the fractional remainder
+ *
+ * Useful for CPI scaling or slowing down the cursor, where truncating every report would lose slow movements.
+ *
+ * @param[in] value int16_t motion to scale
+ * @param[in] scale uint16_t fixed-point scale factor, see POINTING_DEVICE_SCALE()
+ * @param[in,out] carry int32_t* remainder for this axis, kept by the caller between reports
+ * @return mouse_xy_report_t scaled motion
+ */
+mouse_xy_report_t pointing_device_scale_xy(int16_t value, uint16_t scale, int32_t *carry) {
+    return pointing_device_scale_carry(value, scale, carry, XY_REPORT_MIN, XY_REPORT_MAX);
+}
+
+/**
+ * @brief Scales wheel motion without losing the fractional remainder
+ *
+ * Useful for drag scroll, where dividing the x/y motion every report would lose slow movements.
+ *
+ * @param[in] value int16_t motion to scale
+ * @param[in] scale uint16_t fixed-point scale factor, see POINTING_DEVICE_SCALE()
+ * @param[in,out] carry int32_t* remainder for this axis, kept by the caller between reports
+ * @return int8_t scaled motion
+ */
+int8_t pointing_device_scale_hv(int16_t value, uint16_t scale, int32_t *carry) {
+    return pointing_device_scale_carry(value, scale, carry, INT8_MIN, INT8_MAX);
+}
+
+/**
+ * @brief Scales all axes of a mouse report without losing fractional remainders
+ *
+ * @param[in] mouse_report report_mouse_t
+ * @param[in] xy_scale uint16_t fixed-point scale factor for x/y
+ * @param[in] hv_scale uint16_t fixed-point scale factor for h/v
+ * @param[in,out] carry pointing_device_carry_t* remainders, kept by the caller between reports
+ * @return report_mouse_t scaled report
+ */
+report_mouse_t pointing_device_scale_report(report_mouse_t mouse_report, uint16_t xy_scale, uint16_t hv_scale, pointing_device_carry_t *carry) {
+    mouse_report.x = pointing_device_scale_xy(mouse_report.x, xy_scale, &carry->x);
+    mouse_report.y = pointing_device_scale_xy(mouse_report.y, xy_scale, &carry->y);
+    mouse_report.h = pointing_device_scale_hv(mouse_report.h, hv_scale, &carry->h);
+    mouse_report.v = pointing_device_scale_hv(mouse_report.v, hv_scale, &carry->v);
+    return mouse_report;
+}
+
+/**
+ * @brief Gets the number of wheel counts per notch
+ *
+ * The host enables the Resolution Multiplier when it supports high resolution scrolling, until then each count
+ * is a whole notch.
+ *
+ * @return uint16_t POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER if the host has enabled high resolution scrolling, otherwise 1
+ */
+uint16_t pointing_device_get_hires_scroll_resolution(void) {
+#if defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE)
+    return host_mouse_resolution_multiplier() ? POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER : 1;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Converts wheel motion in whole notches to the wheel resolution the host has enabled
+ *
+ * For wheel sources that step a notch at a time, such as mouse keys and encoders. Anything beyond the report range
+ * is clamped.
+ *
+ * @param[in] notches int16_t wheel motion in notches
+ * @return int8_t wheel motion in wheel counts
+ */
+int8_t pointing_device_scale_notches(int16_t notches) {
+    int32_t counts = (int32_t)notches * pointing_device_get_hires_scroll_resolution();
+
+    if (counts > INT8_MAX) {
+        return INT8_MAX;
+    } else if (counts < INT8_MIN) {
+        return INT8_MIN;
+    }
+    return counts;
+}
+
+#if defined(POINTING_DEVICE_ACCEL_ENABLE) || defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE)
+/**
+ * @brief Applies the configured acceleration curve and wheel resolution to a report
+ *
+ * Acceleration grows linearly with the speed of the motion, up to POINTING_DEVICE_ACCEL_LIMIT. Wheel motion is
+ * converted to high resolution counts, so drivers and callbacks can keep working in whole notches.
+ *
+ * @param[in] mouse_report report_mouse_t
+ * @param[in,out] carry pointing_device_carry_t* remainders for this report's source
+ * @return report_mouse_t scaled report
+ */
+static report_mouse_t pointing_device_apply_scaling(report_mouse_t mouse_report, pointing_device_carry_t *carry) {
+    uint16_t xy_scale = 1 << POINTING_DEVICE_SCALE_SHIFT;
+    uint16_t hv_scale = pointing_device_get_hires_scroll_resolution() << POINTING_DEVICE_SCALE_SHIFT;
+
+#    if defined(POINTING_DEVICE_ACCEL_ENABLE)
+    // Octagonal approximation of the distance moved, max + min / 2
+    uint16_t dx    = abs(mouse_report.x);
+    uint16_t dy    = abs(mouse_report.y);
+    uint32_t speed = dx > dy ? dx + dy / 2 : dy + dx / 2;
+    uint32_t accel = xy_scale + speed * POINTING_DEVICE_ACCEL_GROWTH;
+
+    xy_scale = accel > POINTING_DEVICE_ACCEL_LIMIT ? POINTING_DEVICE_ACCEL_LIMIT : accel;
+#    endif
+    return pointing_device_scale_report(mouse_report, xy_scale, hv_scale, carry);
+}
+#endif
+
 /**
  * @brief Retrieves and processes pointing device data.
  *
@@ -231,6 +502,13 @@ __attribute__((weak)) bool pointing_device_task(void) {
     };
 #endif
 
+#if defined(POINTING_DEVICE_MOTION_PIN)
+    // Sampling drivers read each sample as soon as it's ready, so none are missed between throttled reports
+    if (pointing_device_driver.sample != NULL && pointing_device_motion_detected()) {
+        pointing_device_driver.sample();
+    }
+#endif
+
 #if (POINTING_DEVICE_TASK_THROTTLE_MS > 0)
     static uint32_t last_exec = 0;
     if (timer_elapsed32(last_exec) < POINTING_DEVICE_TASK_THROTTLE_MS) {
@@ -240,42 +518,48 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #endif
 
     // Gather report info
-#ifdef POINTING_DEVICE_MOTION_PIN
-#    if defined(SPLIT_POINTING_ENABLE)
-#        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
-#    endif
-#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-    if (!readPin(POINTING_DEVICE_MOTION_PIN))
-#    else
-    if (readPin(POINTING_DEVICE_MOTION_PIN))
-#    endif
-#endif
-
 #if defined(SPLIT_POINTING_ENABLE)
+    report_mouse_t shared_report = pointing_device_drain_motion(shared_mouse_report, &shared_motion, &shared_motion_sent);
 #    if defined(POINTING_DEVICE_COMBINED)
-        static uint8_t old_buttons = 0;
+    static uint8_t old_buttons = 0;
     local_mouse_report.buttons = old_buttons;
-    local_mouse_report         = pointing_device_driver.get_report(local_mouse_report);
-    old_buttons                = local_mouse_report.buttons;
+    if (pointing_device_report_ready()) {
+        local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    }
+    old_buttons = local_mouse_report.buttons;
 #    elif defined(POINTING_DEVICE_LEFT) || defined(POINTING_DEVICE_RIGHT)
-        local_mouse_report = POINTING_DEVICE_THIS_SIDE ? pointing_device_driver.get_report(local_mouse_report) : shared_mouse_report;
+    if (!POINTING_DEVICE_THIS_SIDE) {
+        local_mouse_report = shared_report;
+    } else if (pointing_device_report_ready()) {
+        local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    }
 #    else
 #        error "You need to define the side(s) the pointing device is on. POINTING_DEVICE_COMBINED / POINTING_DEVICE_LEFT / POINTING_DEVICE_RIGHT"
 #    endif
 #else
-    local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    if (pointing_device_report_ready()) {
+        local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    }
 #endif // defined(SPLIT_POINTING_ENABLE)
+    // Motion from earlier reads which didn't fit in earlier reports is sent even if the motion pin is idle now
+    local_mouse_report = pointing_device_drain_motion(local_mouse_report, &local_motion, &local_motion_sent);
+#if defined(POINTING_DEVICE_ACCEL_ENABLE) || defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE)
+    local_mouse_report = pointing_device_apply_scaling(local_mouse_report, &local_carry);
+#    if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+    shared_report = pointing_device_apply_scaling(shared_report, &shared_carry);
+#    endif
+#endif
 
     // allow kb to intercept and modify report
 #if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
     if (is_keyboard_left()) {
-        local_mouse_report  = pointing_device_adjust_by_defines(local_mouse_report);
-        shared_mouse_report = pointing_device_adjust_by_defines_right(shared_mouse_report);
+        local_mouse_report = pointing_device_adjust_by_defines(local_mouse_report);
+        shared_report      = pointing_device_adjust_by_defines_right(shared_report);
     } else {
-        local_mouse_report  = pointing_device_adjust_by_defines_right(local_mouse_report);
-        shared_mouse_report = pointing_device_adjust_by_defines(shared_mouse_report);
+        local_mouse_report = pointing_device_adjust_by_defines_right(local_mouse_report);
+        shared_report      = pointing_device_adjust_by_defines(shared_report);
     }
-    local_mouse_report = is_keyboard_left() ? pointing_device_task_combined_kb(local_mouse_report, shared_mouse_report) : pointing_device_task_combined_kb(shared_mouse_report, local_mouse_report);
+    local_mouse_report = is_keyboard_left() ? pointing_device_task_combined_kb(local_mouse_report, shared_report) : pointing_device_task_combined_kb(shared_report, local_mouse_report);
 #else
     local_mouse_report = pointing_device_adjust_by_defines(local_mouse_report);
     local_mouse_report = pointing_device_task_kb(local_mouse_report);
@@ -76,6 +76,7 @@ typedef struct {
     report_mouse_t (*get_report)(report_mouse_t mouse_report);
     void (*set_cpi)(uint16_t);
     uint16_t (*get_cpi)(void);
+    void (*sample)(void); // optional, buffers a sample each time the motion pin is active
 } pointing_device_driver_t;
 
 typedef enum {
@@ -99,6 +100,34 @@ typedef int32_t clamp_range_t;
 typedef int16_t clamp_range_t;
 #endif
 
+// Running totals of sensor motion, wrapping on overflow. Reports take as much of the difference between these
+// and the motion already sent as fits, so motion which doesn't fit in one report is carried into the next.
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+} pointing_device_motion_t;
+
+// Scale factors are fixed-point, with POINTING_DEVICE_SCALE_SHIFT fractional bits
+#define POINTING_DEVICE_SCALE_SHIFT 8
+#define POINTING_DEVICE_SCALE(numerator, denominator) ((uint16_t)(((uint32_t)(numerator) << POINTING_DEVICE_SCALE_SHIFT) / (denominator)))
+
+// Scaled motion which hasn't been sent yet, as fixed-point remainders for each axis
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t h;
+    int32_t v;
+} pointing_device_carry_t;
+
+#if defined(POINTING_DEVICE_ACCEL_ENABLE)
+#    if !defined(POINTING_DEVICE_ACCEL_GROWTH)
+#        define POINTING_DEVICE_ACCEL_GROWTH 8
+#    endif
+#    if !defined(POINTING_DEVICE_ACCEL_LIMIT)
+#        define POINTING_DEVICE_ACCEL_LIMIT POINTING_DEVICE_SCALE(4, 1)
+#    endif
+#endif
+
 void           pointing_device_init(void);
 bool           pointing_device_task(void);
 bool           pointing_device_send(void);
@@ -106,6 +135,17 @@ report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t mouse_report);
 uint16_t       pointing_device_get_cpi(void);
 void           pointing_device_set_cpi(uint16_t cpi);
+bool           pointing_device_motion_detected(void);
+bool           pointing_device_report_ready(void);
+void           pointing_device_add_motion(int16_t x, int16_t y);
+
+pointing_device_motion_t pointing_device_get_motion(void);
+
+mouse_xy_report_t pointing_device_scale_xy(int16_t value, uint16_t scale, int32_t *carry);
+int8_t            pointing_device_scale_hv(int16_t value, uint16_t scale, int32_t *carry);
+report_mouse_t    pointing_device_scale_report(report_mouse_t mouse_report, uint16_t xy_scale, uint16_t hv_scale, pointing_device_carry_t *carry);
+uint16_t          pointing_device_get_hires_scroll_resolution(void);
+int8_t            pointing_device_scale_notches(int16_t notches);
 
 void           pointing_device_init_kb(void);
 void           pointing_device_init_user(void);
@@ -117,6 +157,8 @@ void           pointing_device_keycode_handler(uint16_t keycode, bool pressed);
 
 #if defined(SPLIT_POINTING_ENABLE)
 void     pointing_device_set_shared_report(report_mouse_t report);
+void     pointing_device_set_shared_motion(pointing_device_motion_t motion);
+void     pointing_device_resync_shared_motion(void);
 uint16_t pointing_device_get_shared_cpi(void);
 #    if !defined(POINTING_DEVICE_TASK_THROTTLE_MS)
 #        define POINTING_DEVICE_TASK_THROTTLE_MS 1
@@ -34,8 +34,7 @@ report_mouse_t adns5050_get_report(report_mouse_t mouse_report) {
 
     if (data.dx != 0 || data.dy != 0) {
         pd_dprintf("Raw ] X: %d, Y: %d\n", data.dx, data.dy);
-        mouse_report.x = (mouse_xy_report_t)data.dx;
-        mouse_report.y = (mouse_xy_report_t)data.dy;
+        pointing_device_add_motion(data.dx, data.dy);
     }
 
     return mouse_report;
@@ -56,8 +55,7 @@ report_mouse_t pmw3320_get_report(report_mouse_t mouse_report) {
 
     if (data.dx != 0 || data.dy != 0) {
         pd_dprintf("Raw ] X: %d, Y: %d\n", data.dx, data.dy);
-        mouse_report.x = (mouse_xy_report_t)data.dx;
-        mouse_report.y = (mouse_xy_report_t)data.dy;
+        pointing_device_add_motion(data.dx, data.dy);
     }
 
     return mouse_report;
@@ -77,8 +75,7 @@ const pointing_device_driver_t pointing_device_driver = {
 report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
     report_adns9800_t sensor_report = adns9800_get_report();
 
-    mouse_report.x = CONSTRAIN_HID_XY(sensor_report.x);
-    mouse_report.y = CONSTRAIN_HID_XY(sensor_report.y);
+    pointing_device_add_motion(sensor_report.x, sensor_report.y);
 
     return mouse_report;
 }
@@ -145,73 +142,83 @@ bool auto_mouse_activation(report_mouse_t mouse_report) {
 #        endif
 
 report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
-    uint16_t          scale     = cirque_pinnacle_get_scale();
-    pinnacle_data_t   touchData = cirque_pinnacle_read_data();
-    mouse_xy_report_t report_x = 0, report_y = 0;
-    static uint16_t   x = 0, y = 0, last_scale = 0;
+    uint16_t        scale    = cirque_pinnacle_get_scale();
+    uint8_t         budget   = CIRQUE_PINNACLE_GESTURE_BUDGET;
+    int16_t         report_x = 0, report_y = 0;
+    pinnacle_data_t touchData;
+    static uint16_t x = 0, y = 0, last_scale = 0;
 
 #        if defined(CIRQUE_PINNACLE_TAP_ENABLE)
     mouse_report.buttons        = pointing_device_handle_buttons(mouse_report.buttons, false, POINTING_DEVICE_BUTTON1);
 #        endif
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
     cursor_glide_t glide_report = {0};
+    bool           sampled      = false;
 
     if (cursor_glide_enable) {
         glide_report = cursor_glide_check(&glide);
     }
 #        endif
 
-    if (!touchData.valid) {
-#        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
-        if (cursor_glide_enable && glide_report.valid) {
-            report_x = glide_report.dx;
-            report_y = glide_report.dy;
-            goto mouse_report_update;
-        }
-#        endif
-        return mouse_report;
+    // Samples are usually buffered as soon as the data ready line goes active, this catches any left
+    if (pointing_device_motion_detected()) {
+        cirque_pinnacle_sample();
     }
 
-    if (touchData.touchDown) {
-        pd_dprintf("cirque_pinnacle touchData x=%4d y=%4d z=%2d\n", touchData.xValue, touchData.yValue, touchData.zValue);
-    }
+    // Only a few samples go through the gestures per report, any others wait for the next one
+    while (budget-- && cirque_pinnacle_next_sample(&touchData)) {
+#        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
+        sampled = true;
+#        endif
+        if (touchData.touchDown) {
+            pd_dprintf("cirque_pinnacle touchData x=%4d y=%4d z=%2d\n", touchData.xValue, touchData.yValue, touchData.zValue);
+        }
 
 #        ifdef POINTING_DEVICE_AUTO_MOUSE_ENABLE
-    is_touch_down = touchData.touchDown;
+        is_touch_down = touchData.touchDown;
 #        endif
 
-    // Scale coordinates to arbitrary X, Y resolution
-    cirque_pinnacle_scale_data(&touchData, scale, scale);
+        // Scale coordinates to arbitrary X, Y resolution
+        cirque_pinnacle_scale_data(&touchData, scale, scale);
 
-    if (!cirque_pinnacle_gestures(&mouse_report, touchData)) {
-        if (last_scale && scale == last_scale && x && y && touchData.xValue && touchData.yValue) {
-            report_x = CONSTRAIN_HID_XY((int16_t)(touchData.xValue - x));
-            report_y = CONSTRAIN_HID_XY((int16_t)(touchData.yValue - y));
-        }
-        x          = touchData.xValue;
-        y          = touchData.yValue;
-        last_scale = scale;
+        if (!cirque_pinnacle_gestures(&mouse_report, touchData)) {
+            int16_t dx = 0, dy = 0;
+
+            if (last_scale && scale == last_scale && x && y && touchData.xValue && touchData.yValue) {
+                dx = (int16_t)(touchData.xValue - x);
+                dy = (int16_t)(touchData.yValue - y);
+            }
+            x          = touchData.xValue;
+            y          = touchData.yValue;
+            last_scale = scale;
 
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
-        if (cursor_glide_enable) {
-            if (touchData.touchDown) {
-                cursor_glide_update(&glide, report_x, report_y, touchData.zValue);
-            } else if (!glide_report.valid) {
-                glide_report = cursor_glide_start(&glide);
-                if (glide_report.valid) {
-                    report_x = glide_report.dx;
-                    report_y = glide_report.dy;
+            if (cursor_glide_enable) {
+                if (touchData.touchDown) {
+                    cursor_glide_update(&glide, CONSTRAIN_HID_XY(dx), CONSTRAIN_HID_XY(dy), touchData.zValue);
+                } else if (!glide_report.valid) {
+                    glide_report = cursor_glide_start(&glide);
+                    if (glide_report.valid) {
+                        dx = glide_report.dx;
+                        dy = glide_report.dy;
+                    }
                 }
             }
-        }
 #        endif
+            report_x += dx;
+            report_y += dy;
+        }
     }
 
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
-mouse_report_update:
+    if (!sampled && cursor_glide_enable && glide_report.valid) {
+        report_x = glide_report.dx;
+        report_y = glide_report.dy;
+    }
 #        endif
-    mouse_report.x = report_x;
-    mouse_report.y = report_y;
+
+    // Movement beyond the report range is carried into the next reports
+    pointing_device_add_motion(report_x, report_y);
 
     return mouse_report;
 }
@@ -228,21 +235,27 @@ const pointing_device_driver_t pointing_device_driver = {
     .init       = cirque_pinnacle_init,
     .get_report = cirque_pinnacle_get_report,
     .set_cpi    = cirque_pinnacle_set_cpi,
-    .get_cpi    = cirque_pinnacle_get_cpi
+    .get_cpi    = cirque_pinnacle_get_cpi,
+    .sample     = cirque_pinnacle_sample
 };
 // clang-format on
 #    else
 report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
-    pinnacle_data_t touchData = cirque_pinnacle_read_data();
+    uint8_t         budget = CIRQUE_PINNACLE_GESTURE_BUDGET;
+    pinnacle_data_t touchData;
+
+    // Samples are usually buffered as soon as the data ready line goes active, this catches any left
+    if (pointing_device_motion_detected()) {
+        cirque_pinnacle_sample();
+    }
 
-    // Scale coordinates to arbitrary X, Y resolution
-    cirque_pinnacle_scale_data(&touchData, cirque_pinnacle_get_scale(), cirque_pinnacle_get_scale());
+    while (budget-- && cirque_pinnacle_next_sample(&touchData)) {
+        // Scale coordinates to arbitrary X, Y resolution
+        cirque_pinnacle_scale_data(&touchData, cirque_pinnacle_get_scale(), cirque_pinnacle_get_scale());
 
-    if (touchData.valid) {
         mouse_report.buttons = touchData.buttons;
-        mouse_report.x       = CONSTRAIN_HID_XY(touchData.xDelta);
-        mouse_report.y       = CONSTRAIN_HID_XY(touchData.yDelta);
-        mouse_report.v       = touchData.wheelCount;
+        mouse_report.v       = CONSTRAIN_HID((int16_t)mouse_report.v + touchData.wheelCount);
+        pointing_device_add_motion(touchData.xDelta, touchData.yDelta);
     }
     return mouse_report;
 }
@@ -252,7 +265,8 @@ const pointing_device_driver_t pointing_device_driver = {
     .init       = cirque_pinnacle_init,
     .get_report = cirque_pinnacle_get_report,
     .set_cpi    = cirque_pinnacle_set_scale,
-    .get_cpi    = cirque_pinnacle_get_scale
+    .get_cpi    = cirque_pinnacle_get_scale,
+    .sample     = cirque_pinnacle_sample
 };
 // clang-format on
 #    endif
@@ -264,8 +278,7 @@ report_mouse_t paw3204_get_report(report_mouse_t mouse_report) {
     if (data.isMotion) {
         pd_dprintf("Raw ] X: %d, Y: %d\n", data.x, data.y);
 
-        mouse_report.x = data.x;
-        mouse_report.y = data.y;
+        pointing_device_add_motion(data.x, data.y);
     }
 
     return mouse_report;
@@ -365,8 +378,7 @@ report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
         pd_dprintf("PWM3360 (0): starting motion\n");
     }
 
-    mouse_report.x = CONSTRAIN_HID_XY(report.delta_x);
-    mouse_report.y = CONSTRAIN_HID_XY(report.delta_y);
+    pointing_device_add_motion(report.delta_x, report.delta_y);
     return mouse_report;
 }
 
@@ -0,0 +1,77 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "mock.h"
+
+report_mouse_t mock_reports[MOCK_MAX_REPORTS];
+uint8_t        mock_report_count;
+
+static int16_t sensor_x;
+static int16_t sensor_y;
+static int8_t  sensor_v;
+static int8_t  sensor_h;
+
+void mock_sensor_move(int16_t x, int16_t y) {
+    sensor_x += x;
+    sensor_y += y;
+}
+
+void mock_sensor_scroll(int8_t v, int8_t h) {
+    sensor_v += v;
+    sensor_h += h;
+}
+
+static void mock_init(void) {}
+
+static report_mouse_t mock_get_report(report_mouse_t mouse_report) {
+    pointing_device_add_motion(sensor_x, sensor_y);
+    sensor_x       = 0;
+    sensor_y       = 0;
+    mouse_report.v = sensor_v;
+    mouse_report.h = sensor_h;
+    sensor_v       = 0;
+    sensor_h       = 0;
+    return mouse_report;
+}
+
+static void mock_set_cpi(uint16_t cpi) {}
+
+static uint16_t mock_get_cpi(void) {
+    return 0;
+}
+
+const pointing_device_driver_t pointing_device_driver = {
+    .init       = mock_init,
+    .get_report = mock_get_report,
+    .set_cpi    = mock_set_cpi,
+    .get_cpi    = mock_get_cpi,
+};
+
+bool has_mouse_report_changed(report_mouse_t *new_report, report_mouse_t *old_report) {
+    return new_report->buttons != old_report->buttons || (new_report->x != 0 && new_report->x != old_report->x) || (new_report->y != 0 && new_report->y != old_report->y) || (new_report->h != 0 && new_report->h != old_report->h) || (new_report->v != 0 && new_report->v != old_report->v);
+}
+
+static uint8_t mock_keyboard_leds(void) {
+    return 0;
+}
+
+static void mock_send_keyboard(report_keyboard_t *report) {}
+
+static void mock_send_mouse(report_mouse_t *report) {
+    if (mock_report_count < MOCK_MAX_REPORTS) {
+        mock_reports[mock_report_count++] = *report;
+    }
+}
+
+static void mock_send_extra(report_extra_t *report) {}
+
+host_driver_t mock_host_driver = {mock_keyboard_leds, mock_send_keyboard, mock_send_mouse, mock_send_extra};
+
+bool is_keyboard_master(void) {
+    return true;
+}
+
+bool is_keyboard_left(void) {
+    return true;
+}
@@ -0,0 +1,19 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "pointing_device.h"
+#include "host_driver.h"
+
+#define MOCK_MAX_REPORTS 64
+
+// Motion the mock sensor reads on its next get_report()
+void mock_sensor_move(int16_t x, int16_t y);
+void mock_sensor_scroll(int8_t v, int8_t h);
+
+// Host driver recording the reports sent to the host
+extern host_driver_t mock_host_driver;
+
+// Reports sent to the host
+extern report_mouse_t mock_reports[MOCK_MAX_REPORTS];
+extern uint8_t        mock_report_count;
@@ -0,0 +1,163 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdlib.h>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "host.h"
+#include "pointing_device.h"
+#include "pointing_device/tests/mock.h"
+
+void advance_time(uint32_t ms);
+}
+
+class PointingDevice : public testing::Test {
+   protected:
+    void SetUp() override {
+        host_set_driver(&mock_host_driver);
+        // Send anything an earlier test left behind
+        while (task()) {
+        }
+        mock_report_count = 0;
+    }
+
+    bool task() {
+        advance_time(1);
+        return pointing_device_task();
+    }
+
+    // Runs the task until it stops sending, returning the motion it sent
+    void drain(int32_t *x, int32_t *y) {
+        *x = 0;
+        *y = 0;
+        for (uint8_t sent = mock_report_count; task(); sent = mock_report_count) {
+            ASSERT_EQ(mock_report_count, sent + 1);
+        }
+        for (uint8_t i = 0; i < mock_report_count; i++) {
+            *x += mock_reports[i].x;
+            *y += mock_reports[i].y;
+        }
+    }
+};
+
+TEST_F(PointingDevice, SmallMotionIsSentInOneReport) {
+    int32_t x, y;
+
+    mock_sensor_move(12, -34);
+    drain(&x, &y);
+    EXPECT_EQ(mock_report_count, 1);
+    EXPECT_EQ(x, 12);
+    EXPECT_EQ(y, -34);
+}
+
+TEST_F(PointingDevice, LargeMotionDrainsOverSeveralReports) {
+    int32_t x, y;
+
+    // The y total wraps below zero straight away
+    mock_sensor_move(1000, -300);
+    drain(&x, &y);
+
+    // 1000 counts need at least eight reports, each one as full as the report range allows
+    EXPECT_EQ(mock_report_count, 8);
+    for (uint8_t i = 0; i < mock_report_count; i++) {
+        EXPECT_LE(abs(mock_reports[i].x), XY_REPORT_MAX) << "report " << (int)i;
+    }
+    EXPECT_EQ(mock_reports[0].x, XY_REPORT_MAX);
+    EXPECT_EQ(mock_reports[0].y, -300 > XY_REPORT_MIN ? -300 : XY_REPORT_MIN);
+    EXPECT_EQ(x, 1000);
+    EXPECT_EQ(y, -300);
+}
+
+TEST_F(PointingDevice, NewMotionJoinsCarriedMotion) {
+    int32_t x, y;
+
+    mock_sensor_move(200, 0);
+    EXPECT_TRUE(task());
+    EXPECT_EQ(mock_reports[0].x, XY_REPORT_MAX);
+
+    // The 73 counts left over go out ahead of the new motion, not instead of it
+    mock_sensor_move(-50, 0);
+    drain(&x, &y);
+    EXPECT_EQ(mock_reports[1].x, 23);
+    EXPECT_EQ(x, 150);
+    EXPECT_EQ(y, 0);
+}
+
+TEST_F(PointingDevice, OpposingMotionCancelsBeforeSending) {
+    int32_t x, y;
+
+    mock_sensor_move(INT16_MAX, INT16_MIN);
+    mock_sensor_move(INT16_MIN, INT16_MAX);
+    drain(&x, &y);
+    EXPECT_EQ(x, -1);
+    EXPECT_EQ(y, -1);
+    EXPECT_LE(mock_report_count, 1);
+}
+
+TEST(PointingDeviceScale, CarriesFractions) {
+    int32_t carry = 0;
+    int32_t sum   = 0;
+
+    // A quarter of a count per report comes out as a whole count every fourth report
+    for (int i = 1; i <= 12; i++) {
+        int8_t x = pointing_device_scale_xy(1, POINTING_DEVICE_SCALE(1, 4), &carry);
+        EXPECT_EQ(x, i % 4 == 0 ? 1 : 0) << "report " << i;
+        sum += x;
+    }
+    EXPECT_EQ(sum, 3);
+
+    carry = 0;
+    sum   = 0;
+    for (int i = 1; i <= 12; i++) {
+        sum += pointing_device_scale_xy(-1, POINTING_DEVICE_SCALE(1, 4), &carry);
+    }
+    EXPECT_EQ(sum, -3);
+    EXPECT_EQ(carry, 0);
+}
+
+TEST(PointingDeviceScale, CarriesBeyondTheReportRange) {
+    int32_t carry = 0;
+
+    EXPECT_EQ(pointing_device_scale_hv(100, POINTING_DEVICE_SCALE(4, 1), &carry), INT8_MAX);
+    EXPECT_EQ(pointing_device_scale_hv(0, POINTING_DEVICE_SCALE(4, 1), &carry), INT8_MAX);
+    EXPECT_EQ(pointing_device_scale_hv(0, POINTING_DEVICE_SCALE(4, 1), &carry), INT8_MAX);
+    EXPECT_EQ(pointing_device_scale_hv(0, POINTING_DEVICE_SCALE(4, 1), &carry), 400 - 3 * INT8_MAX);
+    EXPECT_EQ(pointing_device_scale_hv(0, POINTING_DEVICE_SCALE(4, 1), &carry), 0);
+    EXPECT_EQ(carry, 0);
+}
+
+TEST(PointingDeviceScale, BoundsTheCarry) {
+    int32_t carry = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        pointing_device_scale_hv(INT16_MAX, POINTING_DEVICE_SCALE(8, 1), &carry);
+    }
+    EXPECT_EQ(carry, (int32_t)INT16_MAX << POINTING_DEVICE_SCALE_SHIFT);
+}
+
+TEST(PointingDeviceScale, ScalesEachAxisOfAReport) {
+    pointing_device_carry_t carry  = {};
+    report_mouse_t          report = {.buttons = 3, .x = 10, .y = -10, .v = 3, .h = -3};
+
+    report = pointing_device_scale_report(report, POINTING_DEVICE_SCALE(1, 4), POINTING_DEVICE_SCALE(1, 2), &carry);
+    EXPECT_EQ(report.buttons, 3);
+    EXPECT_EQ(report.x, 2);
+    EXPECT_EQ(report.y, -2);
+    EXPECT_EQ(report.v, 1);
+    EXPECT_EQ(report.h, -1);
+
+    // The halves left over from each axis add up in the next report
+    report = pointing_device_scale_report((report_mouse_t){.x = 2, .y = -2, .v = 1, .h = -1}, POINTING_DEVICE_SCALE(1, 4), POINTING_DEVICE_SCALE(1, 2), &carry);
+    EXPECT_EQ(report.x, 1);
+    EXPECT_EQ(report.y, -1);
+    EXPECT_EQ(report.v, 1);
+    EXPECT_EQ(report.h, -1);
+}
+
+TEST(PointingDeviceScale, NotchesAreWholeStepsWithoutHighResolutionScrolling) {
+    EXPECT_EQ(pointing_device_get_hires_scroll_resolution(), 1);
+    EXPECT_EQ(pointing_device_scale_notches(3), 3);
+    EXPECT_EQ(pointing_device_scale_notches(-200), INT8_MIN);
+}
@@ -0,0 +1,85 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "host.h"
+#include "pointing_device.h"
+#include "pointing_device/tests/mock.h"
+
+void advance_time(uint32_t ms);
+}
+
+class PointingDeviceHires : public testing::Test {
+   protected:
+    void SetUp() override {
+        host_set_driver(&mock_host_driver);
+        // Like a host without high resolution scrolling, until a test enables it
+        host_mouse_set_resolution_multiplier(0);
+        while (task()) {
+        }
+        mock_report_count = 0;
+    }
+
+    bool task() {
+        advance_time(1);
+        return pointing_device_task();
+    }
+
+    int32_t sent_v() {
+        int32_t v = 0;
+        for (uint8_t i = 0; i < mock_report_count; i++) {
+            v += mock_reports[i].v;
+        }
+        return v;
+    }
+};
+
+TEST_F(PointingDeviceHires, ResolutionFollowsTheHost) {
+    EXPECT_EQ(pointing_device_get_hires_scroll_resolution(), 1);
+
+    host_mouse_set_resolution_multiplier(1);
+    EXPECT_EQ(pointing_device_get_hires_scroll_resolution(), POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+
+    // e.g. after a USB reset
+    host_mouse_set_resolution_multiplier(0);
+    EXPECT_EQ(pointing_device_get_hires_scroll_resolution(), 1);
+}
+
+TEST_F(PointingDeviceHires, WheelIsWholeNotchesUntilTheHostEnablesTheMultiplier) {
+    mock_sensor_scroll(1, -1);
+    EXPECT_TRUE(task());
+    ASSERT_EQ(mock_report_count, 1);
+    EXPECT_EQ(mock_reports[0].v, 1);
+    EXPECT_EQ(mock_reports[0].h, -1);
+}
+
+TEST_F(PointingDeviceHires, WheelIsScaledOnceTheHostEnablesTheMultiplier) {
+    host_mouse_set_resolution_multiplier(1);
+    mock_sensor_scroll(1, -1);
+    EXPECT_TRUE(task());
+    ASSERT_EQ(mock_report_count, 1);
+    EXPECT_EQ(mock_reports[0].v, POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+    EXPECT_EQ(mock_reports[0].h, -POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+}
+
+TEST_F(PointingDeviceHires, NotchesBeyondTheReportAreCarried) {
+    host_mouse_set_resolution_multiplier(1);
+    mock_sensor_scroll(3, 0);
+    while (task()) {
+    }
+
+    EXPECT_EQ(mock_report_count, 3);
+    EXPECT_EQ(sent_v(), 3 * POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+}
+
+TEST_F(PointingDeviceHires, ScalesNotches) {
+    EXPECT_EQ(pointing_device_scale_notches(1), 1);
+
+    host_mouse_set_resolution_multiplier(1);
+    EXPECT_EQ(pointing_device_scale_notches(1), POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+    EXPECT_EQ(pointing_device_scale_notches(-1), -POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+    EXPECT_EQ(pointing_device_scale_notches(2), INT8_MAX);
+    EXPECT_EQ(pointing_device_scale_notches(0), 0);
+}
@@ -0,0 +1,103 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "host.h"
+#include "pointing_device.h"
+#include "pointing_device/tests/mock.h"
+
+void advance_time(uint32_t ms);
+}
+
+// The initiator forwards the other side's totals with pointing_device_set_shared_motion() after each good
+// transfer, and calls pointing_device_resync_shared_motion() after each failed one
+class PointingDeviceSplit : public testing::Test {
+   protected:
+    void SetUp() override {
+        host_set_driver(&mock_host_driver);
+        pointing_device_resync_shared_motion();
+        receive(0, 0);
+        while (task()) {
+        }
+        mock_report_count = 0;
+    }
+
+    void receive(uint32_t x, uint32_t y) {
+        pointing_device_set_shared_motion((pointing_device_motion_t){.x = x, .y = y});
+    }
+
+    bool task() {
+        advance_time(POINTING_DEVICE_TASK_THROTTLE_MS);
+        return pointing_device_task();
+    }
+
+    int32_t sent_x() {
+        int32_t x = 0;
+        for (uint8_t i = 0; i < mock_report_count; i++) {
+            x += mock_reports[i].x;
+        }
+        return x;
+    }
+};
+
+TEST_F(PointingDeviceSplit, SharedTotalsDrainOverSeveralReports) {
+    receive(1000, (uint32_t)-300);
+    while (task()) {
+        // Reading the same totals again between reports doesn't repeat any of them
+        receive(1000, (uint32_t)-300);
+    }
+
+    int32_t y = 0;
+    for (uint8_t i = 0; i < mock_report_count; i++) {
+        EXPECT_LE(abs(mock_reports[i].x), XY_REPORT_MAX) << "report " << (int)i;
+        y += mock_reports[i].y;
+    }
+    EXPECT_EQ(mock_report_count, 8);
+    EXPECT_EQ(sent_x(), 1000);
+    EXPECT_EQ(y, -300);
+}
+
+TEST_F(PointingDeviceSplit, MissedTransfersOnlyDelayMotion) {
+    receive(100, 0);
+    EXPECT_TRUE(task());
+
+    // Totals which moved on while a few good transfers went unread still add up
+    receive(300, 0);
+    receive(500, 0);
+    while (task()) {
+    }
+    EXPECT_EQ(sent_x(), 500);
+}
+
+TEST_F(PointingDeviceSplit, FailedTransferResyncsTotals) {
+    receive(1000, 0);
+    EXPECT_TRUE(task());
+    ASSERT_EQ(mock_reports[0].x, XY_REPORT_MAX);
+
+    // The other side reset while the link was down, so its totals start again from zero. Whatever was
+    // still pending is dropped rather than sent as a jump back.
+    pointing_device_resync_shared_motion();
+    receive(20, 0);
+    EXPECT_FALSE(task());
+    EXPECT_EQ(mock_report_count, 1);
+
+    receive(50, 0);
+    EXPECT_TRUE(task());
+    EXPECT_EQ(mock_report_count, 2);
+    EXPECT_EQ(mock_reports[1].x, 30);
+}
+
+TEST_F(PointingDeviceSplit, ResyncWaitsForTheNextGoodTransfer) {
+    receive(100, 0);
+    pointing_device_resync_shared_motion();
+    pointing_device_resync_shared_motion();
+
+    // Motion from before the link dropped is only discarded once new totals arrive
+    receive(150, 0);
+    receive(170, 0);
+    while (task()) {
+    }
+    EXPECT_EQ(sent_x(), 20);
+}
@@ -0,0 +1,30 @@
+pointing_device_DEFS := -DNO_PRINT -DMOUSE_ENABLE -DPOINTING_DEVICE_ENABLE
+pointing_device_INC := $(QUANTUM_PATH)/pointing_device
+
+pointing_device_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/pointing_device/tests/mock.c \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_tests.cpp \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(TMK_PATH)/protocol/host.c
+
+pointing_device_hires_DEFS := -DNO_PRINT -DMOUSE_ENABLE -DPOINTING_DEVICE_ENABLE -DPOINTING_DEVICE_HIRES_SCROLL_ENABLE
+pointing_device_hires_INC := $(QUANTUM_PATH)/pointing_device
+
+pointing_device_hires_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/pointing_device/tests/mock.c \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_tests_hires.cpp \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(TMK_PATH)/protocol/host.c
+
+pointing_device_split_DEFS := -DNO_PRINT -DMOUSE_ENABLE -DPOINTING_DEVICE_ENABLE -DSPLIT_KEYBOARD -DSPLIT_POINTING_ENABLE -DPOINTING_DEVICE_COMBINED
+pointing_device_split_INC := $(QUANTUM_PATH)/pointing_device $(QUANTUM_PATH)/split_common
+pointing_device_split_CONFIG := $(QUANTUM_PATH)/pointing_device/tests/config_mock_split.h
+
+pointing_device_split_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/pointing_device/tests/mock.c \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_tests_split.cpp \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(TMK_PATH)/protocol/host.c
@@ -0,0 +1,4 @@
+TEST_LIST += \
+	pointing_device \
+	pointing_device_hires \
+	pointing_device_split
@@ -0,0 +1,166 @@
+#ifdef ENABLE_RGB_MATRIX_HOST_STREAM
+RGB_MATRIX_EFFECT(HOST_STREAM)
+#    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+#        include "raw_hid.h"
+
+/*
+ * Frames are streamed by the host as raw HID reports:
+ *
+ *   [0] RGB_MATRIX_HOST_STREAM_COMMAND_ID
+ *   [1] operation
+ *   [2] frame sequence number
+ *   [3...] operation payload
+ *
+ * DATA packets carry records of { start LED, header, payload }. The header's low 7 bits are an LED count; with
+ * bit 7 set the record is a run and the payload is a single R, G, B triplet, otherwise it holds count triplets.
+ * A zero header ends the packet. The first DATA packet of a new sequence number opens a frame seeded from the one
+ * currently displayed, so a delta frame only needs to carry the LEDs that changed.
+ *
+ * COMMIT swaps the frame into the effect and is acknowledged with { status, last rendered sequence }, STATUS is
+ * answered with { LED count, last rendered sequence, dropped frames (LE16) }. DATA packets are not acknowledged.
+ * The host applies backpressure by keeping its sequence number within a frame or two of the rendered one.
+ */
+#        define HOST_STREAM_OP_DATA 0x01
+#        define HOST_STREAM_OP_COMMIT 0x02
+#        define HOST_STREAM_OP_STATUS 0x03
+
+#        define HOST_STREAM_RECORD_RUN 0x80
+
+#        define HOST_STREAM_COMMIT_OK 0x00
+#        define HOST_STREAM_COMMIT_REPLACED 0x01
+#        define HOST_STREAM_COMMIT_STALE 0x02
+
+/*
+ * The effect renders the front frame and the host fills the back one. A committed frame only becomes the front one
+ * when a render pass starts, so every slice of a pass renders the same frame and what is flushed never mixes two.
+ */
+static struct {
+    RGB      buffers[2][RGB_MATRIX_LED_COUNT];
+    uint8_t  front;
+    bool     back_open;
+    bool     back_committed;
+    bool     back_replaced;
+    uint8_t  back_seq;
+    uint8_t  render_seq;
+    uint8_t  rendered_seq;
+    uint16_t dropped;
+} host_stream;
+
+static void host_stream_records(const uint8_t *data, uint8_t length, RGB *frame) {
+    uint8_t i = 3;
+    while (i + 2 <= length) {
+        uint8_t start = data[i];
+        uint8_t count = data[i + 1] & ~HOST_STREAM_RECORD_RUN;
+        bool    run   = data[i + 1] & HOST_STREAM_RECORD_RUN;
+        i += 2;
+
+        if (count == 0) {
+            return;
+        }
+        if (start >= RGB_MATRIX_LED_COUNT) {
+            return;
+        }
+        if (count > RGB_MATRIX_LED_COUNT - start) {
+            count = RGB_MATRIX_LED_COUNT - start;
+        }
+
+        if (run) {
+            if (i + 3 > length) {
+                return;
+            }
+            RGB rgb = {.r = data[i], .g = data[i + 1], .b = data[i + 2]};
+            for (uint8_t j = 0; j < count; j++) {
+                frame[start + j] = rgb;
+            }
+            i += 3;
+        } else {
+            for (uint8_t j = 0; j < count && i + 3 <= length; j++, i += 3) {
+                frame[start + j] = (RGB){.r = data[i], .g = data[i + 1], .b = data[i + 2]};
+            }
+        }
+    }
+}
+
+static uint8_t host_stream_commit(uint8_t seq) {
+    if (!host_stream.back_open || host_stream.back_seq != seq) {
+        return HOST_STREAM_COMMIT_STALE;
+    }
+
+    uint8_t status             = host_stream.back_replaced ? HOST_STREAM_COMMIT_REPLACED : HOST_STREAM_COMMIT_OK;
+    host_stream.back_open      = false;
+    host_stream.back_committed = true;
+    host_stream.back_replaced  = false;
+    return status;
+}
+
+bool rgb_matrix_host_stream_receive(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != RGB_MATRIX_HOST_STREAM_COMMAND_ID) {
+        return false;
+    }
+
+    uint8_t seq = data[2];
+    switch (data[1]) {
+        case HOST_STREAM_OP_DATA: {
+            RGB *back = host_stream.buffers[host_stream.front ^ 1];
+            if (!host_stream.back_open || host_stream.back_seq != seq) {
+                if (host_stream.back_committed) {
+                    // the committed frame never made it to the LEDs, the new one builds on it in place
+                    host_stream.back_committed = false;
+                    host_stream.back_replaced  = true;
+                    host_stream.dropped++;
+                } else {
+                    memcpy(back, host_stream.buffers[host_stream.front], sizeof(host_stream.buffers[0]));
+                }
+                host_stream.back_open = true;
+                host_stream.back_seq  = seq;
+            }
+            host_stream_records(data, length, back);
+            // no reply, keeps the OUT endpoint free for frame data
+            return true;
+        }
+        case HOST_STREAM_OP_COMMIT:
+            data[3] = host_stream_commit(seq);
+            data[4] = host_stream.rendered_seq;
+            break;
+        case HOST_STREAM_OP_STATUS:
+            data[3] = RGB_MATRIX_LED_COUNT;
+            data[4] = host_stream.rendered_seq;
+            data[5] = host_stream.dropped & 0xFF;
+            data[6] = host_stream.dropped >> 8;
+            data[7] = rgb_matrix_get_mode() == RGB_MATRIX_HOST_STREAM;
+            break;
+        default:
+            data[1] = 0xFF;
+            break;
+    }
+
+    raw_hid_send(data, length);
+    return true;
+}
+
+bool HOST_STREAM(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    if ((params->init || params->iter == 0) && host_stream.back_committed) {
+        host_stream.front ^= 1;
+        host_stream.back_committed = false;
+        host_stream.render_seq     = host_stream.back_seq;
+    }
+
+    const RGB* frame = host_stream.buffers[host_stream.front];
+    uint8_t    val   = rgb_matrix_config.hsv.v;
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_set_color(i, scale8(frame[i].r, val), scale8(frame[i].g, val), scale8(frame[i].b, val));
+    }
+
+    if (!rgb_matrix_check_finished_leds(led_max)) {
+        host_stream.rendered_seq = host_stream.render_seq;
+        return false;
+    }
+    return true;
+}
+
+#    endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#endif     // ENABLE_RGB_MATRIX_HOST_STREAM
@@ -22,6 +22,7 @@
 #include "eeconfig.h"
 #include "keyboard.h"
 #include "sync_timer.h"
+#include "timer.h"
 #include "debug.h"
 #include <string.h>
 #include <math.h>
@@ -36,7 +37,12 @@ const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
+#ifdef RGB_MATRIX_OUTPUT_LUT
+    // the output lookup table already applies the gamma curve
+    return hsv_to_rgb_nocie(hsv);
+#else
     return hsv_to_rgb(hsv);
+#endif
 }
 
 // Generic effect runners
@@ -119,6 +125,9 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+uint8_t g_last_hit_distance[LED_HITS_TO_REMEMBER][RGB_MATRIX_LED_COUNT];
+#endif // RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
 
 // internals
 static bool            suspend_state     = false;
@@ -129,11 +138,31 @@ static rgb_task_states rgb_task_state    = SYNCING;
 #if RGB_MATRIX_TIMEOUT > 0
 static uint32_t rgb_anykey_timer;
 #endif // RGB_MATRIX_TIMEOUT > 0
+#ifdef RGB_MATRIX_OUTPUT_LUT
+static uint8_t rgb_output_dimming = UINT8_MAX;
+#endif // RGB_MATRIX_OUTPUT_LUT
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+uint8_t         g_rgb_led_slice_min;
+uint8_t         g_rgb_led_slice_max;
+static uint32_t rgb_slice_timer;
+static uint16_t rgb_render_cost[RGB_MATRIX_EFFECT_MAX]; // per-LED render time of each effect, in 1/16 us
+static uint16_t rgb_render_cost_reported;
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
 
 // double buffers
 static uint32_t rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-static last_hit_t last_hit_buffer;
+// Ring buffer of hits, oldest first starting at head. Hit times are stored instead of ages so that
+// nothing needs updating every task run; ages are computed when the tracker is copied for rendering.
+static struct {
+    uint8_t  head;
+    uint8_t  count;
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+    uint8_t  uncached; // newest hits whose distances haven't been computed yet
+#    endif
+    uint8_t  index[LED_HITS_TO_REMEMBER];
+    uint32_t time[LED_HITS_TO_REMEMBER];
+} last_hit_buffer;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 // split rgb matrix
@@ -196,19 +225,81 @@ void rgb_matrix_update_pwm_buffers(void) {
     rgb_matrix_driver.flush();
 }
 
+#ifdef RGB_MATRIX_OUTPUT_LUT
+static inline uint8_t rgb_matrix_output(uint8_t channel, uint8_t value) {
+    return scale8(pgm_read_byte(&g_rgb_matrix_output_lut[channel][value]), rgb_output_dimming);
+}
+
+void rgb_matrix_set_output_dimming(uint8_t level) {
+    rgb_output_dimming = level;
+}
+
+uint8_t rgb_matrix_get_output_dimming(void) {
+    return rgb_output_dimming;
+}
+#endif // RGB_MATRIX_OUTPUT_LUT
+
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_OUTPUT_LUT
+    red   = rgb_matrix_output(0, red);
+    green = rgb_matrix_output(1, green);
+    blue  = rgb_matrix_output(2, blue);
+#endif // RGB_MATRIX_OUTPUT_LUT
     rgb_matrix_driver.set_color(index, red, green, blue);
 }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_OUTPUT_LUT
+    red   = rgb_matrix_output(0, red);
+    green = rgb_matrix_output(1, green);
+    blue  = rgb_matrix_output(2, blue);
+#endif // RGB_MATRIX_OUTPUT_LUT
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
     for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++)
-        rgb_matrix_set_color(i, red, green, blue);
+        rgb_matrix_driver.set_color(i, red, green, blue);
 #else
     rgb_matrix_driver.set_color_all(red, green, blue);
 #endif
 }
 
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+static inline uint8_t last_hit_slot(uint8_t offset) {
+    uint8_t slot = last_hit_buffer.head + offset;
+    return slot >= LED_HITS_TO_REMEMBER ? slot - LED_HITS_TO_REMEMBER : slot;
+}
+
+static void last_hit_push(uint8_t led_index) {
+    uint8_t slot;
+    if (last_hit_buffer.count < LED_HITS_TO_REMEMBER) {
+        slot = last_hit_slot(last_hit_buffer.count);
+        last_hit_buffer.count++;
+    } else {
+        // full, overwrite the oldest hit
+        slot                 = last_hit_buffer.head;
+        last_hit_buffer.head = last_hit_slot(1);
+    }
+    last_hit_buffer.index[slot] = led_index;
+    last_hit_buffer.time[slot]  = sync_timer_read32();
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+    // computed at the next frame start, so the frame being rendered keeps the row of the hit it copied
+    if (last_hit_buffer.uncached < LED_HITS_TO_REMEMBER) {
+        last_hit_buffer.uncached++;
+    }
+#    endif
+}
+
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+static void last_hit_cache_distances(uint8_t slot) {
+    led_point_t hit = g_led_config.point[last_hit_buffer.index[slot]];
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx                   = g_led_config.point[i].x - hit.x;
+        int16_t dy                   = g_led_config.point[i].y - hit.y;
+        g_last_hit_distance[slot][i] = sqrt16(dx * dx + dy * dy);
+    }
+}
+#    endif
+#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+
 void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #ifndef RGB_MATRIX_SPLIT
     if (!is_keyboard_master()) return;
@@ -230,21 +321,8 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
         led_count = rgb_matrix_map_row_column_to_led(row, col, led);
     }
 
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2); // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
-    }
-
     for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
+        last_hit_push(led[i]);
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
@@ -296,9 +374,9 @@ static bool rgb_matrix_none(effect_params_t *params) {
 }
 
 static void rgb_task_timers(void) {
-#if defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_MATRIX_TIMEOUT > 0
+#if RGB_MATRIX_TIMEOUT > 0
     uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
-#endif // defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_MATRIX_TIMEOUT > 0
+#endif // RGB_MATRIX_TIMEOUT > 0
     rgb_timer_buffer = sync_timer_read32();
 
     // Update double buffer timers
@@ -308,15 +386,16 @@ static void rgb_task_timers(void) {
     }
 #endif // RGB_MATRIX_TIMEOUT > 0
 
-    // Update double buffer last hit timers
+    // Expire finished hits, which are always the oldest ones
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
+    uint8_t speed = qadd8(rgb_matrix_config.speed, 1);
+    while (last_hit_buffer.count > 0) {
+        uint32_t age = rgb_timer_buffer - last_hit_buffer.time[last_hit_buffer.head];
+        if (age < UINT16_MAX && scale16by8(age, speed) <= RGB_MATRIX_KEYREACTIVE_MAX_OFFSET) {
+            break;
         }
-        last_hit_buffer.tick[i] += deltaTime;
+        last_hit_buffer.head = last_hit_slot(1);
+        last_hit_buffer.count--;
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 }
@@ -327,14 +406,101 @@ static void rgb_task_sync(void) {
     if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
 }
 
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+// first and one-past-last LED rendered by this half
+static inline uint8_t rgb_task_render_start(void) {
+#    if defined(RGB_MATRIX_SPLIT)
+    return is_keyboard_left() ? 0 : k_rgb_matrix_split[0];
+#    else
+    return 0;
+#    endif
+}
+
+static inline uint8_t rgb_task_render_end(void) {
+#    if defined(RGB_MATRIX_SPLIT)
+    return is_keyboard_left() ? k_rgb_matrix_split[0] : RGB_MATRIX_LED_COUNT;
+#    else
+    return RGB_MATRIX_LED_COUNT;
+#    endif
+}
+
+static void rgb_task_slice_begin(uint8_t effect) {
+    // pick up where the previous pass stopped and take as many LEDs as the measured cost allows
+    g_rgb_led_slice_min = g_rgb_led_slice_max;
+    uint8_t remaining   = rgb_task_render_end() - g_rgb_led_slice_min;
+    uint8_t count       = remaining;
+    if (effect < RGB_MATRIX_EFFECT_MAX && rgb_render_cost[effect] > 0) {
+        uint32_t fit = ((uint32_t)RGB_MATRIX_LED_PROCESS_BUDGET_US * 16) / rgb_render_cost[effect];
+        if (fit < 1) fit = 1;
+        if (fit < remaining) count = fit;
+    }
+    g_rgb_led_slice_max = g_rgb_led_slice_min + count;
+
+    rgb_slice_timer = timer_read_us();
+}
+
+static void rgb_task_slice_end(uint8_t effect) {
+    uint8_t count = g_rgb_led_slice_max - g_rgb_led_slice_min;
+    // init passes do one-off setup work and would skew the estimate
+    if (effect >= RGB_MATRIX_EFFECT_MAX || count == 0 || rgb_effect_params.init) {
+        return;
+    }
+
+    uint32_t cost = (timer_elapsed_us(rgb_slice_timer) * 16) / count;
+    if (cost > UINT16_MAX) cost = UINT16_MAX;
+
+    uint16_t *average = &rgb_render_cost[effect];
+    *average          = *average ? (uint16_t)(((uint32_t)*average * 3 + cost) / 4) : (uint16_t)cost;
+}
+
+static void rgb_task_report_cost(uint8_t effect) {
+    if (effect >= RGB_MATRIX_EFFECT_MAX) {
+        return;
+    }
+
+    // only report when switching effects or when the estimate moved by more than 1/8
+    uint16_t cost  = rgb_render_cost[effect];
+    uint16_t delta = cost > rgb_render_cost_reported ? cost - rgb_render_cost_reported : rgb_render_cost_reported - cost;
+    if (effect != rgb_last_effect || delta > rgb_render_cost_reported / 8) {
+        dprintf("rgb matrix: effect %u renders in %u.%02u us/led\n", effect, cost / 16, ((cost % 16) * 100) / 16);
+        rgb_render_cost_reported = cost;
+    }
+}
+
+uint16_t rgb_matrix_get_render_cost(uint8_t mode) {
+    return mode < RGB_MATRIX_EFFECT_MAX ? rgb_render_cost[mode] : 0;
+}
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
+
 static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+    g_rgb_led_slice_max = rgb_task_render_start();
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
 
     // update double buffers
     g_rgb_timer = rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker = last_hit_buffer;
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+    // new hits are always the newest ones, some may already have expired
+    for (uint8_t i = qsub8(last_hit_buffer.count, last_hit_buffer.uncached); i < last_hit_buffer.count; i++) {
+        last_hit_cache_distances(last_hit_slot(i));
+    }
+    last_hit_buffer.uncached = 0;
+#    endif
+    g_last_hit_tracker.count = last_hit_buffer.count;
+    for (uint8_t i = 0; i < last_hit_buffer.count; i++) {
+        uint8_t slot                = last_hit_slot(i);
+        uint8_t index               = last_hit_buffer.index[slot];
+        g_last_hit_tracker.x[i]     = g_led_config.point[index].x;
+        g_last_hit_tracker.y[i]     = g_led_config.point[index].y;
+        g_last_hit_tracker.index[i] = index;
+        g_last_hit_tracker.tick[i]  = g_rgb_timer - last_hit_buffer.time[slot];
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+        g_last_hit_tracker.slot[i] = slot;
+#    endif
+    }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
     // next task
@@ -349,6 +515,10 @@ static void rgb_task_render(uint8_t effect) {
         rgb_matrix_set_color_all(0, 0, 0);
     }
 
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+    rgb_task_slice_begin(effect);
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
+
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
@@ -389,6 +559,10 @@ static void rgb_task_render(uint8_t effect) {
             return;
     }
 
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+    rgb_task_slice_end(effect);
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
+
     rgb_effect_params.iter++;
 
     // next task
@@ -402,6 +576,10 @@ static void rgb_task_render(uint8_t effect) {
 }
 
 static void rgb_task_flush(uint8_t effect) {
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+    rgb_task_report_cost(effect);
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
+
     // update last trackers after the first full render so we can init over several frames
     rgb_last_effect = effect;
     rgb_last_enable = rgb_matrix_config.enable;
@@ -434,7 +612,11 @@ void rgb_matrix_task(void) {
             rgb_task_render(effect);
             if (effect) {
                 // Only run the basic indicators in the last render iteration (default there are 5 iterations)
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+                if (rgb_task_state == FLUSHING) {
+#else
                 if (rgb_effect_params.iter == RGB_MATRIX_LED_PROCESS_MAX_ITERATIONS) {
+#endif // RGB_MATRIX_LED_PROCESS_BUDGET_US
                     rgb_matrix_indicators();
                 }
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
@@ -488,10 +670,11 @@ void rgb_matrix_init(void) {
         g_last_hit_tracker.tick[i] = UINT16_MAX;
     }
 
+    last_hit_buffer.head  = 0;
     last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+    last_hit_buffer.uncached = 0;
+#    endif
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
     if (!eeconfig_is_enabled()) {
@@ -53,7 +53,14 @@
 #endif
 #define RGB_MATRIX_LED_PROCESS_MAX_ITERATIONS ((RGB_MATRIX_LED_COUNT + RGB_MATRIX_LED_PROCESS_LIMIT - 1) / RGB_MATRIX_LED_PROCESS_LIMIT)
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+#if defined(RGB_MATRIX_LED_PROCESS_BUDGET_US)
+// Slice bounds are sized at runtime by rgb_matrix.c to fit the per-task time budget, split halves already applied
+extern uint8_t g_rgb_led_slice_min;
+extern uint8_t g_rgb_led_slice_max;
+#    define RGB_MATRIX_USE_LIMITS_ITER(min, max, iter) \
+        uint8_t min = g_rgb_led_slice_min;             \
+        uint8_t max = g_rgb_led_slice_max;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
 #    if defined(RGB_MATRIX_SPLIT)
 #        define RGB_MATRIX_USE_LIMITS_ITER(min, max, iter)                                        \
             uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);                                  \
@@ -189,6 +196,19 @@ void        rgb_matrix_decrease_speed_noeeprom(void);
 led_flags_t rgb_matrix_get_flags(void);
 void        rgb_matrix_set_flags(led_flags_t flags);
 void        rgb_matrix_set_flags_noeeprom(led_flags_t flags);
+#ifdef RGB_MATRIX_LED_PROCESS_BUDGET_US
+uint16_t rgb_matrix_get_render_cost(uint8_t mode);
+#endif
+#ifdef RGB_MATRIX_OUTPUT_LUT
+void    rgb_matrix_set_output_dimming(uint8_t level);
+uint8_t rgb_matrix_get_output_dimming(void);
+#endif
+#ifdef ENABLE_RGB_MATRIX_HOST_STREAM
+#    ifndef RGB_MATRIX_HOST_STREAM_COMMAND_ID
+#        define RGB_MATRIX_HOST_STREAM_COMMAND_ID 0x80
+#    endif
+bool rgb_matrix_host_stream_receive(uint8_t *data, uint8_t length);
+#endif
 
 #ifndef RGBLIGHT_ENABLE
 #    define eeconfig_update_rgblight_current eeconfig_update_rgb_matrix
@@ -259,6 +279,11 @@ static inline bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
 
 extern const rgb_matrix_driver_t rgb_matrix_driver;
 
+#ifdef RGB_MATRIX_OUTPUT_LUT
+// Per-channel output curve applied on the way into the driver, generated from info.json rgb_matrix.output
+extern const uint8_t g_rgb_matrix_output_lut[3][256];
+#endif
+
 extern rgb_config_t rgb_matrix_config;
 
 extern uint32_t     g_rgb_timer;
@@ -266,6 +291,9 @@ extern led_config_t g_led_config;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
+#ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+extern uint8_t g_last_hit_distance[LED_HITS_TO_REMEMBER][RGB_MATRIX_LED_COUNT];
+#endif
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#ifdef __cplusplus
+#    define _Static_assert static_assert
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
 #include "color.h"
@@ -34,11 +38,22 @@
 #    define RGB_MATRIX_KEYREACTIVE_ENABLED
 #endif
 
+#ifndef RGB_MATRIX_KEYREACTIVE_MAX_OFFSET
+// speed-scaled age after which no built-in reactive effect lights up a hit anymore (255 fade + 255 distance)
+#    define RGB_MATRIX_KEYREACTIVE_MAX_OFFSET 510
+#endif
+
 // Last led hit
 #ifndef LED_HITS_TO_REMEMBER
-#    define LED_HITS_TO_REMEMBER 8
+// A hit lasts MAX_OFFSET * 256 / (speed + 1) ms, about a second at the default speed. Keep enough of them for 10 keys/s.
+#    define LED_HITS_TO_REMEMBER ((RGB_MATRIX_KEYREACTIVE_MAX_OFFSET * 256UL / (UINT8_MAX / 2 + 1) * 10 + 999) / 1000)
 #endif // LED_HITS_TO_REMEMBER
 
+#if defined(RGB_MATRIX_KEYREACTIVE_ENABLED) && !defined(__AVR__) && !defined(RGB_MATRIX_KEYREACTIVE_NO_DISTANCE_CACHE)
+// Each hit's distance to every LED is computed once rather than every frame, at LED_HITS_TO_REMEMBER bytes of RAM per LED
+#    define RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+#endif
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 typedef struct PACKED {
     uint8_t  count;
@@ -46,6 +61,9 @@ typedef struct PACKED {
     uint8_t  y[LED_HITS_TO_REMEMBER];
     uint8_t  index[LED_HITS_TO_REMEMBER];
     uint16_t tick[LED_HITS_TO_REMEMBER];
+#    ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+    uint8_t  slot[LED_HITS_TO_REMEMBER]; // row of g_last_hit_distance
+#    endif
 } last_hit_t;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
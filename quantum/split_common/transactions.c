@@ -686,12 +686,17 @@ static bool pointing_handlers_master(matrix_row_t master_matrix[], matrix_row_t
         return true;
     }
 #    endif
-    static uint32_t last_update = 0;
-    static uint16_t last_cpi    = 0;
-    report_mouse_t  temp_state;
-    uint16_t        temp_cpi;
-    bool            okay = read_if_checksum_mismatch(GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.report, sizeof(temp_state));
-    if (okay) pointing_device_set_shared_report(temp_state);
+    static uint32_t       last_update = 0;
+    static uint16_t       last_cpi    = 0;
+    split_pointing_data_t temp_state;
+    uint16_t              temp_cpi;
+    bool                  okay = read_if_checksum_mismatch(GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.data, sizeof(temp_state));
+    if (okay) {
+        pointing_device_set_shared_report(temp_state.report);
+        pointing_device_set_shared_motion(temp_state.motion);
+    } else {
+        pointing_device_resync_shared_motion();
+    }
     temp_cpi = pointing_device_get_shared_cpi();
     if (temp_cpi && last_cpi != temp_cpi) {
         split_shmem->pointing.cpi = temp_cpi;
@@ -734,9 +739,15 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
         pointing_device_driver.set_cpi(pointing.cpi);
     }
 
-    pointing.report = pointing_device_driver.get_report((report_mouse_t){0});
+    // Motion is carried in the totals, so a report the initiator hasn't read yet only holds the buttons
+    report_mouse_t report = {.buttons = pointing.data.report.buttons};
+    if (pointing_device_report_ready()) {
+        report = pointing_device_driver.get_report(report);
+    }
+    pointing.data.report = report;
+    pointing.data.motion = pointing_device_get_motion();
     // Now update the checksum given that the pointing has been written to
-    pointing.checksum = crc8(&pointing.report, sizeof(report_mouse_t));
+    pointing.checksum = crc8(&pointing.data, sizeof(split_pointing_data_t));
 
     split_shared_memory_lock();
     memcpy(&split_shmem->pointing, &pointing, sizeof(split_slave_pointing_sync_t));
@@ -745,7 +756,7 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
 
 #    define TRANSACTIONS_POINTING_MASTER() TRANSACTION_HANDLER_MASTER(pointing)
 #    define TRANSACTIONS_POINTING_SLAVE() TRANSACTION_HANDLER_SLAVE(pointing)
-#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
+#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.data), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
 
 #else // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
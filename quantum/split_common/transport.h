@@ -107,10 +107,15 @@ typedef struct _split_mods_sync_t {
 
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 #    include "pointing_device.h"
+typedef struct _split_pointing_data_t {
+    report_mouse_t           report;
+    pointing_device_motion_t motion;
+} split_pointing_data_t;
+
 typedef struct _split_slave_pointing_sync_t {
-    uint8_t        checksum;
-    report_mouse_t report;
-    uint16_t       cpi;
+    uint8_t               checksum;
+    split_pointing_data_t data;
+    uint16_t              cpi;
 } split_slave_pointing_sync_t;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
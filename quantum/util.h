@@ -36,6 +36,11 @@
 #    define IS_ARRAY(value) (!__builtin_types_compatible_p(typeof((value)), typeof(&(value)[0])))
 #endif
 
+#if !defined(ARRAY_SIZE) && defined(__cplusplus)
+// The builtins below are C only, so C++ (the unit tests) takes the plain form
+#    define ARRAY_SIZE(array) (sizeof((array)) / sizeof((array)[0]))
+#endif
+
 #if !defined(ARRAY_SIZE)
 /**
  * @brief Computes the number of elements of the given array at compile time.
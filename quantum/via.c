@@ -286,6 +286,13 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
         return;
     }
 
+#if defined(RGB_MATRIX_ENABLE) && defined(ENABLE_RGB_MATRIX_HOST_STREAM)
+    // Host driven lighting frames, see RGB_MATRIX_HOST_STREAM
+    if (rgb_matrix_host_stream_receive(data, length)) {
+        return;
+    }
+#endif
+
     switch (*command_id) {
         case id_get_protocol_version: {
             command_data[0] = VIA_PROTOCOL_VERSION >> 8;
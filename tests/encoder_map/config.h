@@ -0,0 +1,27 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define ENCODERS_PAD_A \
+    { 0, 2 }
+#define ENCODERS_PAD_B \
+    { 1, 3 }
+
+#define ENCODER_INTERRUPT_ENABLE
+#define ENCODER_MAP_BATCH_ENABLE
+#define IGNORE_ATOMIC_BLOCK
+
+#define MOUSEKEY_WHEEL_DELTA 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "encoder/tests/mock.h"
+
+#ifdef __cplusplus
+};
+#endif
@@ -0,0 +1,12 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+ENCODER_ENABLE = yes
+ENCODER_MAP_ENABLE = yes
+MOUSEKEY_ENABLE = yes
+EXTRAKEY_ENABLE = yes
+
+INTROSPECTION_KEYMAP_C = encoder_map.c
+
+# Encoder pins are simulated
+SRC += $(QUANTUM_PATH)/encoder/tests/mock.c
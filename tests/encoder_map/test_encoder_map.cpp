@@ -0,0 +1,175 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <functional>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+MATCHER_P(MouseWheel, v, "") {
+    return arg.buttons == 0 && arg.x == 0 && arg.y == 0 && arg.v == v && arg.h == 0;
+}
+
+MATCHER_P(ExtraUsage, usage, "") {
+    return arg.usage == usage;
+}
+
+namespace {
+
+bool process_record_user_default(uint16_t keycode, keyrecord_t* record) {
+    return true;
+}
+
+std::function<bool(uint16_t, keyrecord_t*)> process_record_user_fun = process_record_user_default;
+
+} // namespace
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+    return process_record_user_fun(keycode, record);
+}
+
+class EncoderMap : public TestFixture {
+   protected:
+    void SetUp() override {
+        process_record_user_fun = process_record_user_default;
+    }
+
+    // An edge on either pin raises the encoder's interrupt
+    void set_and_interrupt(uint8_t index, pin_t pin, bool val) {
+        setPin(pin, val);
+        encoder_handle_interrupt(index);
+    }
+
+    // Detents turned between two scans, which are handled together
+    void turn(uint8_t index, bool clockwise, int detents) {
+        pin_t first  = clockwise ? index * 2 : index * 2 + 1;
+        pin_t second = clockwise ? index * 2 + 1 : index * 2;
+        for (int i = 0; i < detents; i++) {
+            set_and_interrupt(index, first, false);
+            set_and_interrupt(index, second, false);
+            set_and_interrupt(index, first, true);
+            set_and_interrupt(index, second, true);
+        }
+    }
+};
+
+TEST_F(EncoderMap, WheelDetentsGoOutTogether) {
+    TestDriver driver;
+    int        user_calls      = 0;
+    process_record_user_fun = [&](uint16_t keycode, keyrecord_t* record) {
+        user_calls++;
+        return true;
+    };
+
+    {
+        InSequence seq;
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(3 * MOUSEKEY_WHEEL_DELTA)));
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(0)));
+    }
+    turn(0, true, 3);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(user_calls, 0);
+
+    {
+        InSequence seq;
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(-2 * MOUSEKEY_WHEEL_DELTA)));
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(0)));
+    }
+    turn(0, false, 2);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(EncoderMap, WheelDetentMovesLikeMouseKey) {
+    TestDriver driver;
+    KeymapKey  wheel_up = KeymapKey(0, 0, 0, KC_MS_WH_UP);
+    set_keymap({wheel_up});
+
+    {
+        InSequence seq;
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(MOUSEKEY_WHEEL_DELTA)));
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(0)));
+    }
+    tap_key(wheel_up);
+    VERIFY_AND_CLEAR(driver);
+
+    {
+        InSequence seq;
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(MOUSEKEY_WHEEL_DELTA)));
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(0)));
+    }
+    turn(0, true, 1);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(EncoderMap, LongRunSplitsAcrossReports) {
+    TestDriver driver;
+
+    {
+        InSequence seq;
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(127)));
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(70 * MOUSEKEY_WHEEL_DELTA - 127)));
+        EXPECT_CALL(driver, send_mouse_mock(MouseWheel(0)));
+    }
+    turn(0, true, 70);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(EncoderMap, ConsumerDetentsReachProcessRecordUser) {
+    TestDriver driver;
+    int        user_presses    = 0;
+    process_record_user_fun = [&](uint16_t keycode, keyrecord_t* record) {
+        EXPECT_KEYCODE_EQ(keycode, KC_VOLU);
+        if (record->event.pressed) {
+            user_presses++;
+        }
+        return true;
+    };
+
+    {
+        InSequence seq;
+        EXPECT_CALL(driver, send_extra_mock(ExtraUsage(AUDIO_VOL_UP)));
+        EXPECT_CALL(driver, send_extra_mock(ExtraUsage(0)));
+        EXPECT_CALL(driver, send_extra_mock(ExtraUsage(AUDIO_VOL_UP)));
+        EXPECT_CALL(driver, send_extra_mock(ExtraUsage(0)));
+    }
+    turn(1, true, 2);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(user_presses, 2);
+}
+
+TEST_F(EncoderMap, KeymapOverridesConsumerKeycode) {
+    TestDriver driver;
+    process_record_user_fun = [&](uint16_t keycode, keyrecord_t* record) {
+        if (keycode == KC_VOLD) {
+            if (record->event.pressed) {
+                tap_code(KC_A);
+            }
+            return false;
+        }
+        return true;
+    };
+
+    EXPECT_CALL(driver, send_extra_mock(_)).Times(0);
+    {
+        InSequence seq;
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_EMPTY_REPORT(driver);
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+    turn(1, false, 2);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,74 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+
+void advance_time(uint32_t ms);
+}
+
+#define NO_LED_ROW \
+    { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED }
+
+extern "C" led_config_t g_led_config = {
+    {NO_LED_ROW, NO_LED_ROW, NO_LED_ROW, NO_LED_ROW},
+    {{0, 0}, {32, 0}, {64, 0}, {96, 0}, {128, 0}, {160, 0}, {192, 0}, {224, 0}},
+    {4, 4, 4, 4, 4, 4, 4, 4},
+};
+
+// LEDs set during the current scan
+static std::vector<int> rendered;
+
+// Each LED takes a millisecond to render, so the measured cost is known
+static void test_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    rendered.push_back(index);
+    advance_time(1);
+}
+
+static void test_init(void) {}
+static void test_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {}
+static void test_flush(void) {}
+
+extern "C" const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = test_init,
+    .set_color     = test_set_color,
+    .set_color_all = test_set_color_all,
+    .flush         = test_flush,
+};
+
+class RgbMatrixBudget : public TestFixture {
+   protected:
+    // Runs the task until it has rendered the given number of frames, returning the LEDs each pass rendered
+    std::vector<std::vector<int>> render_frames(int frames) {
+        std::vector<std::vector<int>> passes;
+        int                           leds = 0;
+        while (leds < frames * RGB_MATRIX_LED_COUNT) {
+            rendered.clear();
+            run_one_scan_loop();
+            if (!rendered.empty()) {
+                passes.push_back(rendered);
+                leds += rendered.size();
+            }
+        }
+        return passes;
+    }
+};
+
+TEST_F(RgbMatrixBudget, SlicesFollowMeasuredCost) {
+    TestDriver driver;
+
+    // With no estimate yet each pass renders everything left, the first frame only sets the effect up
+    std::vector<std::vector<int>> passes = render_frames(2);
+    std::vector<int>              all    = {0, 1, 2, 3, 4, 5, 6, 7};
+    EXPECT_EQ(passes, std::vector<std::vector<int>>({all, all}));
+    EXPECT_EQ(rgb_matrix_get_render_cost(RGB_MATRIX_SOLID_COLOR), 1000 * 16);
+
+    // Then each pass takes what fits in the budget, continuing where the previous one stopped
+    passes = render_frames(2);
+    EXPECT_EQ(passes, std::vector<std::vector<int>>({{0, 1, 2}, {3, 4, 5}, {6, 7}, {0, 1, 2}, {3, 4, 5}, {6, 7}}));
+}
@@ -0,0 +1,111 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+#define NO_LED_ROW \
+    { NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED }
+
+// The first eight keys of the top row light LEDs spread along the x axis
+extern "C" led_config_t g_led_config = {
+    {{0, 1, 2, 3, 4, 5, 6, 7, NO_LED, NO_LED}, NO_LED_ROW, NO_LED_ROW, NO_LED_ROW},
+    {{0, 0}, {32, 0}, {64, 0}, {96, 0}, {128, 0}, {160, 0}, {192, 0}, {224, 0}},
+    {4, 4, 4, 4, 4, 4, 4, 4},
+};
+
+static void test_init(void) {}
+static void test_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {}
+static void test_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {}
+static void test_flush(void) {}
+
+extern "C" const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = test_init,
+    .set_color     = test_set_color,
+    .set_color_all = test_set_color_all,
+    .flush         = test_flush,
+};
+
+class RgbMatrixReactive : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t col = 0; col < RGB_MATRIX_LED_COUNT; col++) {
+            keys.push_back(KeymapKey(0, col, 0, KC_A + col));
+            add_key(keys.back());
+        }
+    }
+
+    // Runs the task past the next frame start, which is when the renderer picks up the hits
+    void next_frame(void) {
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT + 1);
+    }
+
+    std::vector<uint8_t> tracked_leds(void) {
+        return std::vector<uint8_t>(g_last_hit_tracker.index, g_last_hit_tracker.index + g_last_hit_tracker.count);
+    }
+};
+
+TEST_F(RgbMatrixReactive, OldestHitIsEvictedWhenFull) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    std::vector<uint8_t> expected;
+    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER + 2; i++) {
+        tap_key(keys[i % RGB_MATRIX_LED_COUNT]);
+        expected.push_back(i % RGB_MATRIX_LED_COUNT);
+    }
+    next_frame();
+
+    expected.erase(expected.begin(), expected.begin() + 2);
+    EXPECT_EQ(tracked_leds(), expected);
+}
+
+TEST_F(RgbMatrixReactive, HitsExpireAfterMaxOffset) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    tap_key(keys[0]);
+    idle_for(500);
+    tap_key(keys[1]);
+    next_frame();
+    EXPECT_EQ(tracked_leds(), std::vector<uint8_t>({0, 1}));
+
+    // at the default speed a hit's age is halved, so it is forgotten once older than twice the offset
+    idle_for(RGB_MATRIX_KEYREACTIVE_MAX_OFFSET * 2 - 500);
+    next_frame();
+    EXPECT_EQ(tracked_leds(), std::vector<uint8_t>({1}));
+
+    idle_for(500);
+    next_frame();
+    EXPECT_TRUE(tracked_leds().empty());
+}
+
+#ifdef RGB_MATRIX_KEYREACTIVE_DISTANCE_CACHE
+TEST_F(RgbMatrixReactive, DistancesAreCachedPerHit) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    tap_key(keys[2]);
+    tap_key(keys[7]);
+    next_frame();
+
+    ASSERT_EQ(g_last_hit_tracker.count, 2);
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_EQ(g_last_hit_distance[g_last_hit_tracker.slot[0]][i], abs(32 * i - 64));
+        EXPECT_EQ(g_last_hit_distance[g_last_hit_tracker.slot[1]][i], abs(32 * i - 224));
+    }
+}
+#endif
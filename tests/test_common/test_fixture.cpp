@@ -22,6 +22,9 @@ extern "C" {
 #include "debug.h"
 #include "eeconfig.h"
 #include "keyboard.h"
+#ifdef ENCODER_MAP_ENABLE
+#    include "keymap_introspection.h"
+#endif
 
 void set_time(uint32_t t);
 void advance_time(uint32_t ms);
@@ -36,6 +39,12 @@ TestFixture* TestFixture::m_this = nullptr;
  * The actual call is dynamicaly dispatched to the current active test fixture, which in turn has it's own keymap. */
 extern "C" uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t position) {
     uint16_t keycode;
+#ifdef ENCODER_MAP_ENABLE
+    /* Encoder events are looked up in the test's encoder_map */
+    if (position.row == KEYLOC_ENCODER_CW || position.row == KEYLOC_ENCODER_CCW) {
+        return keycode_at_encodermap_location(layer, position.col, position.row == KEYLOC_ENCODER_CW);
+    }
+#endif
     TestFixture::m_this->get_keycode(layer, position, &keycode);
     return keycode;
 }
@@ -0,0 +1,66 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/*
+ * Stub of the ChibiOS HAL calls the report endpoints make. The USB driver side is implemented by
+ * the tests, which play the host polling the endpoints.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define USB_MAX_ENDPOINTS 4
+
+#define MSG_OK 0
+#define MSG_TIMEOUT -1
+
+#define TIME_MS2I(msecs) ((sysinterval_t)(msecs))
+
+typedef uint8_t  usbep_t;
+typedef int32_t  msg_t;
+typedef uint32_t sysinterval_t;
+typedef void *   thread_reference_t;
+
+typedef enum {
+    USB_UNINIT    = 0,
+    USB_STOP      = 1,
+    USB_READY     = 2,
+    USB_SELECTED  = 3,
+    USB_ACTIVE    = 4,
+    USB_SUSPENDED = 5,
+} usbstate_t;
+
+typedef struct {
+    thread_reference_t thread;
+} USBInEndpointState;
+
+typedef struct {
+    USBInEndpointState *in_state;
+} USBEndpointConfig;
+
+typedef struct {
+    usbstate_t               state;
+    uint16_t                 transmitting;
+    const USBEndpointConfig *epc[USB_MAX_ENDPOINTS + 1];
+} USBDriver;
+
+#define usbGetDriverStateI(usbp) ((usbp)->state)
+#define usbGetTransmitStatusI(usbp, ep) (((usbp)->transmitting & (1 << (ep))) != 0)
+
+bool  usbStartTransmitI(USBDriver *usbp, usbep_t ep, const uint8_t *buf, size_t n);
+void  osalSysLock(void);
+void  osalSysUnlock(void);
+void  osalSysLockFromISR(void);
+void  osalSysUnlockFromISR(void);
+msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp, sysinterval_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
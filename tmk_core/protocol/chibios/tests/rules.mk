@@ -0,0 +1,6 @@
+usb_report_endpoints_DEFS := -DMOUSE_ENABLE -DMOUSE_SHARED_EP -DUSB_REPORT_QUEUE_DEPTH=4
+usb_report_endpoints_INC := $(TMK_PATH)/protocol/chibios/tests $(TMK_PATH)/protocol/chibios $(TMK_PATH)/protocol
+
+usb_report_endpoints_SRC := \
+	$(TMK_PATH)/protocol/chibios/tests/usb_report_endpoints_tests.cpp \
+	$(TMK_PATH)/protocol/chibios/usb_report_endpoints.c
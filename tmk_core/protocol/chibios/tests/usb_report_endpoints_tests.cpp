@@ -0,0 +1,343 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "usb_report_endpoints.h"
+}
+
+#define KEYBOARD_EP 1
+#define SHARED_EP 2
+#define KEYBOARD_SLOT_SIZE 8
+#define SHARED_SLOT_SIZE 32
+
+typedef std::vector<uint8_t> packet;
+
+// Stub USB driver: one transfer in flight per endpoint, taken by the host when it polls
+static USBDriver           usb_driver;
+static USBInEndpointState  in_states[USB_MAX_ENDPOINTS + 1];
+static USBEndpointConfig   ep_configs[USB_MAX_ENDPOINTS + 1];
+static packet              in_flight[USB_MAX_ENDPOINTS + 1];
+static std::vector<packet> sent[USB_MAX_ENDPOINTS + 1];
+static bool                locked;
+static int                 polls_while_waiting;
+
+// The host takes the endpoint's transfer, then the driver runs the IN callback from its ISR
+static void host_poll(usbep_t ep) {
+    ASSERT_FALSE(locked);
+    if (usbGetTransmitStatusI(&usb_driver, ep)) {
+        sent[ep].push_back(in_flight[ep]);
+        usb_driver.transmitting &= ~(1 << ep);
+        usb_report_in_cb(&usb_driver, ep);
+    }
+}
+
+extern "C" bool usbStartTransmitI(USBDriver *usbp, usbep_t ep, const uint8_t *buf, size_t n) {
+    EXPECT_TRUE(locked);
+    EXPECT_FALSE(usbGetTransmitStatusI(usbp, ep));
+    in_flight[ep] = packet(buf, buf + n);
+    usbp->transmitting |= 1 << ep;
+    return false;
+}
+
+extern "C" void osalSysLock(void) {
+    ASSERT_FALSE(locked);
+    locked = true;
+}
+
+extern "C" void osalSysUnlock(void) {
+    ASSERT_TRUE(locked);
+    locked = false;
+}
+
+extern "C" void osalSysLockFromISR(void) {
+    osalSysLock();
+}
+
+extern "C" void osalSysUnlockFromISR(void) {
+    osalSysUnlock();
+}
+
+// Waiting for the endpoint lets the host poll it, until the test runs out of polls and the wait times out
+extern "C" msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp, sysinterval_t timeout) {
+    EXPECT_TRUE(locked);
+    EXPECT_EQ(timeout, TIME_MS2I(USB_REPORT_WAIT_TIMEOUT_MS));
+    if (polls_while_waiting == 0) {
+        return MSG_TIMEOUT;
+    }
+    polls_while_waiting--;
+    locked = false;
+    for (usbep_t ep = 0; ep <= USB_MAX_ENDPOINTS; ep++) {
+        if (trp == &in_states[ep].thread) {
+            host_poll(ep);
+        }
+    }
+    locked = true;
+    return MSG_OK;
+}
+
+static uint8_t keyboard_slots[USB_REPORT_QUEUE_DEPTH][KEYBOARD_SLOT_SIZE];
+static uint8_t keyboard_sizes[USB_REPORT_QUEUE_DEPTH];
+static uint8_t shared_slots[USB_REPORT_QUEUE_DEPTH][SHARED_SLOT_SIZE];
+static uint8_t shared_sizes[USB_REPORT_QUEUE_DEPTH];
+
+static usb_report_endpoint_t keyboard_reports;
+static usb_report_endpoint_t shared_reports;
+
+class UsbReportEndpoints : public testing::Test {
+   protected:
+    void SetUp() override {
+        memset(&usb_driver, 0, sizeof(usb_driver));
+        for (usbep_t ep = 0; ep <= USB_MAX_ENDPOINTS; ep++) {
+            in_states[ep].thread    = NULL;
+            ep_configs[ep].in_state = &in_states[ep];
+            usb_driver.epc[ep]      = &ep_configs[ep];
+            sent[ep].clear();
+        }
+        usb_driver.state    = USB_ACTIVE;
+        locked              = false;
+        polls_while_waiting = 0;
+
+        usb_report_endpoint_init(KEYBOARD_EP, &keyboard_reports, &keyboard_slots[0][0], keyboard_sizes, KEYBOARD_SLOT_SIZE);
+        usb_report_endpoint_init(SHARED_EP, &shared_reports, &shared_slots[0][0], shared_sizes, SHARED_SLOT_SIZE);
+        locked = true;
+        usb_report_endpoints_flush_I();
+        locked = false;
+        stats_before[KEYBOARD_EP] = usb_get_endpoint_stats(KEYBOARD_EP);
+        stats_before[SHARED_EP]   = usb_get_endpoint_stats(SHARED_EP);
+    }
+
+    void send(usbep_t ep, uint8_t value, uint8_t size = 1) {
+        uint8_t report[SHARED_SLOT_SIZE + 1];
+        memset(report, value, sizeof(report));
+        usb_report_send(&usb_driver, ep, report, size);
+    }
+
+    void send_mouse(uint8_t buttons, int8_t x, int8_t y = 0) {
+        report_mouse_t report = {};
+        report.report_id      = REPORT_ID_MOUSE;
+        report.buttons        = buttons;
+        report.x              = x;
+        report.y              = y;
+        usb_report_send_mouse(&usb_driver, SHARED_EP, &report);
+    }
+
+    void poll_all(usbep_t ep) {
+        for (int i = 0; i < USB_REPORT_QUEUE_DEPTH + 2; i++) {
+            host_poll(ep);
+        }
+    }
+
+    // Counter changes since the start of the test
+    usb_endpoint_stats_t stats(usbep_t ep) {
+        usb_endpoint_stats_t now = usb_get_endpoint_stats(ep);
+        return {now.sent - stats_before[ep].sent, now.coalesced - stats_before[ep].coalesced, now.dropped - stats_before[ep].dropped};
+    }
+
+    usb_endpoint_stats_t stats_before[USB_MAX_ENDPOINTS + 1];
+};
+
+static packet mouse_packet(uint8_t buttons, int8_t x, int8_t y = 0) {
+    report_mouse_t report = {};
+    report.report_id      = REPORT_ID_MOUSE;
+    report.buttons        = buttons;
+    report.x              = x;
+    report.y              = y;
+    return packet((uint8_t *)&report, (uint8_t *)&report + sizeof(report));
+}
+
+TEST_F(UsbReportEndpoints, SendsInOrderOnePerPoll) {
+    send(KEYBOARD_EP, 1);
+    send(KEYBOARD_EP, 2, 3);
+    send(KEYBOARD_EP, 3);
+    EXPECT_TRUE(usbGetTransmitStatusI(&usb_driver, KEYBOARD_EP));
+
+    host_poll(KEYBOARD_EP);
+    ASSERT_EQ(sent[KEYBOARD_EP].size(), 1u);
+    EXPECT_EQ(sent[KEYBOARD_EP][0], packet({1}));
+
+    host_poll(KEYBOARD_EP);
+    host_poll(KEYBOARD_EP);
+    ASSERT_EQ(sent[KEYBOARD_EP].size(), 3u);
+    EXPECT_EQ(sent[KEYBOARD_EP][1], packet({2, 2, 2}));
+    EXPECT_EQ(sent[KEYBOARD_EP][2], packet({3}));
+    EXPECT_FALSE(usbGetTransmitStatusI(&usb_driver, KEYBOARD_EP));
+
+    host_poll(KEYBOARD_EP);
+    EXPECT_EQ(sent[KEYBOARD_EP].size(), 3u);
+    EXPECT_EQ(stats(KEYBOARD_EP).sent, 3u);
+    EXPECT_TRUE(sent[SHARED_EP].empty());
+}
+
+TEST_F(UsbReportEndpoints, WrapsAroundIndexes) {
+    for (int i = 0; i < 600; i++) {
+        send(KEYBOARD_EP, i & 0xFF);
+        host_poll(KEYBOARD_EP);
+        ASSERT_EQ(sent[KEYBOARD_EP].size(), (size_t)i + 1);
+        ASSERT_EQ(sent[KEYBOARD_EP][i][0], i & 0xFF);
+    }
+}
+
+TEST_F(UsbReportEndpoints, FullQueueWaitsForPoll) {
+    for (int i = 0; i < USB_REPORT_QUEUE_DEPTH; i++) {
+        send(KEYBOARD_EP, i);
+    }
+    EXPECT_TRUE(sent[KEYBOARD_EP].empty());
+
+    // The report in flight is still queued, so the next one waits for the host to take it
+    polls_while_waiting = 1;
+    send(KEYBOARD_EP, 0xFE);
+    EXPECT_EQ(polls_while_waiting, 0);
+    EXPECT_EQ(sent[KEYBOARD_EP].size(), 1u);
+
+    poll_all(KEYBOARD_EP);
+    ASSERT_EQ(sent[KEYBOARD_EP].size(), (size_t)USB_REPORT_QUEUE_DEPTH + 1);
+    for (int i = 0; i < USB_REPORT_QUEUE_DEPTH; i++) {
+        EXPECT_EQ(sent[KEYBOARD_EP][i][0], i);
+    }
+    EXPECT_EQ(sent[KEYBOARD_EP][USB_REPORT_QUEUE_DEPTH][0], 0xFE);
+    EXPECT_EQ(stats(KEYBOARD_EP).dropped, 0u);
+}
+
+TEST_F(UsbReportEndpoints, FullQueueDropsAfterTimeout) {
+    for (int i = 0; i < USB_REPORT_QUEUE_DEPTH; i++) {
+        send(KEYBOARD_EP, i);
+    }
+    send(KEYBOARD_EP, 0xFF);
+    EXPECT_EQ(stats(KEYBOARD_EP).dropped, 1u);
+
+    poll_all(KEYBOARD_EP);
+    ASSERT_EQ(sent[KEYBOARD_EP].size(), (size_t)USB_REPORT_QUEUE_DEPTH);
+    EXPECT_EQ(sent[KEYBOARD_EP].back()[0], USB_REPORT_QUEUE_DEPTH - 1);
+}
+
+TEST_F(UsbReportEndpoints, DropsOversizedReport) {
+    send(KEYBOARD_EP, 1, KEYBOARD_SLOT_SIZE + 1);
+    EXPECT_EQ(stats(KEYBOARD_EP).dropped, 1u);
+    EXPECT_FALSE(usbGetTransmitStatusI(&usb_driver, KEYBOARD_EP));
+}
+
+TEST_F(UsbReportEndpoints, IgnoresReportsWhileInactive) {
+    usb_driver.state = USB_SUSPENDED;
+    send(KEYBOARD_EP, 1);
+    send_mouse(0, 10);
+    usb_driver.state = USB_ACTIVE;
+
+    poll_all(KEYBOARD_EP);
+    poll_all(SHARED_EP);
+    EXPECT_TRUE(sent[KEYBOARD_EP].empty());
+    EXPECT_TRUE(sent[SHARED_EP].empty());
+}
+
+TEST_F(UsbReportEndpoints, FlushDropsQueuedReports) {
+    send(KEYBOARD_EP, 1);
+    send(KEYBOARD_EP, 2);
+    send(SHARED_EP, 3);
+    send_mouse(0, 10);
+
+    // The host resets the endpoints, abandoning the transfers in flight
+    usb_driver.transmitting = 0;
+    locked                  = true;
+    usb_report_endpoints_flush_I();
+    locked = false;
+
+    send(KEYBOARD_EP, 4);
+    poll_all(KEYBOARD_EP);
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[KEYBOARD_EP].size(), 1u);
+    EXPECT_EQ(sent[KEYBOARD_EP][0][0], 4);
+    EXPECT_TRUE(sent[SHARED_EP].empty());
+}
+
+TEST_F(UsbReportEndpoints, MouseSentAtOnceOnIdleEndpoint) {
+    send_mouse(0, 5);
+    EXPECT_TRUE(usbGetTransmitStatusI(&usb_driver, SHARED_EP));
+
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[SHARED_EP].size(), 1u);
+    EXPECT_EQ(sent[SHARED_EP][0], mouse_packet(0, 5));
+}
+
+TEST_F(UsbReportEndpoints, MergesMotionWhileBusy) {
+    send_mouse(0, 5);
+    send_mouse(0, 10, -2);
+    send_mouse(0, 20, -3);
+    send_mouse(0, -1);
+
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[SHARED_EP].size(), 2u);
+    EXPECT_EQ(sent[SHARED_EP][0], mouse_packet(0, 5));
+    EXPECT_EQ(sent[SHARED_EP][1], mouse_packet(0, 29, -5));
+    EXPECT_EQ(stats(SHARED_EP).sent, 2u);
+    EXPECT_EQ(stats(SHARED_EP).coalesced, 2u);
+}
+
+TEST_F(UsbReportEndpoints, MotionBeyondReportRangeIsNotMerged) {
+    send_mouse(0, 1);
+    send_mouse(0, 100);
+    send_mouse(0, 100);
+
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[SHARED_EP].size(), 3u);
+    EXPECT_EQ(sent[SHARED_EP][1], mouse_packet(0, 100));
+    EXPECT_EQ(sent[SHARED_EP][2], mouse_packet(0, 100));
+}
+
+TEST_F(UsbReportEndpoints, OtherReportsGoBeforeWaitingMotion) {
+    send(SHARED_EP, 1);
+    send_mouse(0, 5);
+    send(SHARED_EP, 2, 3);
+    send_mouse(0, 5);
+    send(SHARED_EP, 3, 3);
+
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[SHARED_EP].size(), 4u);
+    EXPECT_EQ(sent[SHARED_EP][0], packet({1}));
+    EXPECT_EQ(sent[SHARED_EP][1], packet({2, 2, 2}));
+    EXPECT_EQ(sent[SHARED_EP][2], packet({3, 3, 3}));
+    EXPECT_EQ(sent[SHARED_EP][3], mouse_packet(0, 10));
+}
+
+TEST_F(UsbReportEndpoints, ButtonChangesStayInOrder) {
+    polls_while_waiting = 100;
+    send(SHARED_EP, 1);
+    send_mouse(0, 5);
+    send_mouse(1, 0);
+    send(SHARED_EP, 2);
+    send_mouse(1, 7);
+    send_mouse(0, 0);
+    send(SHARED_EP, 3);
+
+    // Motion before the press is queued ahead of it, motion while held stays ahead of the release
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[SHARED_EP].size(), 7u);
+    EXPECT_EQ(sent[SHARED_EP][0], packet({1}));
+    EXPECT_EQ(sent[SHARED_EP][1], mouse_packet(0, 5));
+    EXPECT_EQ(sent[SHARED_EP][2], mouse_packet(1, 0));
+    EXPECT_EQ(sent[SHARED_EP][3], packet({2}));
+    EXPECT_EQ(sent[SHARED_EP][4], mouse_packet(1, 7));
+    EXPECT_EQ(sent[SHARED_EP][5], mouse_packet(0, 0));
+    EXPECT_EQ(sent[SHARED_EP][6], packet({3}));
+}
+
+TEST_F(UsbReportEndpoints, ButtonChangeWaitsForRoom) {
+    for (int i = 0; i < USB_REPORT_QUEUE_DEPTH; i++) {
+        send(SHARED_EP, i);
+    }
+    send_mouse(0, 5);
+
+    // Both the waiting motion and the press need a slot
+    polls_while_waiting = 2;
+    send_mouse(1, 0);
+    EXPECT_EQ(polls_while_waiting, 0);
+
+    poll_all(SHARED_EP);
+    ASSERT_EQ(sent[SHARED_EP].size(), (size_t)USB_REPORT_QUEUE_DEPTH + 2);
+    EXPECT_EQ(sent[SHARED_EP][USB_REPORT_QUEUE_DEPTH], mouse_packet(0, 5));
+    EXPECT_EQ(sent[SHARED_EP][USB_REPORT_QUEUE_DEPTH + 1], mouse_packet(1, 0));
+    EXPECT_EQ(stats(SHARED_EP).dropped, 0u);
+}
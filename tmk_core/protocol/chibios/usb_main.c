@@ -43,6 +43,7 @@
 #include "usb_device_state.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
+#include "usb_report_endpoints.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -129,16 +130,6 @@ static const USBDescriptor *usb_get_descriptor_cb(USBDriver *usbp, uint8_t dtype
         return &desc;
 }
 
-/*
- * USB notification callback that does nothing.  Needed to work around bugs in
- * some USB LLDs that fail to resume the waiting thread when the notification
- * callback pointer is NULL.
- */
-static void dummy_usb_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
-}
-
 #ifndef KEYBOARD_SHARED_EP
 /* keyboard endpoint state structure */
 static USBInEndpointState kbd_ep_state;
@@ -146,7 +137,7 @@ static USBInEndpointState kbd_ep_state;
 static const USBEndpointConfig kbd_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_in_cb,       /* IN notification callback */
     NULL,                   /* OUT notification callback */
     KEYBOARD_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -164,7 +155,7 @@ static USBInEndpointState mouse_ep_state;
 static const USBEndpointConfig mouse_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_in_cb,       /* IN notification callback */
     NULL,                   /* OUT notification callback */
     MOUSE_EPSIZE,           /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -182,7 +173,7 @@ static USBInEndpointState shared_ep_state;
 static const USBEndpointConfig shared_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_in_cb,       /* IN notification callback */
     NULL,                   /* OUT notification callback */
     SHARED_EPSIZE,          /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -200,7 +191,7 @@ static USBInEndpointState joystick_ep_state;
 static const USBEndpointConfig joystick_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_in_cb,       /* IN notification callback */
     NULL,                   /* OUT notification callback */
     JOYSTICK_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -218,7 +209,7 @@ static USBInEndpointState digitizer_ep_state;
 static const USBEndpointConfig digitizer_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_in_cb,       /* IN notification callback */
     NULL,                   /* OUT notification callback */
     DIGITIZER_EPSIZE,       /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -228,6 +219,45 @@ static const USBEndpointConfig digitizer_ep_config = {
 };
 #endif
 
+/* ---------------------------------------------------------
+ *                     Report queues
+ * ---------------------------------------------------------
+ */
+
+#ifndef KEYBOARD_SHARED_EP
+USB_REPORT_ENDPOINT(kbd, KEYBOARD_REPORT_SIZE);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+USB_REPORT_ENDPOINT(mouse, sizeof(report_mouse_t));
+#endif
+#ifdef SHARED_EP_ENABLE
+USB_REPORT_ENDPOINT(shared, sizeof(universal_report_blank));
+#endif
+#if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
+USB_REPORT_ENDPOINT(joystick, sizeof(report_joystick_t));
+#endif
+#if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
+USB_REPORT_ENDPOINT(digitizer, sizeof(report_digitizer_t));
+#endif
+
+static void report_endpoints_init(void) {
+#ifndef KEYBOARD_SHARED_EP
+    USB_REPORT_ENDPOINT_INIT(kbd, KEYBOARD_IN_EPNUM);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    USB_REPORT_ENDPOINT_INIT(mouse, MOUSE_IN_EPNUM);
+#endif
+#ifdef SHARED_EP_ENABLE
+    USB_REPORT_ENDPOINT_INIT(shared, SHARED_IN_EPNUM);
+#endif
+#if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
+    USB_REPORT_ENDPOINT_INIT(joystick, JOYSTICK_IN_EPNUM);
+#endif
+#if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
+    USB_REPORT_ENDPOINT_INIT(digitizer, DIGITIZER_IN_EPNUM);
+#endif
+}
+
 #ifdef USB_ENDPOINTS_ARE_REORDERABLE
 typedef struct {
     size_t              queue_capacity_in;
@@ -489,6 +519,10 @@ void usb_event_queue_task(void) {
                 break;
             case USB_EVENT_RESET:
                 usb_device_state_set_reset();
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+                /* The host sets the Resolution Multiplier again if it supports it */
+                host_mouse_set_resolution_multiplier(0);
+#endif
                 break;
             default:
                 // Nothing to do, we don't handle it.
@@ -506,6 +540,7 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 
         case USB_EVENT_CONFIGURED:
             osalSysLockFromISR();
+            usb_report_endpoints_flush_I();
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
             usbInitEndpointI(usbp, KEYBOARD_IN_EPNUM, &kbd_ep_config);
@@ -546,6 +581,12 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             /* Falls into.*/
         case USB_EVENT_RESET:
             usb_event_queue_enqueue(event);
+            if (event != USB_EVENT_SUSPEND) {
+                /* Transfers in progress are abandoned along with the configuration */
+                chSysLockFromISR();
+                usb_report_endpoints_flush_I();
+                chSysUnlockFromISR();
+            }
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -595,7 +636,38 @@ static uint16_t get_hword(uint8_t *p) {
 
 static uint8_t set_report_buf[2] __attribute__((aligned(4)));
 
-static void set_led_transfer_cb(USBDriver *usbp) {
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    define HID_REPORT_TYPE_FEATURE 0x03
+
+static report_mouse_resolution_t mouse_resolution_report;
+
+static bool get_mouse_resolution_report(USBDriver *usbp) {
+    if (usbp->setup[3] != HID_REPORT_TYPE_FEATURE) { /* MSB(wValue) */
+        return false;
+    }
+#    ifdef MOUSE_SHARED_EP
+    mouse_resolution_report.report_id = REPORT_ID_MOUSE;
+#    endif
+    mouse_resolution_report.multiplier = host_mouse_resolution_multiplier();
+    usbSetupTransfer(usbp, (uint8_t *)&mouse_resolution_report, sizeof(mouse_resolution_report), NULL);
+    return true;
+}
+#endif
+
+static void set_report_transfer_cb(USBDriver *usbp) {
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+    if (usbp->setup[3] == HID_REPORT_TYPE_FEATURE) { /* MSB(wValue) */
+        report_mouse_resolution_t *report = (report_mouse_resolution_t *)set_report_buf;
+#    ifdef MOUSE_SHARED_EP
+        if (usbp->setup[6] == sizeof(report_mouse_resolution_t) && report->report_id == REPORT_ID_MOUSE) {
+#    else
+        if (usbp->setup[6] == sizeof(report_mouse_resolution_t) && usbp->setup[4] == MOUSE_INTERFACE) {
+#    endif
+            host_mouse_set_resolution_multiplier(report->multiplier);
+        }
+        return;
+    }
+#endif
     if (usbp->setup[6] == 2) { /* LSB(wLength) */
         uint8_t report_id = set_report_buf[0];
         if ((report_id == REPORT_ID_KEYBOARD) || (report_id == REPORT_ID_NKRO)) {
@@ -632,6 +704,11 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
 #endif
 #if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
                             case MOUSE_INTERFACE:
+#    ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+                                if (get_mouse_resolution_report(usbp)) {
+                                    return TRUE;
+                                }
+#    endif
                                 usbSetupTransfer(usbp, (uint8_t *)&mouse_report_sent, sizeof(mouse_report_sent), NULL);
                                 return TRUE;
                                 break;
@@ -647,6 +724,11 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
 #    endif
 #    ifdef MOUSE_SHARED_EP
                                 if (usbp->setup[2] == REPORT_ID_MOUSE) {
+#        ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+                                    if (get_mouse_resolution_report(usbp)) {
+                                        return TRUE;
+                                    }
+#        endif
                                     usbSetupTransfer(usbp, (uint8_t *)&mouse_report_sent, sizeof(mouse_report_sent), NULL);
                                     return TRUE;
                                     break;
@@ -683,7 +765,10 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
 #if defined(SHARED_EP_ENABLE) && !defined(KEYBOARD_SHARED_EP)
                             case SHARED_INTERFACE:
 #endif
-                                usbSetupTransfer(usbp, set_report_buf, sizeof(set_report_buf), set_led_transfer_cb);
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP) && defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE)
+                            case MOUSE_INTERFACE:
+#endif
+                                usbSetupTransfer(usbp, set_report_buf, sizeof(set_report_buf), set_report_transfer_cb);
                                 return TRUE;
                                 break;
                         }
@@ -789,6 +874,8 @@ void init_usb_driver(USBDriver *usbp) {
      * Note, a delay is inserted in order to not have to disconnect the cable
      * after a reset.
      */
+    report_endpoints_init();
+
     usbDisconnectBus(usbp);
     usbStop(usbp);
     wait_ms(50);
@@ -859,25 +946,10 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
+/* Queues a report for an IN endpoint
+ * not callable from ISR or locked state */
 void send_report(uint8_t endpoint, void *report, size_t size) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, endpoint)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[endpoint]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    usbStartTransmitI(&USB_DRIVER, endpoint, report, size);
-    osalSysUnlock();
+    usb_report_send(&USB_DRIVER, endpoint, report, size);
 }
 
 /* prepare and start sending a report IN
@@ -908,9 +980,18 @@ void send_keyboard(report_keyboard_t *report) {
  * ---------------------------------------------------------
  */
 
+#ifdef MOUSE_ENABLE
+#    ifdef MOUSE_SHARED_EP
+#        define MOUSE_REPORT_EPNUM SHARED_IN_EPNUM
+#    else
+#        define MOUSE_REPORT_EPNUM MOUSE_IN_EPNUM
+#    endif
+#endif
+
+/* Queues a mouse report, merging its motion into the report waiting for the endpoint */
 void send_mouse(report_mouse_t *report) {
 #ifdef MOUSE_ENABLE
-    send_report(MOUSE_IN_EPNUM, report, sizeof(report_mouse_t));
+    usb_report_send_mouse(&USB_DRIVER, MOUSE_REPORT_EPNUM, report);
     mouse_report_sent = *report;
 #endif
 }
@@ -20,6 +20,8 @@
 #include <ch.h>
 #include <hal.h>
 
+#include "usb_report_endpoints.h"
+
 /* -------------------------
  * General USB driver header
  * -------------------------
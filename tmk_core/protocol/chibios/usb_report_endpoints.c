@@ -0,0 +1,216 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "usb_report_endpoints.h"
+
+/* The queue indexes are free running bytes, so their difference has to tell a full queue from an empty one */
+_Static_assert(USB_REPORT_QUEUE_DEPTH > 0 && (USB_REPORT_QUEUE_DEPTH & (USB_REPORT_QUEUE_DEPTH - 1)) == 0 && USB_REPORT_QUEUE_DEPTH <= 128, "USB_REPORT_QUEUE_DEPTH must be a power of two no larger than 128");
+
+/* What a report endpoint is sending */
+enum {
+    REPORT_IN_FLIGHT_NONE,
+    REPORT_IN_FLIGHT_QUEUED, /* the oldest queued report */
+    REPORT_IN_FLIGHT_MOUSE,  /* the merged mouse report */
+};
+
+static usb_report_endpoint_t *report_endpoints[USB_MAX_ENDPOINTS + 1];
+
+/* Per endpoint report counters, only touched with the system locked */
+static usb_endpoint_stats_t endpoint_stats[USB_MAX_ENDPOINTS + 1];
+
+#ifdef MOUSE_ENABLE
+/* Mouse motion is merged into a report that waits behind every queued report, so keyboard and
+ * consumer reports sharing the endpoint aren't held up by it. Button changes are queued in order
+ * with the other reports instead, so a click stays on the right side of the keys around it. */
+static report_mouse_t mouse_report_pending    = {0};
+static report_mouse_t mouse_report_in_flight  = {0};
+static bool           mouse_report_is_pending = false;
+static uint8_t        mouse_report_buttons    = 0;
+static usbep_t        mouse_report_ep         = 0;
+#endif
+
+void usb_report_endpoint_init(usbep_t ep, usb_report_endpoint_t *endpoint, uint8_t *slots, uint8_t *sizes, uint8_t slot_size) {
+    usb_report_queue_init(&endpoint->queue, slots, sizes, slot_size, USB_REPORT_QUEUE_DEPTH);
+    endpoint->in_flight  = REPORT_IN_FLIGHT_NONE;
+    report_endpoints[ep] = endpoint;
+}
+
+void usb_report_endpoints_flush_I(void) {
+    for (int i = 0; i <= USB_MAX_ENDPOINTS; i++) {
+        if (report_endpoints[i]) {
+            usb_report_queue_flush(&report_endpoints[i]->queue);
+            report_endpoints[i]->in_flight = REPORT_IN_FLIGHT_NONE;
+        }
+    }
+#ifdef MOUSE_ENABLE
+    mouse_report_is_pending = false;
+    mouse_report_buttons    = 0;
+#endif
+}
+
+usb_endpoint_stats_t usb_get_endpoint_stats(uint8_t endpoint) {
+    usb_endpoint_stats_t stats = {0};
+    if (endpoint <= USB_MAX_ENDPOINTS) {
+        osalSysLock();
+        stats = endpoint_stats[endpoint];
+        osalSysUnlock();
+    }
+    return stats;
+}
+
+/* Starts sending the oldest queued report, or the merged mouse report once nothing is queued,
+ * if the endpoint is free. call with the system locked */
+static void report_endpoint_kick_I(USBDriver *usbp, usbep_t ep) {
+    usb_report_endpoint_t *endpoint = report_endpoints[ep];
+    uint8_t *              report;
+    uint8_t                size;
+
+    if (endpoint == NULL || endpoint->in_flight != REPORT_IN_FLIGHT_NONE || usbGetTransmitStatusI(usbp, ep)) {
+        return;
+    }
+    report = usb_report_queue_peek(&endpoint->queue, &size);
+    if (report) {
+        usbStartTransmitI(usbp, ep, report, size);
+        endpoint->in_flight = REPORT_IN_FLIGHT_QUEUED;
+        endpoint_stats[ep].sent++;
+        return;
+    }
+#ifdef MOUSE_ENABLE
+    if (mouse_report_is_pending && ep == mouse_report_ep) {
+        /* Sent from its own buffer, so the next report can be merged while this one goes out */
+        mouse_report_in_flight  = mouse_report_pending;
+        mouse_report_is_pending = false;
+        usbStartTransmitI(usbp, ep, (uint8_t *)&mouse_report_in_flight, sizeof(report_mouse_t));
+        endpoint->in_flight = REPORT_IN_FLIGHT_MOUSE;
+        endpoint_stats[ep].sent++;
+    }
+#endif
+}
+
+void usb_report_in_cb(USBDriver *usbp, usbep_t ep) {
+    osalSysLockFromISR();
+    usb_report_endpoint_t *endpoint = report_endpoints[ep];
+    if (endpoint) {
+        if (endpoint->in_flight == REPORT_IN_FLIGHT_QUEUED) {
+            usb_report_queue_pop(&endpoint->queue);
+        }
+        endpoint->in_flight = REPORT_IN_FLIGHT_NONE;
+    }
+    report_endpoint_kick_I(usbp, ep);
+    osalSysUnlockFromISR();
+}
+
+/* Adds a report behind the queued ones, waiting for room if the queue is full
+ * i.e. the host has stopped polling or the reports come faster than it polls
+ * call with the system locked, returns false if the report was dropped */
+static bool report_endpoint_push_S(USBDriver *usbp, usbep_t ep, const void *report, size_t size) {
+    usb_report_endpoint_t *endpoint = report_endpoints[ep];
+
+    while (usb_report_queue_is_full(&endpoint->queue)) {
+        /* Need to either suspend, or loop and call unlock/lock during
+         * every iteration - otherwise the system will remain locked,
+         * no interrupts served, so USB not going through as well.
+         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
+        if (osalThreadSuspendTimeoutS(&usbp->epc[ep]->in_state->thread, TIME_MS2I(USB_REPORT_WAIT_TIMEOUT_MS)) == MSG_TIMEOUT) {
+            endpoint_stats[ep].dropped++;
+            return false;
+        }
+    }
+    if (size > UINT8_MAX || !usb_report_queue_push(&endpoint->queue, report, size)) {
+        endpoint_stats[ep].dropped++;
+        return false;
+    }
+    return true;
+}
+
+void usb_report_send(USBDriver *usbp, usbep_t ep, const void *report, size_t size) {
+    osalSysLock();
+    if (usbGetDriverStateI(usbp) != USB_ACTIVE || report_endpoints[ep] == NULL) {
+        osalSysUnlock();
+        return;
+    }
+
+    if (report_endpoint_push_S(usbp, ep, report, size)) {
+        report_endpoint_kick_I(usbp, ep);
+    }
+    osalSysUnlock();
+}
+
+#ifdef MOUSE_ENABLE
+/* Adds one relative axis to another, returns false if the sum is outside the report range */
+static bool mouse_add_axis(int32_t *sum, int32_t value, int32_t limit) {
+    *sum += value;
+    return *sum >= -limit && *sum <= limit;
+}
+
+/* Merges a report into a waiting one, as long as no motion or button change would be lost */
+static bool mouse_coalesce(report_mouse_t *waiting, const report_mouse_t *report) {
+#    ifdef MOUSE_EXTENDED_REPORT
+    const int32_t xy_limit = 32767;
+#    else
+    const int32_t xy_limit = 127;
+#    endif
+    int32_t x = waiting->x, y = waiting->y, v = waiting->v, h = waiting->h;
+
+    if (report->buttons != waiting->buttons) {
+        return false;
+    }
+    if (!mouse_add_axis(&x, report->x, xy_limit) || !mouse_add_axis(&y, report->y, xy_limit) || !mouse_add_axis(&v, report->v, 127) || !mouse_add_axis(&h, report->h, 127)) {
+        return false;
+    }
+
+    waiting->x = x;
+    waiting->y = y;
+    waiting->v = v;
+    waiting->h = h;
+#    ifdef MOUSE_EXTENDED_REPORT
+    waiting->boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+    waiting->boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#    endif
+    return true;
+}
+#endif
+
+void usb_report_send_mouse(USBDriver *usbp, usbep_t ep, const report_mouse_t *report) {
+#ifdef MOUSE_ENABLE
+    osalSysLock();
+    if (usbGetDriverStateI(usbp) != USB_ACTIVE || report_endpoints[ep] == NULL) {
+        osalSysUnlock();
+        return;
+    }
+    mouse_report_ep = ep;
+
+    /* Locked, so the waiting report can't start sending while it's merged into */
+    if (mouse_report_is_pending && mouse_coalesce(&mouse_report_pending, report)) {
+        endpoint_stats[ep].coalesced++;
+        osalSysUnlock();
+        return;
+    }
+
+    /* The waiting report can't take this one, so it goes in the queue ahead of it. Taken out of
+     * the slot first, as the endpoint could otherwise send it while this waits for room */
+    if (mouse_report_is_pending) {
+        report_mouse_t waiting  = mouse_report_pending;
+        mouse_report_is_pending = false;
+        if (!report_endpoint_push_S(usbp, ep, &waiting, sizeof(report_mouse_t))) {
+            osalSysUnlock();
+            return;
+        }
+    }
+
+    if (report->buttons != mouse_report_buttons) {
+        if (report_endpoint_push_S(usbp, ep, report, sizeof(report_mouse_t))) {
+            mouse_report_buttons = report->buttons;
+        }
+    } else {
+        mouse_report_pending    = *report;
+        mouse_report_is_pending = true;
+    }
+    report_endpoint_kick_I(usbp, ep);
+    osalSysUnlock();
+#else
+    (void)usbp;
+    (void)ep;
+    (void)report;
+#endif
+}
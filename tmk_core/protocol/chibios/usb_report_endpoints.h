@@ -0,0 +1,63 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <hal.h>
+
+#include "report.h"
+#include "usb_report_queue.h"
+
+/* How long to wait for room in an endpoint's report queue before dropping a report */
+#ifndef USB_REPORT_WAIT_TIMEOUT_MS
+#    define USB_REPORT_WAIT_TIMEOUT_MS 10
+#endif
+
+/* Reports queued per endpoint, a power of two */
+#ifndef USB_REPORT_QUEUE_DEPTH
+#    define USB_REPORT_QUEUE_DEPTH 8
+#endif
+
+typedef struct {
+    uint32_t sent;      /* reports handed to the endpoint */
+    uint32_t coalesced; /* reports merged into one waiting for the endpoint */
+    uint32_t dropped;   /* reports given up on after waiting for the endpoint */
+} usb_endpoint_stats_t;
+
+/* Reports waiting for a report IN endpoint, filled by the main loop and drained by the endpoint's
+ * IN callback, so a burst of reports goes out one per polling interval without the main loop waiting */
+typedef struct {
+    usb_report_queue_t queue;
+    uint8_t            in_flight; /* which report the endpoint is sending */
+} usb_report_endpoint_t;
+
+#define USB_REPORT_ENDPOINT(name, report_size)                                         \
+    static uint8_t               name##_report_slots[USB_REPORT_QUEUE_DEPTH][report_size]; \
+    static uint8_t               name##_report_sizes[USB_REPORT_QUEUE_DEPTH];              \
+    static usb_report_endpoint_t name##_reports
+
+#define USB_REPORT_ENDPOINT_INIT(name, epnum) usb_report_endpoint_init(epnum, &name##_reports, &name##_report_slots[0][0], name##_report_sizes, sizeof(name##_report_slots[0]))
+
+/* Registers the queue of a report IN endpoint */
+void usb_report_endpoint_init(usbep_t ep, usb_report_endpoint_t *endpoint, uint8_t *slots, uint8_t *sizes, uint8_t slot_size);
+
+/* Drops queued reports when the host resets the endpoints
+ * call with the system locked */
+void usb_report_endpoints_flush_I(void);
+
+/* IN notification callback of the report endpoints (called from ISR, unlocked state)
+ * always set, as some USB LLDs fail to resume the waiting thread when the callback pointer is NULL */
+void usb_report_in_cb(USBDriver *usbp, usbep_t ep);
+
+/* Queues a report for an IN endpoint
+ * not callable from ISR or locked state */
+void usb_report_send(USBDriver *usbp, usbep_t ep, const void *report, size_t size);
+
+/* Queues a mouse report for an IN endpoint, merging motion into the report waiting for the endpoint
+ * not callable from ISR or locked state */
+void usb_report_send_mouse(USBDriver *usbp, usbep_t ep, const report_mouse_t *report);
+
+/* Counters for an IN endpoint */
+usb_endpoint_stats_t usb_get_endpoint_stats(uint8_t endpoint);
@@ -43,6 +43,9 @@ extern keymap_config_t keymap_config;
 static host_driver_t *driver;
 static uint16_t       last_system_usage   = 0;
 static uint16_t       last_consumer_usage = 0;
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+static uint8_t mouse_resolution_multiplier = 0;
+#endif
 
 void host_set_driver(host_driver_t *d) {
     driver = d;
@@ -253,3 +256,15 @@ uint16_t host_last_system_usage(void) {
 uint16_t host_last_consumer_usage(void) {
     return last_consumer_usage;
 }
+
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+/* Resolution Multiplier feature of the mouse report, set by the host to enable high resolution scrolling.
+ * Hosts which don't support it never set it, so it stays at 0 and wheel values are whole notches. */
+uint8_t host_mouse_resolution_multiplier(void) {
+    return mouse_resolution_multiplier;
+}
+
+void host_mouse_set_resolution_multiplier(uint8_t multiplier) {
+    mouse_resolution_multiplier = multiplier;
+}
+#endif
@@ -49,6 +49,11 @@ void    host_programmable_button_send(uint32_t data);
 uint16_t host_last_system_usage(void);
 uint16_t host_last_consumer_usage(void);
 
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+uint8_t host_mouse_resolution_multiplier(void);
+void    host_mouse_set_resolution_multiplier(uint8_t multiplier);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
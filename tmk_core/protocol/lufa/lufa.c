@@ -80,6 +80,12 @@ static uint8_t keyboard_led_state = 0;
 
 static report_keyboard_t keyboard_report_sent;
 
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    define HID_REPORT_TYPE_FEATURE 0x03
+
+static report_mouse_resolution_t mouse_resolution_report;
+#endif
+
 /* Host driver */
 static uint8_t keyboard_leds(void);
 static void    send_keyboard(report_keyboard_t *report);
@@ -292,6 +298,10 @@ void EVENT_USB_Device_Disconnect(void) {
 void EVENT_USB_Device_Reset(void) {
     print("[R]");
     usb_device_state_set_reset();
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+    /* The host sets the Resolution Multiplier again if it supports it */
+    host_mouse_set_resolution_multiplier(0);
+#endif
 }
 
 /** \brief Event USB Device Connect
@@ -430,6 +440,21 @@ Boot Keyboard   Required    Optional    Required    Required    Required    Requ
 Non-Boot Keybrd Required    Optional    Required    Required    Optional    Optional
 Other Device    Required    Optional    Optional    Optional    Optional    Optional
 */
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+/** \brief Checks whether a control request is for the mouse's Resolution Multiplier feature report
+ */
+static bool is_mouse_resolution_request(void) {
+    if ((USB_ControlRequest.wValue >> 8) != HID_REPORT_TYPE_FEATURE) {
+        return false;
+    }
+#    ifdef MOUSE_SHARED_EP
+    return USB_ControlRequest.wIndex == SHARED_INTERFACE && (USB_ControlRequest.wValue & 0xFF) == REPORT_ID_MOUSE;
+#    else
+    return USB_ControlRequest.wIndex == MOUSE_INTERFACE;
+#    endif
+}
+#endif
+
 /** \brief Event handler for the USB_ControlRequest event.
  *
  *  This is fired before passing along unhandled control requests to the library for processing internally.
@@ -452,6 +477,16 @@ void EVENT_USB_Device_ControlRequest(void) {
                         ReportSize = sizeof(keyboard_report_sent);
                         break;
                 }
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+                if (is_mouse_resolution_request()) {
+#    ifdef MOUSE_SHARED_EP
+                    mouse_resolution_report.report_id = REPORT_ID_MOUSE;
+#    endif
+                    mouse_resolution_report.multiplier = host_mouse_resolution_multiplier();
+                    ReportData                         = (uint8_t *)&mouse_resolution_report;
+                    ReportSize                         = sizeof(mouse_resolution_report);
+                }
+#endif
 
                 /* Write the report data to the control endpoint */
                 Endpoint_Write_Control_Stream_LE(ReportData, ReportSize);
@@ -461,6 +496,26 @@ void EVENT_USB_Device_ControlRequest(void) {
             break;
         case HID_REQ_SetReport:
             if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) {
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+                if (is_mouse_resolution_request()) {
+                    Endpoint_ClearSETUP();
+
+                    while (!(Endpoint_IsOUTReceived())) {
+                        if (USB_DeviceState == DEVICE_STATE_Unattached) return;
+                    }
+
+                    if (Endpoint_BytesInEndpoint() == sizeof(report_mouse_resolution_t)) {
+#    ifdef MOUSE_SHARED_EP
+                        Endpoint_Discard_8(); // Report ID, already checked in wValue
+#    endif
+                        host_mouse_set_resolution_multiplier(Endpoint_Read_8() & 0x0F);
+                    }
+
+                    Endpoint_ClearOUT();
+                    Endpoint_ClearStatusStage();
+                    break;
+                }
+#endif
                 // Interface
                 switch (USB_ControlRequest.wIndex) {
                     case KEYBOARD_INTERFACE:
@@ -209,6 +209,15 @@ typedef int16_t mouse_xy_report_t;
 typedef int8_t mouse_xy_report_t;
 #endif
 
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+// Wheel counts per notch once the host has enabled the Resolution Multiplier
+#    ifndef POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#        define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
+#    elif POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER < 1 || POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER > 255
+#        error POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER must be between 1 and 255
+#    endif
+#endif
+
 typedef struct {
 #ifdef MOUSE_SHARED_EP
     uint8_t report_id;
@@ -224,6 +233,17 @@ typedef struct {
     int8_t            h;
 } __attribute__((packed)) report_mouse_t;
 
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+// Resolution Multiplier feature report, shared by both wheels
+typedef struct {
+#    ifdef MOUSE_SHARED_EP
+    uint8_t report_id;
+#    endif
+    uint8_t multiplier : 4; // 1 once the host has enabled high resolution scrolling
+    uint8_t reserved : 4;
+} __attribute__((packed)) report_mouse_resolution_t;
+#endif
+
 typedef struct {
 #ifdef DIGITIZER_SHARED_EP
     uint8_t report_id;
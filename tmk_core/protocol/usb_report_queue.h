@@ -0,0 +1,98 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Single producer, single consumer ring of reports waiting for an IN endpoint.
+ *
+ * The main loop pushes reports and the endpoint's IN-complete callback pops them, so neither side
+ * needs a lock: head is only written by the producer and tail only by the consumer. The oldest
+ * report stays in its slot while it is being sent, and is popped once the host has taken it.
+ */
+typedef struct {
+    uint8_t *        slots;     // depth * slot_size bytes of report data
+    uint8_t *        sizes;     // size of the report in each slot
+    uint8_t          slot_size; // largest report the queue takes
+    uint8_t          depth;     // number of slots, a power of two
+    volatile uint8_t head;      // next slot to fill, free running
+    volatile uint8_t tail;      // oldest filled slot, free running
+} usb_report_queue_t;
+
+// Orders the slot accesses against the index updates, as seen from an interrupt on the same core
+#define USB_REPORT_QUEUE_BARRIER() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+static inline void usb_report_queue_init(usb_report_queue_t *queue, uint8_t *slots, uint8_t *sizes, uint8_t slot_size, uint8_t depth) {
+    queue->slots     = slots;
+    queue->sizes     = sizes;
+    queue->slot_size = slot_size;
+    queue->depth     = depth;
+    queue->head      = 0;
+    queue->tail      = 0;
+}
+
+static inline uint8_t usb_report_queue_count(const usb_report_queue_t *queue) {
+    return (uint8_t)(queue->head - queue->tail);
+}
+
+static inline bool usb_report_queue_is_empty(const usb_report_queue_t *queue) {
+    return queue->head == queue->tail;
+}
+
+static inline bool usb_report_queue_is_full(const usb_report_queue_t *queue) {
+    return usb_report_queue_count(queue) >= queue->depth;
+}
+
+static inline uint8_t *usb_report_queue_slot(const usb_report_queue_t *queue, uint8_t index) {
+    return &queue->slots[(index & (queue->depth - 1)) * queue->slot_size];
+}
+
+/*
+ * Producer: copies a report into the queue, returns false if the queue is full or the report too large.
+ */
+static inline bool usb_report_queue_push(usb_report_queue_t *queue, const void *report, uint8_t size) {
+    uint8_t head = queue->head;
+    if (size > queue->slot_size || (uint8_t)(head - queue->tail) >= queue->depth) {
+        return false;
+    }
+    memcpy(usb_report_queue_slot(queue, head), report, size);
+    queue->sizes[head & (queue->depth - 1)] = size;
+    USB_REPORT_QUEUE_BARRIER();
+    queue->head = head + 1;
+    return true;
+}
+
+/*
+ * Consumer: the oldest report, or NULL if the queue is empty. It stays queued until popped.
+ */
+static inline uint8_t *usb_report_queue_peek(const usb_report_queue_t *queue, uint8_t *size) {
+    uint8_t tail = queue->tail;
+    if (queue->head == tail) {
+        return NULL;
+    }
+    USB_REPORT_QUEUE_BARRIER();
+    *size = queue->sizes[tail & (queue->depth - 1)];
+    return usb_report_queue_slot(queue, tail);
+}
+
+/*
+ * Consumer: releases the oldest report's slot.
+ */
+static inline void usb_report_queue_pop(usb_report_queue_t *queue) {
+    if (queue->head != queue->tail) {
+        USB_REPORT_QUEUE_BARRIER();
+        queue->tail = queue->tail + 1;
+    }
+}
+
+/*
+ * Consumer: drops every queued report, e.g. when the host resets the endpoint.
+ */
+static inline void usb_report_queue_flush(usb_report_queue_t *queue) {
+    USB_REPORT_QUEUE_BARRIER();
+    queue->tail = queue->head;
+}
@@ -312,15 +312,28 @@ void send_programmable_button(report_programmable_button_t *report) {
  *------------------------------------------------------------------*/
 static struct {
     uint16_t len;
-    enum { NONE, SET_LED } kind;
+    enum { NONE, SET_LED, SET_MOUSE_RESOLUTION } kind;
 } last_req;
 
+#if defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE) && defined(MOUSE_SHARED_EP)
+static report_mouse_resolution_t mouse_resolution_report;
+#endif
+
 usbMsgLen_t usbFunctionSetup(uchar data[8]) {
     usbRequest_t *rq = (void *)data;
 
     if ((rq->bmRequestType & USBRQ_TYPE_MASK) == USBRQ_TYPE_CLASS) { /* class request type */
         if (rq->bRequest == USBRQ_HID_GET_REPORT) {
             dprint("GET_REPORT:");
+#if defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE) && defined(MOUSE_SHARED_EP)
+            // Report Type: 0x03(Feature)/ReportID: mouse && Interface: shared
+            if (rq->wValue.word == (0x0300 | REPORT_ID_MOUSE) && rq->wIndex.word == SHARED_INTERFACE) {
+                mouse_resolution_report.report_id  = REPORT_ID_MOUSE;
+                mouse_resolution_report.multiplier = host_mouse_resolution_multiplier();
+                usbMsgPtr                          = (usbMsgPtr_t)&mouse_resolution_report;
+                return sizeof(mouse_resolution_report);
+            }
+#endif
             if (rq->wIndex.word == KEYBOARD_INTERFACE) {
                 usbMsgPtr = (usbMsgPtr_t)&keyboard_report_sent;
                 return sizeof(keyboard_report_sent);
@@ -340,6 +353,14 @@ usbMsgLen_t usbFunctionSetup(uchar data[8]) {
                 last_req.kind = SET_LED;
                 last_req.len  = rq->wLength.word;
             }
+#if defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE) && defined(MOUSE_SHARED_EP)
+            // Report Type: 0x03(Feature)/ReportID: mouse && Interface: shared
+            if (rq->wValue.word == (0x0300 | REPORT_ID_MOUSE) && rq->wIndex.word == SHARED_INTERFACE) {
+                dprint("SET_MOUSE_RESOLUTION:");
+                last_req.kind = SET_MOUSE_RESOLUTION;
+                last_req.len  = rq->wLength.word;
+            }
+#endif
             return USB_NO_MSG; // to get data in usbFunctionWrite
         } else {
             dprint("UNKNOWN:");
@@ -363,6 +384,16 @@ uchar usbFunctionWrite(uchar *data, uchar len) {
             last_req.len       = 0;
             return 1;
             break;
+#if defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE) && defined(MOUSE_SHARED_EP)
+        case SET_MOUSE_RESOLUTION:
+            dprintf("SET_MOUSE_RESOLUTION: %02X\n", data[1]);
+            if (len == sizeof(report_mouse_resolution_t)) {
+                host_mouse_set_resolution_multiplier(data[1] & 0x0F);
+            }
+            last_req.len = 0;
+            return 1;
+            break;
+#endif
         case NONE:
         default:
             return -1;
@@ -496,6 +527,7 @@ const PROGMEM uchar shared_hid_report[] = {
 #    endif
     0x81, 0x06, //     Input (Data, Variable, Relative)
 
+#    ifndef POINTING_DEVICE_HIRES_SCROLL_ENABLE
     // Vertical wheel (1 byte)
     0x09, 0x38, //     Usage (Wheel)
     0x15, 0x81, //     Logical Minimum (-127)
@@ -511,6 +543,33 @@ const PROGMEM uchar shared_hid_report[] = {
     0x95, 0x01,       //     Report Count (1)
     0x75, 0x08,       //     Report Size (8)
     0x81, 0x06,       //     Input (Data, Variable, Relative)
+#    else
+    // Vertical and horizontal wheels (2 bytes), with a Resolution Multiplier feature for both (4 bits)
+    0xA1, 0x02,                                          //     Collection (Logical)
+    0x09, 0x48,                                          //       Usage (Resolution Multiplier)
+    0x15, 0x00,                                          //       Logical Minimum (0)
+    0x25, 0x01,                                          //       Logical Maximum (1)
+    0x35, 0x01,                                          //       Physical Minimum (1)
+    0x46, POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER, 0x00, //       Physical Maximum (multiplier)
+    0x95, 0x01,                                          //       Report Count (1)
+    0x75, 0x04,                                          //       Report Size (4)
+    0xB1, 0x02,                                          //       Feature (Data, Variable, Absolute)
+    // Feature padding (4 bits)
+    0x75, 0x04,                                          //       Report Size (4)
+    0xB1, 0x01,                                          //       Feature (Constant)
+    0x35, 0x00,                                          //       Physical Minimum (0)
+    0x45, 0x00,                                          //       Physical Maximum (0)
+    0x09, 0x38,                                          //       Usage (Wheel)
+    0x15, 0x81,                                          //       Logical Minimum (-127)
+    0x25, 0x7F,                                          //       Logical Maximum (127)
+    0x95, 0x01,                                          //       Report Count (1)
+    0x75, 0x08,                                          //       Report Size (8)
+    0x81, 0x06,                                          //       Input (Data, Variable, Relative)
+    0x05, 0x0C,                                          //       Usage Page (Consumer)
+    0x0A, 0x38, 0x02,                                    //       Usage (AC Pan)
+    0x81, 0x06,                                          //       Input (Data, Variable, Relative)
+    0xC0,                                                //     End Collection
+#    endif
     0xC0,             //   End Collection
     0xC0,             // End Collection
 #endif